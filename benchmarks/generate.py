@@ -0,0 +1,316 @@
+"""Synthetic workload generator for compiler throughput benchmarks.
+
+Each workload is a directory containing main.pang (and any modules it
+imports). Imports resolve relative to the working directory, so the
+harness compiles every workload from inside its own directory.
+
+Usage: python benchmarks/generate.py [--out DIR] [--scale N]
+"""
+
+import os
+import sys
+
+# Workload name -> (generator, base size); sizes are multiplied by --scale
+WORKLOADS = {}
+
+
+def workload(name, base_size):
+    def register(fn):
+        WORKLOADS[name] = (fn, base_size)
+        return fn
+    return register
+
+
+def write(path, lines):
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    with open(path, "w", newline="\n") as f:
+        f.write("\n".join(lines) + "\n")
+
+
+def main_function(calls):
+    lines = ["fn main() -> i32 {", "    let mut total = 0"]
+    for call in calls:
+        lines.append(f"    total = total + {call}")
+    lines += ["    return total % 256", "}"]
+    return lines
+
+
+@workload("functions", 500)
+def gen_functions(out_dir, count):
+    """Many small functions with a few locals and a branch each."""
+    lines = []
+    for i in range(count):
+        lines += [
+            f"fn func_{i}(a: i32, b: i32) -> i32 {{",
+            f"    let x = a * {i % 17 + 1} + b",
+            f"    let mut y = x - {i % 5}",
+            f"    if y > {i % 100} {{",
+            "        y = y - a",
+            "    } else {",
+            "        y = y + b",
+            "    }",
+            "    return y",
+            "}",
+            "",
+        ]
+    lines += main_function([f"func_{i}({i}, {i + 1})" for i in range(0, count, max(1, count // 50))])
+    write(os.path.join(out_dir, "main.pang"), lines)
+
+
+@workload("nested_expressions", 40)
+def gen_nested_expressions(out_dir, depth):
+    """Deeply nested arithmetic expressions (parser recursion and type propagation)."""
+    lines = []
+    operators = ["+", "-", "*", "/"]
+    for f in range(20):
+        expr = "a"
+        for level in range(depth):
+            op = operators[(level + f) % len(operators)]
+            rhs = f"(b + {level + 1})" if op == "/" else str(level + 1)
+            expr = f"({expr} {op} {rhs})"
+        lines += [
+            f"fn nested_{f}(a: i32, b: i32) -> i32 {{",
+            f"    return {expr}",
+            "}",
+            "",
+        ]
+    lines += main_function([f"nested_{f}({f}, 1)" for f in range(20)])
+    write(os.path.join(out_dir, "main.pang"), lines)
+
+
+@workload("long_while", 2000)
+def gen_long_while(out_dir, statements):
+    """A single function whose while body has thousands of statements."""
+    lines = [
+        "fn run(n: i32) -> i32 {",
+        "    let mut i = 0",
+        "    let mut acc = 0",
+        "    let mut tmp = 0",
+        "    while i < n {",
+    ]
+    for s in range(statements):
+        if s % 3 == 0:
+            lines.append(f"        tmp = acc + i * {s % 13 + 1}")
+        elif s % 3 == 1:
+            lines.append(f"        acc = tmp - {s % 7}")
+        else:
+            lines += [
+                f"        if acc > {s * 10} {{",
+                "            acc = acc / 2",
+                "        }",
+            ]
+    lines += [
+        "        i++",
+        "    }",
+        "    return acc",
+        "}",
+        "",
+    ]
+    lines += main_function(["run(10)"])
+    write(os.path.join(out_dir, "main.pang"), lines)
+
+
+@workload("loop_locals", 10000000)
+def gen_loop_locals(out_dir, iterations):
+    """A hot loop declaring locals in its body (checks locals are not allocated per iteration)."""
+    lines = [
+        "fn spin(n: i32) -> i32 {",
+        "    let mut i = 0",
+        "    let mut acc = 0",
+        "    while i < n {",
+        "        let x = i * 3",
+        "        let mut y = x % 7",
+        "        if y > 3 {",
+        "            let z = y - 3",
+        "            y = z",
+        "        }",
+        "        acc = (acc + y) % 1000",
+        "        i++",
+        "    }",
+        "    return acc",
+        "}",
+        "",
+    ]
+    lines += main_function([f"spin({iterations})"])
+    write(os.path.join(out_dir, "main.pang"), lines)
+
+
+@workload("vectorize_for", 20000)
+def gen_vectorize_for(out_dir, passes):
+    """Counted for loops over restrict buffers (run time shows whether the kernels vectorize)."""
+    lines = [
+        "foreign fn malloc(size: i64) -> cptr<u8>",
+        "",
+        "fn fill(n: i32, x: restrict cptr<i32>, y: restrict cptr<i32>) -> void {",
+        "    for i in 0..n {",
+        "        x[i] = i % 7",
+        "        y[i] = i % 5",
+        "    }",
+        "}",
+        "",
+        "fn axpy(n: i32, a: i32, x: restrict cptr<i32>, y: restrict cptr<i32>) -> void {",
+        "    for i in 0..n {",
+        "        y[i] += a * x[i]",
+        "    }",
+        "}",
+        "",
+        "fn dot(n: i32, x: restrict cptr<i32>, y: restrict cptr<i32>) -> i32 {",
+        "    let mut sum = 0",
+        "    for i in 0..n {",
+        "        sum += x[i] * y[i]",
+        "    }",
+        "    return sum",
+        "}",
+        "",
+        "fn run(passes: i32) -> i32 {",
+        "    let n = 4096",
+        "    let x: cptr<i32> = cast<cptr<i32>>(malloc(cast<i64>(n) * 4i64))",
+        "    let y: cptr<i32> = cast<cptr<i32>>(malloc(cast<i64>(n) * 4i64))",
+        "    fill(n, x, y)",
+        "    let mut total = 0",
+        "    for pass in 0..passes {",
+        "        axpy(n, pass % 3 - 1, x, y)",
+        "        total = (total + dot(n, x, y)) % 1000",
+        "    }",
+        "    return total",
+        "}",
+        "",
+    ]
+    lines += main_function([f"run({passes})"])
+    write(os.path.join(out_dir, "main.pang"), lines)
+
+
+@workload("fixed_arrays", 20000)
+def gen_fixed_arrays(out_dir, passes):
+    """Global [T; N] arrays: loops bounded by N need no bounds checks, the histogram's lookups do."""
+    lines = [
+        "let mut xs: [i32; 4096]",
+        "let mut ys: [i32; 4096]",
+        "let mut counts: [i32; 16]",
+        "",
+        "fn fill() -> void {",
+        "    for i in 0..4096 {",
+        "        xs[i] = i % 7",
+        "        ys[i] = i % 5",
+        "    }",
+        "}",
+        "",
+        "fn axpy(a: i32) -> void {",
+        "    for i in 0..4096 {",
+        "        ys[i] += a * xs[i]",
+        "    }",
+        "}",
+        "",
+        "fn histogram() -> i32 {",
+        "    for i in 0..4096 {",
+        "        counts[(ys[i] % 16 + 16) % 16] += 1",
+        "    }",
+        "    return counts[3]",
+        "}",
+        "",
+        "fn run(passes: i32) -> i32 {",
+        "    fill()",
+        "    let mut total = 0",
+        "    for pass in 0..passes {",
+        "        axpy(pass % 3 - 1)",
+        "        total = (total + histogram()) % 1000",
+        "    }",
+        "    return total",
+        "}",
+        "",
+    ]
+    lines += main_function([f"run({passes})"])
+    write(os.path.join(out_dir, "main.pang"), lines)
+
+
+@workload("many_imports", 100)
+def gen_many_imports(out_dir, modules):
+    """Many small modules, each exporting a few functions, all imported by main."""
+    main_lines = []
+    calls = []
+    for m in range(modules):
+        module_lines = []
+        for f in range(5):
+            module_lines += [
+                f"export fn mod{m}_fn{f}(x: i32) -> i32 {{",
+                f"    return x + {m * 5 + f}",
+                "}",
+                "",
+            ]
+        write(os.path.join(out_dir, "lib", f"mod{m}.pang"), module_lines)
+        main_lines.append(f'import "lib/mod{m}"')
+        calls.append(f"mod{m}_fn{m % 5}({m})")
+    main_lines.append("")
+    main_lines += main_function(calls)
+    write(os.path.join(out_dir, "main.pang"), main_lines)
+
+
+@workload("foreign_headers", 2000)
+def gen_foreign_headers(out_dir, declarations):
+    """Large FFI headers in the style of stdlib/windows/api: types, structs, constants, foreign fns."""
+    header = [
+        "// Generated foreign header",
+        "export type HANDLE = cptr<void>",
+        "export type DWORD = u32",
+        "export type LPCWSTR = cptr<const u16>",
+        "",
+    ]
+    for d in range(declarations):
+        kind = d % 4
+        if kind == 0:
+            header.append(f"export let CONSTANT_{d}: const i32 = {d}")
+        elif kind == 1:
+            header += [
+                f"export foreign struct STRUCT_{d} {{",
+                "    cbSize: DWORD",
+                "    hHandle: HANDLE",
+                "    lpName: LPCWSTR",
+                "}",
+            ]
+        else:
+            header.append(
+                f"export foreign fn ApiFunction{d}(hHandle: HANDLE, dwFlags: DWORD, lpName: LPCWSTR, "
+                f"lpReserved: cptr<void>) -> DWORD")
+    write(os.path.join(out_dir, "headers", "api.pang"), header)
+
+    # Only the header is under test; main just has to import it
+    main_lines = ['import "headers/api"', ""]
+    main_lines += main_function([])
+    write(os.path.join(out_dir, "main.pang"), main_lines)
+
+
+def generate_all(out_dir, scale):
+    """Generate every workload; returns {name: directory}."""
+    generated = {}
+    for name, (generator, base_size) in WORKLOADS.items():
+        workload_dir = os.path.join(out_dir, name)
+        generator(workload_dir, max(1, int(base_size * scale)))
+        generated[name] = workload_dir
+    return generated
+
+
+def main():
+    out_dir = os.path.join(os.path.dirname(os.path.abspath(__file__)), "workloads")
+    scale = 1.0
+
+    args = sys.argv[1:]
+    i = 0
+    while i < len(args):
+        if args[i] == "--out" and i + 1 < len(args):
+            out_dir = args[i + 1]
+            i += 1
+        elif args[i] == "--scale" and i + 1 < len(args):
+            scale = float(args[i + 1])
+            i += 1
+        else:
+            print(__doc__)
+            return 1
+        i += 1
+
+    for name, path in generate_all(out_dir, scale).items():
+        print(f"[INFO] Generated {name}: {path}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,287 @@
+"""Compiler throughput benchmark harness.
+
+Generates the synthetic workloads (see generate.py), compiles each one with
+--time-report --stats, and writes the per-phase results as JSON so they can
+be compared across commits.
+
+Usage: python benchmarks/run_benchmarks.py [options]
+  --compiler PATH   pangea executable (default: build/pangea.exe or build/pangea)
+  --scale N         Workload size multiplier (default: 1.0)
+  --repeat N        Runs per workload; the median run is reported (default: 3)
+  --opt-level N     Optimization level passed to the compiler as -O<N> (default: 0)
+  --object          Also emit an object file and link (default: stop at LLVM IR)
+  --run             Also run each linked program (implies --object); a crash fails the workload
+  --output FILE     Results file (default: benchmarks/results/<commit>.json)
+  --compare FILE    Print the change against an earlier results file
+"""
+
+import datetime
+import json
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import time
+
+import generate
+
+BENCH_DIR = os.path.dirname(os.path.abspath(__file__))
+REPO_DIR = os.path.dirname(BENCH_DIR)
+
+TIME_ROW = re.compile(r"^(.+?)\s+([\d.]+)\s+([\d.]+)\s+([\d.]+)\s+(\d+)$")
+MEMORY_ROW = re.compile(r"^(.+?)\s+(\d+)\s+(\d+)\s+(\d+)$")
+STAT_ROW = re.compile(r"^  (.+?)\s+(\d+)$")
+
+
+def parse_report(output):
+    """Parse the --time-report and --stats tables from compiler stdout."""
+    phases = {}
+    counters = {}
+    peak_rss_kb = 0
+    section = None
+    group = None
+
+    for line in output.splitlines():
+        if line.startswith("====="):
+            section = line.strip("= ").strip()
+            continue
+
+        if section == "Pangea time report":
+            match = TIME_ROW.match(line)
+            if match and match.group(1).strip() != "Total":
+                phases.setdefault(match.group(1).strip(), {}).update({
+                    "wall_ms": float(match.group(2)),
+                    "cpu_ms": float(match.group(4)),
+                    "count": int(match.group(5)),
+                })
+        elif section == "Pangea statistics":
+            if line and not line.startswith(" ") and line.endswith(":"):
+                group = line[:-1]
+                continue
+            match = STAT_ROW.match(line)
+            if match and group:
+                counters[f"{group}.{match.group(1).strip()}"] = int(match.group(2))
+        elif section == "Pangea memory report":
+            match = MEMORY_ROW.match(line)
+            if match:
+                name = match.group(1).strip()
+                if name == "Total":
+                    peak_rss_kb = int(match.group(4))
+                else:
+                    phases.setdefault(name, {}).update({
+                        "allocations": int(match.group(2)),
+                        "allocated_kb": int(match.group(3)),
+                        "peak_rss_kb": int(match.group(4)),
+                    })
+
+    return phases, counters, peak_rss_kb
+
+
+def count_lines(workload_dir):
+    total = 0
+    for root, _, files in os.walk(workload_dir):
+        for name in files:
+            if name.endswith(".pang"):
+                with open(os.path.join(root, name)) as f:
+                    total += sum(1 for _ in f)
+    return total
+
+
+def run_workload(compiler, workload_dir, opt_level, emit_object, scratch_dir):
+    output_file = os.path.join(scratch_dir, os.path.basename(workload_dir))
+    command = [compiler, "main.pang", "-o", output_file, f"-O{opt_level}", "--time-report", "--stats"]
+    if not emit_object:
+        command.append("--llvm")
+
+    result = subprocess.run(command, cwd=workload_dir, stdout=subprocess.PIPE, stderr=subprocess.PIPE, text=True)
+    phases, counters, peak_rss_kb = parse_report(result.stdout)
+    return result.returncode, phases, counters, peak_rss_kb, result.stderr
+
+
+def crashed(exit_code):
+    """Programs return their result as the exit code, so only signals and NTSTATUS errors count as failure."""
+    return exit_code < 0 or exit_code >= 0xC0000000
+
+
+def run_program(workload_dir, scratch_dir):
+    """Run the program the last compile of a workload linked; returns (exit code, wall ms)."""
+    program = os.path.join(scratch_dir, os.path.basename(workload_dir))
+    if not os.path.exists(program) and os.path.exists(program + ".exe"):
+        program += ".exe"
+
+    start = time.perf_counter()
+    result = subprocess.run([program], cwd=workload_dir, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    return result.returncode, (time.perf_counter() - start) * 1000.0
+
+
+def per_second(amount, milliseconds):
+    return round(amount / (milliseconds / 1000.0), 1) if milliseconds > 0 else None
+
+
+def benchmark(compiler, workloads, repeat, opt_level, emit_object, run_programs):
+    results = {}
+    with tempfile.TemporaryDirectory() as scratch_dir:
+        for name, workload_dir in workloads.items():
+            runs = []
+            for _ in range(repeat):
+                exit_code, phases, counters, peak_rss_kb, stderr = run_workload(
+                    compiler, workload_dir, opt_level, emit_object, scratch_dir)
+                if exit_code != 0 or not phases:
+                    print(f"[ERROR] {name} failed to compile:")
+                    print(stderr)
+                    break
+                total_ms = sum(phase.get("wall_ms", 0.0) for phase in phases.values())
+                runs.append((total_ms, phases, counters, peak_rss_kb))
+
+            if len(runs) != repeat:
+                results[name] = {"error": "compilation failed"}
+                continue
+
+            # Report the median run as a whole so phases stay consistent with each other
+            runs.sort(key=lambda run: run[0])
+            total_ms, phases, counters, peak_rss_kb = runs[len(runs) // 2]
+
+            program_run = None
+            if run_programs:
+                exit_code, run_ms = run_program(workload_dir, scratch_dir)
+                if crashed(exit_code):
+                    print(f"[ERROR] {name} crashed at runtime (exit code {exit_code:#x})")
+                    results[name] = {"error": "program crashed", "exit_code": exit_code}
+                    continue
+                program_run = {"exit_code": exit_code, "wall_ms": round(run_ms, 3)}
+
+            lines = count_lines(workload_dir)
+            tokens = counters.get("lexer.tokens", 0)
+            functions = counters.get("ast.FunctionDeclaration", 0)
+
+            def phase_ms(phase):
+                return phases.get(phase, {}).get("wall_ms", 0.0)
+
+            results[name] = {
+                "lines": lines,
+                "tokens": tokens,
+                "functions": functions,
+                "ast_nodes": counters.get("ast.total nodes", 0),
+                "total_wall_ms": round(total_ms, 3),
+                "all_runs_wall_ms": [round(run[0], 3) for run in runs],
+                "peak_rss_kb": peak_rss_kb,
+                "throughput": {
+                    "lines_per_sec": per_second(lines, total_ms),
+                    "tokens_per_sec_lex": per_second(tokens, phase_ms("lex")),
+                    "tokens_per_sec_parse": per_second(tokens, phase_ms("parse")),
+                    "functions_per_sec_type_check": per_second(functions, phase_ms("type check")),
+                    "functions_per_sec_codegen": per_second(functions, phase_ms("codegen")),
+                },
+                "phases": phases,
+                "counters": counters,
+            }
+            if program_run:
+                results[name]["run"] = program_run
+
+            print(f"[INFO] {name:20} {total_ms:10.2f} ms  {lines:7} lines  "
+                  f"{results[name]['throughput']['lines_per_sec'] or 0:12.0f} lines/s  "
+                  f"peak {peak_rss_kb / 1024:.1f} MB")
+
+    return results
+
+
+def git_commit():
+    try:
+        return subprocess.run(["git", "rev-parse", "--short", "HEAD"], cwd=REPO_DIR,
+                              stdout=subprocess.PIPE, stderr=subprocess.DEVNULL, text=True).stdout.strip() or "unknown"
+    except OSError:
+        return "unknown"
+
+
+def compare(results, baseline_file):
+    with open(baseline_file) as f:
+        baseline = json.load(f)
+
+    print(f"[INFO] Compared to {baseline.get('commit', baseline_file)}:")
+    for name, current in results["workloads"].items():
+        previous = baseline.get("workloads", {}).get(name)
+        if not previous or "total_wall_ms" not in previous or "total_wall_ms" not in current:
+            continue
+        change = 100.0 * (current["total_wall_ms"] - previous["total_wall_ms"]) / previous["total_wall_ms"]
+        print(f"  {name:20} {previous['total_wall_ms']:10.2f} -> {current['total_wall_ms']:10.2f} ms ({change:+.1f}%)")
+
+
+def default_compiler():
+    for candidate in ("pangea.exe", "pangea"):
+        path = os.path.join(REPO_DIR, "build", candidate)
+        if os.path.exists(path):
+            return path
+    return os.path.join(REPO_DIR, "build", "pangea.exe")
+
+
+def main():
+    compiler = default_compiler()
+    scale = 1.0
+    repeat = 3
+    opt_level = 0
+    emit_object = False
+    run_programs = False
+    output_file = None
+    baseline_file = None
+
+    args = sys.argv[1:]
+    i = 0
+    while i < len(args):
+        arg = args[i]
+        value = args[i + 1] if i + 1 < len(args) else None
+        if arg == "--compiler" and value:
+            compiler, i = os.path.abspath(value), i + 1
+        elif arg == "--scale" and value:
+            scale, i = float(value), i + 1
+        elif arg == "--repeat" and value:
+            repeat, i = max(1, int(value)), i + 1
+        elif arg == "--opt-level" and value in ("0", "1", "2", "3"):
+            opt_level, i = int(value), i + 1
+        elif arg == "--output" and value:
+            output_file, i = value, i + 1
+        elif arg == "--compare" and value:
+            baseline_file, i = value, i + 1
+        elif arg == "--object":
+            emit_object = True
+        elif arg == "--run":
+            emit_object = run_programs = True
+        else:
+            print(__doc__)
+            return 1
+        i += 1
+
+    if not os.path.exists(compiler):
+        print(f"[ERROR] Compiler not found: {compiler} (build it first or pass --compiler)")
+        return 1
+
+    workloads = generate.generate_all(os.path.join(BENCH_DIR, "workloads"), scale)
+
+    results = {
+        "commit": git_commit(),
+        "timestamp": datetime.datetime.now(datetime.timezone.utc).isoformat(),
+        "compiler": compiler,
+        "scale": scale,
+        "repeat": repeat,
+        "opt_level": opt_level,
+        "emit_object": emit_object,
+        "run": run_programs,
+        "workloads": benchmark(compiler, workloads, repeat, opt_level, emit_object, run_programs),
+    }
+
+    if output_file is None:
+        output_file = os.path.join(BENCH_DIR, "results", f"{results['commit']}.json")
+    os.makedirs(os.path.dirname(os.path.abspath(output_file)), exist_ok=True)
+    with open(output_file, "w") as f:
+        json.dump(results, f, indent=2)
+    print(f"[SUCCESS] Results written to {output_file}")
+
+    if baseline_file:
+        compare(results, baseline_file)
+
+    failed = [name for name, workload in results["workloads"].items() if "error" in workload]
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
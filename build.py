@@ -8,6 +8,8 @@ def main():
     memory_check = "OFF"
     clean_build = False
     run_tests = False
+    build_library = False
+    run_benchmarks = False
 
     if len(sys.argv) > 1:
         for arg in sys.argv[1:]:
@@ -19,6 +21,10 @@ def main():
                 clean_build = True
             elif arg == "--test":
                 run_tests = True
+            elif arg == "--lib":
+                build_library = True
+            elif arg == "--bench":
+                run_benchmarks = True
             elif arg == "--help":
                 print("Pangea Compiler Build Script (Python)")
                 print()
@@ -29,6 +35,8 @@ def main():
                 print("  --memory-check  Enable memory safety checking")
                 print("  --clean         Clean build directory before building")
                 print("  --test          Run tests after building")
+                print("  --lib           Also build libpangea.a for embedding (see src/api/pangea.h)")
+                print("  --bench         Run the compiler throughput benchmarks after building")
                 print("  --help          Show this help message")
                 return
             else:
@@ -85,24 +93,41 @@ def main():
         "-lshell32",
         "-ladvapi32",
         "-luuid",
-        "-ldbghelp"
+        "-ldbghelp",
+        "-lpsapi"
     ]
     
-    # Source files
-    sources = [
-        "../src/main.cpp",
+    # Source files (everything except main.cpp also goes into libpangea)
+    library_sources = [
+        "../src/api/pangea.cpp",
+        "../src/driver/driver.cpp",
+        "../src/driver/module_manager.cpp",
+        "../src/server/compile_server.cpp",
         "../src/lexer/lexer.cpp",
         "../src/lexer/token.cpp",
         "../src/parser/parser.cpp",
         "../src/ast/ast_nodes.cpp",
         "../src/ast/ast_printer.cpp",
+        "../src/ast/ast_statistics.cpp",
+        "../src/semantic/constant_evaluator.cpp",
+        "../src/semantic/const_interpreter.cpp",
+        "../src/semantic/module_graph.cpp",
+        "../src/semantic/name_resolver.cpp",
         "../src/semantic/type_checker.cpp",
+        "../src/semantic/type_context.cpp",
         "../src/codegen/llvm_codegen.cpp",
         "../src/codegen/compile.cpp",
+        "../src/codegen/function_attributes.cpp",
+        "../src/codegen/loop_remarks.cpp",
         "../src/utils/source_location.cpp",
         "../src/utils/unicode/unicode_escape.cpp",
-        "../src/utils/error_reporter.cpp"
+        "../src/utils/error_reporter.cpp",
+        "../src/utils/timer.cpp",
+        "../src/utils/stats.cpp",
+        "../src/utils/thread_pool.cpp"
     ]
+    # The allocation hook replaces global operator new, so it stays out of libpangea
+    sources = ["../src/main.cpp", "../src/utils/alloc_hook.cpp"] + library_sources
 
     # Compile command
     compile_cmd = ["g++"] + compile_flags + [f"-I{llvm_include}"] + sources + other_libs + llvm_libs + ["-o", "pangea.exe"]
@@ -118,6 +143,35 @@ def main():
     else:
         print("[SUCCESS] Build completed successfully!")
 
+    # Build the embeddable static library if requested
+    if build_library:
+        print("[INFO] Building libpangea.a...")
+        objects = []
+        for source in library_sources:
+            obj = os.path.splitext(source.replace("../src/", "").replace("/", "_"))[0] + ".o"
+            result = subprocess.run(["g++", "-c"] + compile_flags + [f"-I{llvm_include}", source, "-o", obj],
+                                    stdout=subprocess.PIPE, stderr=subprocess.PIPE, text=True)
+            if result.returncode != 0:
+                print(f"[ERROR] Failed to compile {source}")
+                print(result.stderr)
+                sys.exit(1)
+            objects.append(obj)
+
+        result = subprocess.run(["ar", "rcs", "libpangea.a"] + objects, stdout=subprocess.PIPE, stderr=subprocess.PIPE, text=True)
+        if result.returncode != 0:
+            print("[ERROR] Failed to archive libpangea.a")
+            print(result.stderr)
+            sys.exit(1)
+        print("[SUCCESS] Built libpangea.a (link with the same LLVM and system libraries as pangea.exe)")
+
+    # Run benchmarks if requested (results go to benchmarks/results/<commit>.json)
+    if run_benchmarks:
+        print("[INFO] Running compiler benchmarks...")
+        bench_cmd = [sys.executable, "../benchmarks/run_benchmarks.py", "--compiler", "pangea.exe"]
+        if subprocess.run(bench_cmd).returncode != 0:
+            print("[ERROR] Benchmarks failed!")
+            sys.exit(1)
+
     # Run tests if requested
     if run_tests:
         print("[ERROR] Tests not implemented yet")
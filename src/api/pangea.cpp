@@ -0,0 +1,133 @@
+#include "pangea.h"
+#include "../driver/module_manager.h"
+#include "../semantic/constant_evaluator.h"
+#include "../semantic/name_resolver.h"
+#include "../semantic/type_checker.h"
+#include "../codegen/llvm_codegen.h"
+#include "../codegen/compile.h"
+#include <llvm/ExecutionEngine/ExecutionEngine.h>
+#include <llvm/ExecutionEngine/MCJIT.h>
+
+namespace pangea {
+
+// JITModule implementation
+JITModule::JITModule(std::unique_ptr<llvm::LLVMContext> context, std::unique_ptr<llvm::ExecutionEngine> engine)
+    : context(std::move(context)), engine(std::move(engine)) {
+}
+
+JITModule::~JITModule() {
+    // The engine owns the module, which must die before its context
+    engine.reset();
+    context.reset();
+}
+
+void* JITModule::getFunctionAddress(const std::string& name) const {
+    return reinterpret_cast<void*>(engine->getFunctionAddress(name));
+}
+
+// EmbeddedCompiler implementation
+EmbeddedCompiler::EmbeddedCompiler() : module_cache(std::make_unique<ModuleCache>()) {
+}
+
+EmbeddedCompiler::~EmbeddedCompiler() = default;
+
+std::unique_ptr<LLVMCodeGenerator> EmbeddedCompiler::generate(const std::string& source, const SourceCompileOptions& options,
+                                                              ErrorReporter& error_reporter) {
+    ModuleManager module_manager(&error_reporter, false, module_cache.get());
+
+    auto program = module_manager.createProgramFromSource(source, options.module_name + ".pang",
+                                                          options.auto_import_stdlib, options.auto_import_builtins);
+    if (!program || error_reporter.hasErrors()) {
+        return nullptr;
+    }
+
+    NameResolver name_resolver;
+    name_resolver.resolve(*program);
+
+    TypeChecker type_checker(&error_reporter, options.auto_import_builtins);
+    type_checker.analyze(*program, name_resolver.getDeclarations());
+    if (error_reporter.hasErrors()) {
+        return nullptr;
+    }
+
+    ConstantEvaluator constant_evaluator(&error_reporter);
+    constant_evaluator.evaluate(*program, name_resolver.getDeclarations());
+
+    auto codegen = std::make_unique<LLVMCodeGenerator>(&error_reporter, false, options.auto_import_builtins,
+                                                       boundsChecksEnabled(options.bounds_checks, options.opt_level));
+    try {
+        codegen->generateCode(*program, &name_resolver.getDeclarations());
+    } catch (const std::exception& e) {
+        error_reporter.reportError(SourceLocation(), std::string("Code generation failed: ") + e.what());
+        return nullptr;
+    }
+
+    if (!codegen->verify() || error_reporter.hasErrors()) {
+        return nullptr;
+    }
+
+    std::string target_error;
+    codegen->optimize(options.opt_level, Compiler::getHostTargetMachine(target_error));
+
+    return codegen;
+}
+
+CompileResult EmbeddedCompiler::compileToObject(const std::string& source, std::vector<char>& object,
+                                                const SourceCompileOptions& options) {
+    ErrorReporter error_reporter("never");
+    CompileResult result;
+
+    if (auto codegen = generate(source, options, error_reporter)) {
+        Compiler compiler(codegen.get(), false, &error_reporter);
+        result.success = compiler.compileToObjectBuffer(object);
+    }
+
+    result.diagnostics = error_reporter.getDiagnostics();
+    return result;
+}
+
+CompileResult EmbeddedCompiler::compileToSharedLibrary(const std::string& source, const std::string& output_file,
+                                                       const SourceCompileOptions& options) {
+    ErrorReporter error_reporter("never");
+    CompileResult result;
+
+    if (auto codegen = generate(source, options, error_reporter)) {
+        Compiler compiler(codegen.get(), false, &error_reporter);
+        result.success = compiler.compileToSharedLibrary(output_file);
+    }
+
+    result.diagnostics = error_reporter.getDiagnostics();
+    return result;
+}
+
+CompileResult EmbeddedCompiler::compileToJIT(const std::string& source, std::unique_ptr<JITModule>& jit,
+                                             const SourceCompileOptions& options) {
+    ErrorReporter error_reporter("never");
+    CompileResult result;
+
+    if (auto codegen = generate(source, options, error_reporter)) {
+        Compiler::initializeTargets();
+
+        // The engine takes the module; the context has to outlive it
+        std::unique_ptr<llvm::LLVMContext> context = codegen->takeContext();
+        std::string error;
+        std::unique_ptr<llvm::ExecutionEngine> engine(
+            llvm::EngineBuilder(codegen->takeModule())
+                .setErrorStr(&error)
+                .setEngineKind(llvm::EngineKind::JIT)
+                .create());
+
+        if (!engine) {
+            error_reporter.reportError(SourceLocation(), "Failed to create JIT: " + error);
+        } else {
+            engine->finalizeObject();
+            jit = std::make_unique<JITModule>(std::move(context), std::move(engine));
+            result.success = true;
+        }
+    }
+
+    result.diagnostics = error_reporter.getDiagnostics();
+    return result;
+}
+
+} // namespace pangea
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "../codegen/bounds_checks.h"
+#include "../utils/error_reporter.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace llvm {
+    class ExecutionEngine;
+    class LLVMContext;
+}
+
+namespace pangea {
+
+class ModuleCache;
+class LLVMCodeGenerator;
+
+// Options for compiling a source string held in memory
+struct SourceCompileOptions {
+    std::string module_name = "main"; // Name of the main module, used in diagnostics
+    bool auto_import_stdlib = true;
+    bool auto_import_builtins = true;
+    unsigned opt_level = 0; // 0-3, as the -O options of the pangea executable
+    BoundsCheckMode bounds_checks = BoundsCheckMode::DEBUG; // As --bounds-checks
+};
+
+// Outcome of an embedded compilation; diagnostics are returned, never printed
+struct CompileResult {
+    bool success = false;
+    std::vector<DiagnosticMessage> diagnostics;
+
+    explicit operator bool() const { return success; }
+};
+
+/**
+ * A program compiled into the current process.
+ * Owns the LLVM context and execution engine, so every function pointer
+ * obtained from it is only valid while the JITModule is alive.
+ */
+class JITModule {
+private:
+    std::unique_ptr<llvm::LLVMContext> context;
+    std::unique_ptr<llvm::ExecutionEngine> engine;
+
+public:
+    JITModule(std::unique_ptr<llvm::LLVMContext> context, std::unique_ptr<llvm::ExecutionEngine> engine);
+    ~JITModule();
+
+    JITModule(const JITModule&) = delete;
+    JITModule& operator=(const JITModule&) = delete;
+
+    /**
+     * Look up a compiled function; only exported functions and main can be found
+     * @param name Function name as declared in the Pangea source
+     * @return Address of the function, or nullptr if it does not exist
+     */
+    void* getFunctionAddress(const std::string& name) const;
+
+    template<typename Signature>
+    Signature* getFunction(const std::string& name) const {
+        return reinterpret_cast<Signature*>(getFunctionAddress(name));
+    }
+};
+
+/**
+ * In-process entry point to the compiler for embedding applications.
+ * Runs the same pipeline as the pangea executable on source held in memory.
+ * Imported modules are parsed once and reused by later compilations on the
+ * same instance; an instance must not be used from several threads at once.
+ */
+class EmbeddedCompiler {
+private:
+    std::unique_ptr<ModuleCache> module_cache;
+
+    std::unique_ptr<LLVMCodeGenerator> generate(const std::string& source, const SourceCompileOptions& options,
+                                                ErrorReporter& error_reporter);
+
+public:
+    EmbeddedCompiler();
+    ~EmbeddedCompiler();
+
+    /**
+     * Compile source to a relocatable object file image
+     * @param source Pangea source text
+     * @param object Receives the object file bytes
+     * @param options Compile options
+     * @return Success flag and diagnostics
+     */
+    CompileResult compileToObject(const std::string& source, std::vector<char>& object,
+                                  const SourceCompileOptions& options = {});
+
+    /**
+     * Compile source and link it into a shared library
+     * @param source Pangea source text
+     * @param output_file Library filename (.so/.dylib/.dll)
+     * @param options Compile options
+     * @return Success flag and diagnostics
+     */
+    CompileResult compileToSharedLibrary(const std::string& source, const std::string& output_file,
+                                         const SourceCompileOptions& options = {});
+
+    /**
+     * Compile source and load it into the current process
+     * @param source Pangea source text
+     * @param jit Receives the loaded module on success
+     * @param options Compile options
+     * @return Success flag and diagnostics
+     */
+    CompileResult compileToJIT(const std::string& source, std::unique_ptr<JITModule>& jit,
+                               const SourceCompileOptions& options = {});
+};
+
+} // namespace pangea
@@ -1,5 +1,7 @@
 #include "ast_nodes.h"
 #include "ast_visitor.h"
+#include <algorithm>
+#include <cctype>
 
 namespace pangea {
 
@@ -50,7 +52,7 @@ void ArrayType::accept(ASTVisitor& visitor) {
 }
 
 std::string ArrayType::toString() const {
-    return element_type->toString() + "[" + std::to_string(size) + "]";
+    return "[" + element_type->toString() + "; " + std::to_string(size) + "]";
 }
 
 void PointerType::accept(ASTVisitor& visitor) {
@@ -59,7 +61,9 @@ void PointerType::accept(ASTVisitor& visitor) {
 
 std::string PointerType::toString() const {
     switch (pointer_kind) {
-        case TokenType::CPTR: return "cptr<" + pointee_type->toString() + ">";
+        case TokenType::CPTR:
+            return (is_restrict ? "restrict cptr<" : "cptr<") + pointee_type->toString() +
+                   (length > 0 ? ", " + std::to_string(length) : "") + ">";
         case TokenType::UNIQUE: return "unique<" + pointee_type->toString() + ">";
         case TokenType::SHARED: return "shared<" + pointee_type->toString() + ">";
         case TokenType::WEAK: return "weak<" + pointee_type->toString() + ">";
@@ -142,6 +146,27 @@ void DeclarationStatement::accept(ASTVisitor& visitor) {
 }
 
 // Declaration implementations
+std::optional<uint64_t> AttributeArgument::integerValue() const {
+    if (value.empty() || value.size() > 18 || !std::all_of(value.begin(), value.end(), ::isdigit)) {
+        return std::nullopt;
+    }
+    return std::stoull(value);
+}
+
+std::string Attribute::toString() const {
+    std::string result = "@" + name;
+    if (!arguments.empty()) {
+        result += "(";
+        for (size_t i = 0; i < arguments.size(); ++i) {
+            if (i > 0) result += ", ";
+            if (!arguments[i].key.empty()) result += arguments[i].key + "=";
+            result += arguments[i].value;
+        }
+        result += ")";
+    }
+    return result;
+}
+
 void FunctionDeclaration::accept(ASTVisitor& visitor) {
     visitor.visit(*this);
 }
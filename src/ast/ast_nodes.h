@@ -6,11 +6,20 @@
 #include <vector>
 #include <string>
 #include <iostream>
+#include <cstdint>
+#include <optional>
 
 namespace pangea {
 
 // Forward declarations
 class ASTVisitor;
+class SemanticType;
+struct ConstantValue;
+struct ConstantArray;
+
+// Index into the DeclarationTable built by NameResolver
+using SymbolId = uint32_t;
+inline constexpr SymbolId NO_SYMBOL = UINT32_MAX;
 
 // Base AST Node
 class ASTNode {
@@ -67,6 +76,8 @@ class PointerType : public Type {
 public:
     std::unique_ptr<Type> pointee_type;
     TokenType pointer_kind; // MULTIPLY for raw, UNIQUE, SHARED, WEAK
+    bool is_restrict = false; // `restrict cptr<T>`: nothing else accessed in the function aliases it
+    uint64_t length = 0;      // `cptr<T, N>`: never null and points to at least N elements (bytes for void); 0 if unknown
     
     PointerType(const SourceLocation& loc, std::unique_ptr<Type> pointee, TokenType kind)
         : Type(loc), pointee_type(std::move(pointee)), pointer_kind(kind) {}
@@ -78,6 +89,18 @@ public:
 // Expressions
 class Expression : public ASTNode {
 public:
+    // Set by the type checker; interned in its TypeContext, so valid while that checker lives
+    const SemanticType* resolved_type = nullptr;
+
+    // Set by the ConstantEvaluator when the whole expression folds; owned by that evaluator
+    const ConstantValue* constant_value = nullptr;
+    // Likewise for a call of a const fn that returns an array
+    const ConstantArray* constant_array = nullptr;
+
+    // Index into a code generator's value table, only meaningful while value_pass matches that generator
+    uint32_t value_slot = 0;
+    uint32_t value_pass = 0;
+
     explicit Expression(const SourceLocation& loc) : ASTNode(loc) {}
 };
 
@@ -94,6 +117,7 @@ public:
 class IdentifierExpression : public Expression {
 public:
     std::string name;
+    SymbolId symbol_id = NO_SYMBOL; // Declaration this name resolves to
     
     IdentifierExpression(const SourceLocation& loc, const std::string& identifier)
         : Expression(loc), name(identifier) {}
@@ -229,11 +253,37 @@ public:
     void accept(ASTVisitor& visitor) override;
 };
 
+// One argument of an attribute: `4` and `full` are positional, `width=8` is keyed
+struct AttributeArgument {
+    std::string key; // Empty for positional arguments
+    std::string value;
+
+    // The value as a plain decimal integer, if it is one
+    std::optional<uint64_t> integerValue() const;
+};
+
+// A source annotation such as `@inline` or `@unroll(4)`
+struct Attribute {
+    SourceLocation location;
+    std::string name;
+    std::vector<AttributeArgument> arguments;
+
+    std::string toString() const;
+};
+
+// Expected outcome of an if/while condition written as `likely(...)` or `unlikely(...)`
+enum class BranchHint : uint8_t {
+    NONE,
+    LIKELY,
+    UNLIKELY
+};
+
 class IfStatement : public Statement {
 public:
     std::unique_ptr<Expression> condition;
     std::unique_ptr<Statement> then_branch;
     std::unique_ptr<Statement> else_branch; // nullable
+    BranchHint hint = BranchHint::NONE;
     
     IfStatement(const SourceLocation& loc, std::unique_ptr<Expression> cond, std::unique_ptr<Statement> then_stmt, std::unique_ptr<Statement> else_stmt = nullptr)
         : Statement(loc), condition(std::move(cond)), then_branch(std::move(then_stmt)), else_branch(std::move(else_stmt)) {}
@@ -245,6 +295,8 @@ class WhileStatement : public Statement {
 public:
     std::unique_ptr<Expression> condition;
     std::unique_ptr<Statement> body;
+    BranchHint hint = BranchHint::NONE; // Whether the loop is expected to keep running
+    std::vector<Attribute> attributes; // @vectorize, @no_vectorize, @unroll, @interleave
     
     WhileStatement(const SourceLocation& loc, std::unique_ptr<Expression> cond, std::unique_ptr<Statement> loop_body)
         : Statement(loc), condition(std::move(cond)), body(std::move(loop_body)) {}
@@ -255,8 +307,12 @@ public:
 class ForStatement : public Statement {
 public:
     std::string iterator_name;
-    std::unique_ptr<Expression> iterable;
+    SymbolId iterator_symbol_id = NO_SYMBOL;
+    std::unique_ptr<Expression> iterable; // The start of `a..b`
+    std::unique_ptr<Expression> range_end; // nullable; `b` of `a..b`, which is excluded
+    std::unique_ptr<Expression> step; // nullable; `step s`, a non-zero constant
     std::unique_ptr<Statement> body;
+    std::vector<Attribute> attributes; // @vectorize, @no_vectorize, @unroll, @interleave
     
     ForStatement(const SourceLocation& loc, const std::string& iter, std::unique_ptr<Expression> iter_expr, std::unique_ptr<Statement> loop_body)
         : Statement(loc), iterator_name(iter), iterable(std::move(iter_expr)), body(std::move(loop_body)) {}
@@ -296,6 +352,7 @@ public:
     std::string name;
     std::unique_ptr<Type> type;
     SourceLocation location;
+    SymbolId symbol_id = NO_SYMBOL;
     
     Parameter(const std::string& param_name, std::unique_ptr<Type> param_type, const SourceLocation& loc)
         : name(param_name), type(std::move(param_type)), location(loc) {}
@@ -304,10 +361,13 @@ public:
 class FunctionDeclaration : public Declaration {
 public:
     std::string name;
+    SymbolId symbol_id = NO_SYMBOL;
     std::vector<Parameter> parameters;
     std::unique_ptr<Type> return_type;
     std::unique_ptr<BlockStatement> body; // nullptr for foreign functions
     bool is_foreign;
+    bool is_const = false; // Declared `const fn`: calls with constant arguments are evaluated at compile time
+    std::vector<Attribute> attributes; // @inline, @noinline, @cold, @hot, @pure
     
     FunctionDeclaration(const SourceLocation& loc, const std::string& func_name, std::vector<Parameter> params, std::unique_ptr<Type> ret_type, std::unique_ptr<BlockStatement> func_body = nullptr, bool foreign = false)
         : Declaration(loc), name(func_name), parameters(std::move(params)), return_type(std::move(ret_type)), body(std::move(func_body)), is_foreign(foreign) {}
@@ -318,9 +378,12 @@ public:
 class VariableDeclaration : public Declaration {
 public:
     std::string name;
+    SymbolId symbol_id = NO_SYMBOL; // Left unset when the name is already defined in the same scope
     std::unique_ptr<Type> type; // nullable for type inference
     std::unique_ptr<Expression> initializer; // nullable
     bool is_mutable;
+    // Value of a const declaration or immutable let whose initializer folded, converted to the declared type
+    const ConstantValue* constant_value = nullptr;
     
     VariableDeclaration(const SourceLocation& loc, const std::string& var_name, std::unique_ptr<Type> var_type, std::unique_ptr<Expression> init, bool mutable_flag)
         : Declaration(loc), name(var_name), type(std::move(var_type)), initializer(std::move(init)), is_mutable(mutable_flag) {}
@@ -358,6 +421,8 @@ public:
     bool is_static;
     bool is_virtual;
     bool is_override;
+    SymbolId symbol_id = NO_SYMBOL;
+    SymbolId self_symbol_id = NO_SYMBOL; // Implicit 'self' of a constructor without a self parameter
     
     MethodMember(const std::string& method_name, const SourceLocation& loc, std::vector<Parameter> params, std::unique_ptr<Type> ret_type, std::unique_ptr<BlockStatement> method_body, bool public_access = true, bool static_method = false, bool virtual_method = false, bool override_method = false)
         : ClassMember(method_name, loc, public_access), parameters(std::move(params)), return_type(std::move(ret_type)), body(std::move(method_body)), is_static(static_method), is_virtual(virtual_method), is_override(override_method) {}
@@ -366,6 +431,7 @@ public:
 class ClassDeclaration : public Declaration {
 public:
     std::string name;
+    SymbolId symbol_id = NO_SYMBOL;
     std::vector<std::string> generic_parameters; // For generic classes like Array<T>
     std::string base_class; // For inheritance (empty if no base class)
     std::vector<std::unique_ptr<ClassMember>> members;
@@ -390,6 +456,7 @@ public:
 class StructDeclaration : public Declaration {
 public:
     std::string name;
+    SymbolId symbol_id = NO_SYMBOL;
     std::vector<StructField> fields;
     bool is_foreign;
     
@@ -403,6 +470,7 @@ public:
 class EnumVariant {
 public:
     std::string name;
+    SymbolId symbol_id = NO_SYMBOL;
     std::vector<std::unique_ptr<Type>> associated_types; // For variants with data
     SourceLocation location;
     
@@ -413,6 +481,7 @@ public:
 class EnumDeclaration : public Declaration {
 public:
     std::string name;
+    SymbolId symbol_id = NO_SYMBOL;
     std::vector<EnumVariant> variants;
     bool is_foreign;
     
@@ -465,7 +534,7 @@ public:
 // Program (root node) - now contains modules
 class Program : public ASTNode {
 public:
-    std::vector<std::unique_ptr<Module>> modules;
+    std::vector<std::shared_ptr<Module>> modules; // shared so parsed modules can be cached across compilations
     std::unique_ptr<Module> main_module; // The entry point module
     
     explicit Program(const SourceLocation& loc) : ASTNode(loc) {}
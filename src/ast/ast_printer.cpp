@@ -2,6 +2,18 @@
 
 namespace pangea {
 
+namespace {
+
+const char* branchHintSuffix(BranchHint hint) {
+    switch (hint) {
+        case BranchHint::LIKELY: return " (likely)";
+        case BranchHint::UNLIKELY: return " (unlikely)";
+        default: return "";
+    }
+}
+
+} // namespace
+
 void ASTPrinter::printProgram(Program& program) {
     program.accept(*this);
 }
@@ -240,7 +252,7 @@ void ASTPrinter::visit(BlockStatement& node) {
 }
 
 void ASTPrinter::visit(IfStatement& node) {
-    out << indent() << "IfStatement" << std::endl;
+    out << indent() << "IfStatement" << branchHintSuffix(node.hint) << std::endl;
     pushIndent();
     out << indent() << "condition:" << std::endl;
     pushIndent();
@@ -260,7 +272,11 @@ void ASTPrinter::visit(IfStatement& node) {
 }
 
 void ASTPrinter::visit(WhileStatement& node) {
-    out << indent() << "WhileStatement" << std::endl;
+    out << indent() << "WhileStatement" << branchHintSuffix(node.hint);
+    for (const auto& attribute : node.attributes) {
+        out << " " << attribute.toString();
+    }
+    out << std::endl;
     pushIndent();
     out << indent() << "condition:" << std::endl;
     pushIndent();
@@ -274,12 +290,28 @@ void ASTPrinter::visit(WhileStatement& node) {
 }
 
 void ASTPrinter::visit(ForStatement& node) {
-    out << indent() << "ForStatement(iterator: " << node.iterator_name << ")" << std::endl;
+    out << indent() << "ForStatement(iterator: " << node.iterator_name << ")";
+    for (const auto& attribute : node.attributes) {
+        out << " " << attribute.toString();
+    }
+    out << std::endl;
     pushIndent();
     out << indent() << "iterable:" << std::endl;
     pushIndent();
     node.iterable->accept(*this);
     popIndent();
+    if (node.range_end) {
+        out << indent() << "range end:" << std::endl;
+        pushIndent();
+        node.range_end->accept(*this);
+        popIndent();
+    }
+    if (node.step) {
+        out << indent() << "step:" << std::endl;
+        pushIndent();
+        node.step->accept(*this);
+        popIndent();
+    }
     out << indent() << "body:" << std::endl;
     pushIndent();
     node.body->accept(*this);
@@ -310,7 +342,11 @@ void ASTPrinter::visit(DeclarationStatement& node) {
 }
 
 void ASTPrinter::visit(FunctionDeclaration& node) {
-    out << indent() << "FunctionDeclaration(" << node.name << ")" << std::endl;
+    out << indent() << "FunctionDeclaration(" << node.name << ")" << (node.is_const ? " const" : "");
+    for (const auto& attribute : node.attributes) {
+        out << " " << attribute.toString();
+    }
+    out << std::endl;
     pushIndent();
     out << indent() << "return_type:" << std::endl;
     pushIndent();
@@ -0,0 +1,209 @@
+#include "ast_statistics.h"
+
+namespace pangea {
+
+// Type visitors
+void ASTStatistics::visit(PrimitiveType&) {
+    count("PrimitiveType");
+}
+
+void ASTStatistics::visit(ConstType& node) {
+    count("ConstType");
+    visitIfPresent(node.base_type.get());
+}
+
+void ASTStatistics::visit(ArrayType& node) {
+    count("ArrayType");
+    visitIfPresent(node.element_type.get());
+}
+
+void ASTStatistics::visit(PointerType& node) {
+    count("PointerType");
+    visitIfPresent(node.pointee_type.get());
+}
+
+void ASTStatistics::visit(GenericType& node) {
+    count("GenericType");
+    for (auto& arg : node.type_arguments) {
+        visitIfPresent(arg.get());
+    }
+}
+
+// Expression visitors
+void ASTStatistics::visit(LiteralExpression&) {
+    count("LiteralExpression");
+}
+
+void ASTStatistics::visit(IdentifierExpression&) {
+    count("IdentifierExpression");
+}
+
+void ASTStatistics::visit(BinaryExpression& node) {
+    count("BinaryExpression");
+    visitIfPresent(node.left.get());
+    visitIfPresent(node.right.get());
+}
+
+void ASTStatistics::visit(UnaryExpression& node) {
+    count("UnaryExpression");
+    visitIfPresent(node.operand.get());
+}
+
+void ASTStatistics::visit(CallExpression& node) {
+    count("CallExpression");
+    visitIfPresent(node.callee.get());
+    for (auto& arg : node.arguments) {
+        visitIfPresent(arg.get());
+    }
+}
+
+void ASTStatistics::visit(MemberExpression& node) {
+    count("MemberExpression");
+    visitIfPresent(node.object.get());
+}
+
+void ASTStatistics::visit(IndexExpression& node) {
+    count("IndexExpression");
+    visitIfPresent(node.object.get());
+    visitIfPresent(node.index.get());
+}
+
+void ASTStatistics::visit(AssignmentExpression& node) {
+    count("AssignmentExpression");
+    visitIfPresent(node.left.get());
+    visitIfPresent(node.right.get());
+}
+
+void ASTStatistics::visit(PostfixExpression& node) {
+    count("PostfixExpression");
+    visitIfPresent(node.operand.get());
+}
+
+void ASTStatistics::visit(CastExpression& node) {
+    count("CastExpression");
+    visitIfPresent(node.target_type.get());
+    visitIfPresent(node.expression.get());
+}
+
+void ASTStatistics::visit(AsExpression& node) {
+    count("AsExpression");
+    visitIfPresent(node.expression.get());
+    visitIfPresent(node.target_type.get());
+}
+
+// Statement visitors
+void ASTStatistics::visit(ExpressionStatement& node) {
+    count("ExpressionStatement");
+    visitIfPresent(node.expression.get());
+}
+
+void ASTStatistics::visit(BlockStatement& node) {
+    count("BlockStatement");
+    for (auto& stmt : node.statements) {
+        visitIfPresent(stmt.get());
+    }
+}
+
+void ASTStatistics::visit(IfStatement& node) {
+    count("IfStatement");
+    visitIfPresent(node.condition.get());
+    visitIfPresent(node.then_branch.get());
+    visitIfPresent(node.else_branch.get());
+}
+
+void ASTStatistics::visit(WhileStatement& node) {
+    count("WhileStatement");
+    visitIfPresent(node.condition.get());
+    visitIfPresent(node.body.get());
+}
+
+void ASTStatistics::visit(ForStatement& node) {
+    count("ForStatement");
+    visitIfPresent(node.iterable.get());
+    visitIfPresent(node.range_end.get());
+    visitIfPresent(node.step.get());
+    visitIfPresent(node.body.get());
+}
+
+void ASTStatistics::visit(ReturnStatement& node) {
+    count("ReturnStatement");
+    visitIfPresent(node.value.get());
+}
+
+void ASTStatistics::visit(DeclarationStatement& node) {
+    count("DeclarationStatement");
+    visitIfPresent(node.declaration.get());
+}
+
+// Declaration visitors
+void ASTStatistics::visit(FunctionDeclaration& node) {
+    count("FunctionDeclaration");
+    for (auto& param : node.parameters) {
+        visitIfPresent(param.type.get());
+    }
+    visitIfPresent(node.return_type.get());
+    visitIfPresent(node.body.get());
+}
+
+void ASTStatistics::visit(VariableDeclaration& node) {
+    count("VariableDeclaration");
+    visitIfPresent(node.type.get());
+    visitIfPresent(node.initializer.get());
+}
+
+void ASTStatistics::visit(ClassDeclaration& node) {
+    count("ClassDeclaration");
+    for (auto& member : node.members) {
+        if (auto* field = dynamic_cast<FieldMember*>(member.get())) {
+            visitIfPresent(field->type.get());
+            visitIfPresent(field->initializer.get());
+        } else if (auto* method = dynamic_cast<MethodMember*>(member.get())) {
+            for (auto& param : method->parameters) {
+                visitIfPresent(param.type.get());
+            }
+            visitIfPresent(method->return_type.get());
+            visitIfPresent(method->body.get());
+        }
+    }
+}
+
+void ASTStatistics::visit(StructDeclaration& node) {
+    count("StructDeclaration");
+    for (auto& field : node.fields) {
+        visitIfPresent(field.type.get());
+    }
+}
+
+void ASTStatistics::visit(EnumDeclaration& node) {
+    count("EnumDeclaration");
+    for (auto& variant : node.variants) {
+        for (auto& type : variant.associated_types) {
+            visitIfPresent(type.get());
+        }
+    }
+}
+
+void ASTStatistics::visit(ImportDeclaration&) {
+    count("ImportDeclaration");
+}
+
+// Module and Program visitors
+void ASTStatistics::visit(Module& node) {
+    count("Module");
+    for (auto& import : node.imports) {
+        visitIfPresent(import.get());
+    }
+    for (auto& decl : node.declarations) {
+        visitIfPresent(decl.get());
+    }
+}
+
+void ASTStatistics::visit(Program& node) {
+    count("Program");
+    for (auto& module : node.modules) {
+        visitIfPresent(module.get());
+    }
+    visitIfPresent(node.main_module.get());
+}
+
+} // namespace pangea
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "ast_visitor.h"
+#include <map>
+#include <string>
+
+namespace pangea {
+
+// Counts AST nodes by kind for --stats
+class ASTStatistics : public ASTVisitor {
+private:
+    std::map<std::string, size_t> node_counts;
+    size_t total_nodes = 0;
+
+    void count(const char* kind) { node_counts[kind]++; total_nodes++; }
+    void visitIfPresent(ASTNode* node) { if (node) node->accept(*this); }
+
+public:
+    void collect(Program& program) { program.accept(*this); }
+
+    const std::map<std::string, size_t>& getNodeCounts() const { return node_counts; }
+    size_t getTotalNodes() const { return total_nodes; }
+
+    // Type visitors
+    void visit(PrimitiveType& node) override;
+    void visit(ConstType& node) override;
+    void visit(ArrayType& node) override;
+    void visit(PointerType& node) override;
+    void visit(GenericType& node) override;
+
+    // Expression visitors
+    void visit(LiteralExpression& node) override;
+    void visit(IdentifierExpression& node) override;
+    void visit(BinaryExpression& node) override;
+    void visit(UnaryExpression& node) override;
+    void visit(CallExpression& node) override;
+    void visit(MemberExpression& node) override;
+    void visit(IndexExpression& node) override;
+    void visit(AssignmentExpression& node) override;
+    void visit(PostfixExpression& node) override;
+    void visit(CastExpression& node) override;
+    void visit(AsExpression& node) override;
+
+    // Statement visitors
+    void visit(ExpressionStatement& node) override;
+    void visit(BlockStatement& node) override;
+    void visit(IfStatement& node) override;
+    void visit(WhileStatement& node) override;
+    void visit(ForStatement& node) override;
+    void visit(ReturnStatement& node) override;
+    void visit(DeclarationStatement& node) override;
+
+    // Declaration visitors
+    void visit(FunctionDeclaration& node) override;
+    void visit(VariableDeclaration& node) override;
+    void visit(ClassDeclaration& node) override;
+    void visit(StructDeclaration& node) override;
+    void visit(EnumDeclaration& node) override;
+    void visit(ImportDeclaration& node) override;
+
+    // Module and Program visitors
+    void visit(Module& node) override;
+    void visit(Program& node) override;
+};
+
+} // namespace pangea
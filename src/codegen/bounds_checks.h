@@ -0,0 +1,28 @@
+#pragma once
+
+#include <optional>
+#include <string_view>
+
+namespace pangea {
+
+// When array indices are checked at run time (--bounds-checks=MODE)
+enum class BoundsCheckMode {
+    NONE,
+    DEBUG,  // Only in unoptimized (-O0) builds
+    ALWAYS
+};
+
+// Whether a compilation at this optimization level emits run-time bounds checks
+inline bool boundsChecksEnabled(BoundsCheckMode mode, unsigned opt_level) {
+    return mode == BoundsCheckMode::ALWAYS || (mode == BoundsCheckMode::DEBUG && opt_level == 0);
+}
+
+// The mode spelled as on the command line: none, debug or always
+inline std::optional<BoundsCheckMode> parseBoundsCheckMode(std::string_view name) {
+    if (name == "none") return BoundsCheckMode::NONE;
+    if (name == "debug") return BoundsCheckMode::DEBUG;
+    if (name == "always") return BoundsCheckMode::ALWAYS;
+    return std::nullopt;
+}
+
+} // namespace pangea
@@ -3,11 +3,16 @@
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/MC/TargetRegistry.h>
 #include <llvm/Support/FileSystem.h>
+#include <llvm/Support/FileUtilities.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/TargetParser/Host.h>
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 #include <llvm/ExecutionEngine/MCJIT.h>
 #include <llvm/Transforms/Utils/Cloning.h>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
 
 #ifdef _WIN32
     #include <windows.h>
@@ -23,8 +28,8 @@
 
 namespace pangea {
 
-Compiler::Compiler(LLVMCodeGenerator* cg, bool verbose)
-    : codegen(cg), verbose(verbose) {
+Compiler::Compiler(LLVMCodeGenerator* cg, bool verbose, ErrorReporter* reporter, PhaseTimer* phase_timer)
+    : codegen(cg), verbose(verbose), error_reporter(reporter), timer(phase_timer) {
 }
 
 // Static member for getting executable filename
@@ -39,8 +44,11 @@ std::string Compiler::getExecutableFilename(const std::string& filename) {
     return exe_filename;
 }
 
-// Non-member helper function to report compilation errors
-void reportCompilerError(const std::string& message) {
+void Compiler::reportCompilerError(const std::string& message) const {
+    if (error_reporter) {
+        error_reporter->reportError(SourceLocation(), "Compiler error: " + message);
+        return;
+    }
     std::cerr << "Compiler error: " << message << std::endl;
 }
 
@@ -77,72 +85,165 @@ bool Compiler::compileToExecutable(const std::string& filename) {
     return success;
 }
 
-bool Compiler::compileToObjectFile(const std::string& filename) {
-    // Initialize LLVM targets if not already done
-    llvm::InitializeAllTargetInfos();
-    llvm::InitializeAllTargets();
-    llvm::InitializeAllTargetMCs();
-    llvm::InitializeAllAsmParsers();
-    llvm::InitializeAllAsmPrinters();
+void Compiler::initializeTargets() {
+    static std::once_flag targets_initialized;
+    std::call_once(targets_initialized, [] {
+        llvm::InitializeAllTargetInfos();
+        llvm::InitializeAllTargets();
+        llvm::InitializeAllTargetMCs();
+        llvm::InitializeAllAsmParsers();
+        llvm::InitializeAllAsmPrinters();
+    });
+}
 
-    // Get the target triple for the current system
-    std::string target_triple = llvm::sys::getDefaultTargetTriple();
-    codegen->getModule().setTargetTriple(target_triple);
+llvm::TargetMachine* Compiler::getHostTargetMachine(std::string& error) {
+    initializeTargets();
+    return getTargetMachine(llvm::sys::getDefaultTargetTriple(), false, error);
+}
 
-    std::string error;
-    const llvm::Target* target = llvm::TargetRegistry::lookupTarget(target_triple, error);
+llvm::TargetMachine* Compiler::getTargetMachine(const std::string& target_triple, bool position_independent, std::string& error) {
+    // Target machines are expensive to create and are kept for the lifetime of the process
+    static std::mutex cache_mutex;
+    static std::unordered_map<std::string, std::unique_ptr<llvm::TargetMachine>> target_machines;
+
+    std::string key = target_triple + (position_independent ? "/pic" : "");
 
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    auto it = target_machines.find(key);
+    if (it != target_machines.end()) {
+        return it->second.get();
+    }
+
+    const llvm::Target* target = llvm::TargetRegistry::lookupTarget(target_triple, error);
     if (!target) {
-        // Using simplified error reporting
-        reportCompilerError("Failed to lookup target: " + error);
-        return false;
+        return nullptr;
     }
 
-    // Create target machine
     llvm::TargetOptions opt;
     auto reloc_model = std::optional<llvm::Reloc::Model>();
+    if (position_independent) {
+        reloc_model = llvm::Reloc::PIC_;
+    }
     llvm::TargetMachine* target_machine = target->createTargetMachine(
         target_triple, "generic", "", opt, reloc_model);
 
-    codegen->getModule().setDataLayout(target_machine->createDataLayout());
+    target_machines[key].reset(target_machine);
+    return target_machine;
+}
 
-    // Open output file
-    std::error_code error_code;
-    llvm::raw_fd_ostream dest(filename, error_code, llvm::sys::fs::OF_None);
+bool Compiler::emitObject(llvm::raw_pwrite_stream& dest, bool position_independent) {
+    PhaseScope phase(timer, "emit");
 
-    if (error_code) {
-        // Using simplified error reporting
-        reportCompilerError("Could not open file: " + error_code.message());
-        delete target_machine;
+    // Initialize LLVM targets if not already done
+    initializeTargets();
+
+    // Get the target triple for the current system
+    std::string target_triple = llvm::sys::getDefaultTargetTriple();
+    codegen->getModule().setTargetTriple(target_triple);
+
+    std::string error;
+    llvm::TargetMachine* target_machine = getTargetMachine(target_triple, position_independent, error);
+
+    if (!target_machine) {
+        reportCompilerError("Failed to lookup target: " + error);
         return false;
     }
 
+    codegen->getModule().setDataLayout(target_machine->createDataLayout());
+
     // Create pass manager and add target-specific passes
     llvm::legacy::PassManager pass;
     auto file_type = llvm::CodeGenFileType::ObjectFile;
 
     if (target_machine->addPassesToEmitFile(pass, dest, nullptr, file_type)) {
-        // Using simplified error reporting
         reportCompilerError("TargetMachine can't emit a file of this type");
-        delete target_machine;
         return false;
     }
 
     // Run the passes
     pass.run(codegen->getModule());
+    return true;
+}
+
+bool Compiler::compileToObjectFile(const std::string& filename) {
+    // Open output file
+    std::error_code error_code;
+    llvm::raw_fd_ostream dest(filename, error_code, llvm::sys::fs::OF_None);
+
+    if (error_code) {
+        reportCompilerError("Could not open file: " + error_code.message());
+        return false;
+    }
+
+    if (!emitObject(dest, false)) {
+        return false;
+    }
+
     dest.flush();
+    return true;
+}
+
+bool Compiler::compileToObjectBuffer(std::vector<char>& buffer, bool position_independent) {
+    llvm::SmallVector<char, 0> object;
+    llvm::raw_svector_ostream dest(object);
+
+    if (!emitObject(dest, position_independent)) {
+        return false;
+    }
 
-    delete target_machine;
+    buffer.assign(object.begin(), object.end());
     return true;
 }
 
-bool Compiler::linkObjectToExecutable(const std::string& obj_filename, const std::string& exe_filename) {
+bool Compiler::compileToSharedLibrary(const std::string& filename) {
+    logVerbose("Starting shared library compilation for: " + filename);
+
+    std::string obj_filename = filename + ".o";
+    logVerbose("Generating position independent object file: " + obj_filename);
+
+    {
+        std::error_code error_code;
+        llvm::raw_fd_ostream dest(obj_filename, error_code, llvm::sys::fs::OF_None);
+        if (error_code) {
+            reportCompilerError("Could not open file: " + error_code.message());
+            return false;
+        }
+
+        if (!emitObject(dest, true)) {
+            logVerbose("Failed to generate object file");
+            return false;
+        }
+    }
+
+    bool success = linkObjectToExecutable(obj_filename, filename, true);
+    if (success) {
+        logVerbose("Shared library created successfully: " + filename);
+        std::remove(obj_filename.c_str());
+    } else {
+        logVerbose("Failed to create shared library");
+    }
+
+    return success;
+}
+
+bool Compiler::linkObjectToExecutable(const std::string& obj_filename, const std::string& exe_filename, bool shared) {
+    PhaseScope phase(timer, "link");
+
     logVerbose("Starting cross-platform linking process");
     logVerbose("Object file: " + obj_filename);
     logVerbose("Target executable: " + exe_filename);
 
+    // Linker output goes to a log rather than straight to the terminal, so it reaches
+    // std::cerr and with it a compile server's client
+    llvm::SmallString<128> log_filename;
+    if (llvm::sys::fs::createTemporaryFile("pangea-link", "log", log_filename)) {
+        reportCompilerError("Could not create a temporary file for the linker output");
+        return false;
+    }
+    llvm::FileRemover log_remover(log_filename);
+
     // Get platform-specific linker commands
-    std::vector<std::string> linker_commands = getLinkerCommands(obj_filename, exe_filename);
+    std::vector<std::string> linker_commands = getLinkerCommands(obj_filename, exe_filename, log_filename.str().str(), shared);
 
     if (linker_commands.empty()) {
         // Using simplified error reporting
@@ -150,7 +251,9 @@ bool Compiler::linkObjectToExecutable(const std::string& obj_filename, const std
         return false;
     }
 
-    // Try each linker command in order of preference
+    // Try each linker command in order of preference, keeping what the first one that ran printed
+    std::string failed_linker;
+    std::string failed_output;
     for (const auto& command : linker_commands) {
         logVerbose("Trying linker command: " + command);
 
@@ -167,14 +270,25 @@ bool Compiler::linkObjectToExecutable(const std::string& obj_filename, const std
         if (result == 0) {
             logVerbose("Linking successful with: " + linker);
             return true;
-        } else {
-            logVerbose("Linking failed with exit code: " + std::to_string(result));
+        }
+
+        logVerbose("Linking failed with exit code: " + std::to_string(result));
+        if (failed_linker.empty()) {
+            failed_linker = linker;
+            if (auto log = llvm::MemoryBuffer::getFile(log_filename)) {
+                failed_output = (*log)->getBuffer().rtrim().str();
+            }
         }
     }
 
+    if (!failed_linker.empty()) {
+        reportCompilerError("Linking with " + failed_linker + " failed" + (failed_output.empty() ? "" : ":\n" + failed_output));
+        return false;
+    }
+
     std::string os = detectOperatingSystem();
     std::ostringstream error_msg;
-    error_msg << "Failed to create executable: No compatible linker found.\n";
+    error_msg << "Failed to create " << (shared ? "shared library" : "executable") << ": No compatible linker found.\n";
     error_msg << "Detected OS: " << os << "\n";
     error_msg << "Please install one of the following linkers:\n";
 
@@ -216,63 +330,62 @@ std::string Compiler::detectOperatingSystem() {
 #endif
 }
 
-std::vector<std::string> Compiler::getLinkerCommands(const std::string& obj_filename, const std::string& exe_filename) {
+std::vector<std::string> Compiler::getLinkerCommands(const std::string& obj_filename, const std::string& exe_filename,
+                                                     const std::string& log_filename, bool shared) {
     std::vector<std::string> commands;
     std::string os = detectOperatingSystem();
 
+    // Shared libraries only differ by the link mode flag
+    std::string shared_flag = shared ? " -shared" : "";
+
     // Escape filenames for shell safety
     std::string safe_obj = "\"" + obj_filename + "\"";
     std::string safe_exe = "\"" + exe_filename + "\"";
 
-    // Output redirection for quiet operation
-    std::string quiet_redirect;
-    if (os == "Windows") {
-        quiet_redirect = " >nul 2>nul";
-    } else {
-        quiet_redirect = " >/dev/null 2>&1";
-    }
+    // Both output streams go to the log, which cmd and sh spell the same way
+    std::string log_redirect = " >\"" + log_filename + "\" 2>&1";
 
     if (os == "Windows") {
         // Windows linker options in order of preference
         // 1. Clang (most compatible with LLVM) - link with MSVCRT for printf, math functions
-        commands.push_back("clang -o " + safe_exe + " " + safe_obj + " -lmsvcrt" + quiet_redirect);
+        commands.push_back("clang -o " + safe_exe + " " + safe_obj + shared_flag + " -lmsvcrt" + log_redirect);
 
         // 2. GCC (MinGW) - link with standard C library and math library
-        commands.push_back("gcc -o " + safe_exe + " " + safe_obj + " -lm -lmsvcrt" + quiet_redirect);
-        commands.push_back("x86_64-w64-mingw32-gcc -o " + safe_exe + " " + safe_obj + " -lm" + quiet_redirect);
+        commands.push_back("gcc -o " + safe_exe + " " + safe_obj + shared_flag + " -lm -lmsvcrt" + log_redirect);
+        commands.push_back("x86_64-w64-mingw32-gcc -o " + safe_exe + " " + safe_obj + shared_flag + " -lm" + log_redirect);
 
         // 3. Clang-cl (MSVC-compatible interface)
-        commands.push_back("clang-cl /Fe:" + safe_exe + " " + safe_obj + " msvcrt.lib legacy_stdio_definitions.lib" + quiet_redirect);
+        commands.push_back("clang-cl" + std::string(shared ? " /LD" : "") + " /Fe:" + safe_exe + " " + safe_obj + " msvcrt.lib legacy_stdio_definitions.lib" + log_redirect);
 
         // 4. Microsoft linker (if available)
-        commands.push_back("link.exe /OUT:" + safe_exe + " " + safe_obj + " /SUBSYSTEM:CONSOLE msvcrt.lib legacy_stdio_definitions.lib" + quiet_redirect);
+        commands.push_back("link.exe /OUT:" + safe_exe + " " + safe_obj + (shared ? " /DLL" : " /SUBSYSTEM:CONSOLE") + " msvcrt.lib legacy_stdio_definitions.lib" + log_redirect);
 
     } else if (os == "Linux") {
         // Linux linker options
         // 1. Clang (preferred for LLVM compatibility)
-        commands.push_back("clang -o " + safe_exe + " " + safe_obj + " -lm -lpthread" + quiet_redirect);
+        commands.push_back("clang -o " + safe_exe + " " + safe_obj + shared_flag + " -lm -lpthread" + log_redirect);
 
         // 2. GCC
-        commands.push_back("gcc -o " + safe_exe + " " + safe_obj + " -lm -lpthread" + quiet_redirect);
+        commands.push_back("gcc -o " + safe_exe + " " + safe_obj + shared_flag + " -lm -lpthread" + log_redirect);
 
         // 3. Alternative clang names
-        commands.push_back("clang-15 -o " + safe_exe + " " + safe_obj + " -lm -lpthread" + quiet_redirect);
-        commands.push_back("clang-14 -o " + safe_exe + " " + safe_obj + " -lm -lpthread" + quiet_redirect);
+        commands.push_back("clang-15 -o " + safe_exe + " " + safe_obj + shared_flag + " -lm -lpthread" + log_redirect);
+        commands.push_back("clang-14 -o " + safe_exe + " " + safe_obj + shared_flag + " -lm -lpthread" + log_redirect);
 
     } else if (os == "macOS") {
         // macOS linker options
         // 1. Clang (standard on macOS)
-        commands.push_back("clang -o " + safe_exe + " " + safe_obj + quiet_redirect);
+        commands.push_back("clang -o " + safe_exe + " " + safe_obj + shared_flag + log_redirect);
 
         // 2. GCC (if installed via Homebrew)
-        commands.push_back("gcc -o " + safe_exe + " " + safe_obj + quiet_redirect);
-        commands.push_back("gcc-13 -o " + safe_exe + " " + safe_obj + quiet_redirect);
-        commands.push_back("gcc-12 -o " + safe_exe + " " + safe_obj + quiet_redirect);
+        commands.push_back("gcc -o " + safe_exe + " " + safe_obj + shared_flag + log_redirect);
+        commands.push_back("gcc-13 -o " + safe_exe + " " + safe_obj + shared_flag + log_redirect);
+        commands.push_back("gcc-12 -o " + safe_exe + " " + safe_obj + shared_flag + log_redirect);
 
     } else {
         // Generic Unix-like system
-        commands.push_back("clang -o " + safe_exe + " " + safe_obj + " -lm" + quiet_redirect);
-        commands.push_back("gcc -o " + safe_exe + " " + safe_obj + " -lm" + quiet_redirect);
+        commands.push_back("clang -o " + safe_exe + " " + safe_obj + shared_flag + " -lm" + log_redirect);
+        commands.push_back("gcc -o " + safe_exe + " " + safe_obj + shared_flag + " -lm" + log_redirect);
     }
 
     return commands;
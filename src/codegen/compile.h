@@ -1,6 +1,8 @@
 #pragma once
 
 #include "llvm_codegen.h"
+#include "../utils/timer.h"
+#include <llvm/Target/TargetMachine.h>
 #include <string>
 #include <memory>
 
@@ -16,21 +18,34 @@ namespace pangea {
 private:
         LLVMCodeGenerator* codegen;
         bool verbose;
+        ErrorReporter* error_reporter; // Optional - errors go to stderr without one
+        PhaseTimer* timer;             // Optional - records emit/link times
+
+        // Object emission shared by the file and in-memory paths
+        bool emitObject(llvm::raw_pwrite_stream& dest, bool position_independent);
 
         // Cross-platform linking
-        bool linkObjectToExecutable(const std::string& obj_filename, const std::string& exe_filename);
+        bool linkObjectToExecutable(const std::string& obj_filename, const std::string& exe_filename, bool shared = false);
         static std::string detectOperatingSystem();
-        std::vector<std::string> getLinkerCommands(const std::string& obj_filename, const std::string& exe_filename);
+        std::vector<std::string> getLinkerCommands(const std::string& obj_filename, const std::string& exe_filename,
+                                                   const std::string& log_filename, bool shared = false);
         bool isCommandAvailable(const std::string& command) const;
         void logVerbose(const std::string& message) const;
+        void reportCompilerError(const std::string& message) const;
+
+        // Target setup is process-wide so repeated compilations (e.g. in server mode) reuse it
+        static llvm::TargetMachine* getTargetMachine(const std::string& target_triple, bool position_independent, std::string& error);
 
 public:
         /**
          * Construct compiler with LLVM code generator
          * @param cg Reference to initialized LLVMCodeGenerator
          * @param verbose Enable verbose compilation output
+         * @param reporter Collects compiler errors instead of printing them (optional)
+         * @param phase_timer Records time spent emitting and linking (optional)
          */
-        explicit Compiler(LLVMCodeGenerator* cg, bool verbose = false);
+        explicit Compiler(LLVMCodeGenerator* cg, bool verbose = false, ErrorReporter* reporter = nullptr,
+                          PhaseTimer* phase_timer = nullptr);
         ~Compiler() = default;
 
         /**
@@ -47,6 +62,33 @@ public:
          */
         bool compileToObjectFile(const std::string& filename);
 
+        /**
+         * Compile LLVM IR to an object file image in memory
+         * @param buffer Receives the object file bytes
+         * @param position_independent Emit PIC code (needed for shared objects)
+         * @return true if successful
+         */
+        bool compileToObjectBuffer(std::vector<char>& buffer, bool position_independent = false);
+
+        /**
+         * Compile LLVM IR to a shared library (.so/.dylib/.dll)
+         * @param filename Output library filename
+         * @return true if successful
+         */
+        bool compileToSharedLibrary(const std::string& filename);
+
+        /**
+         * Initialize all LLVM targets once per process
+         */
+        static void initializeTargets();
+
+        /**
+         * Get the target machine for the host, as used for executables and object files
+         * @param error Receives the reason when the host target is unavailable
+         * @return The cached target machine, or nullptr
+         */
+        static llvm::TargetMachine* getHostTargetMachine(std::string& error);
+
         /**
          * Get cross-platform executable filename
          * @param filename Base filename
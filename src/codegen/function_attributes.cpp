@@ -0,0 +1,160 @@
+#include "function_attributes.h"
+#include <llvm/ADT/SCCIterator.h>
+#include <llvm/Analysis/CallGraph.h>
+#include <llvm/Analysis/CFG.h>
+#include <llvm/Analysis/ValueTracking.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/Support/TimeProfiler.h>
+#include <algorithm>
+
+namespace pangea {
+
+namespace {
+
+// Whether a pointer refers to one of the function's own locals; a byval argument is a private copy
+bool isLocalMemory(const llvm::Value* pointer) {
+    const llvm::Value* object = llvm::getUnderlyingObject(pointer);
+    auto argument = llvm::dyn_cast<llvm::Argument>(object);
+    return llvm::isa<llvm::AllocaInst>(object) || (argument && argument->hasByValAttr());
+}
+
+bool hasLoop(const llvm::Function& function) {
+    llvm::SmallVector<std::pair<const llvm::BasicBlock*, const llvm::BasicBlock*>, 4> backedges;
+    llvm::FindFunctionBackedges(function, backedges);
+    return !backedges.empty();
+}
+
+// Functions codegen gave up on part way can have blocks without terminators
+bool isComplete(const llvm::Function& function) {
+    return std::all_of(function.begin(), function.end(),
+                       [](const llvm::BasicBlock& block) { return block.getTerminator() != nullptr; });
+}
+
+} // namespace
+
+void FunctionAttributeInference::run(llvm::Module& module) {
+    llvm::TimeTraceScope trace("Infer function attributes");
+    inferred_access.clear();
+
+    // scc_iterator yields the SCCs of the call graph in post-order, callees first
+    llvm::CallGraph call_graph(module);
+    for (auto scc = llvm::scc_begin(&call_graph); !scc.isAtEnd(); ++scc) {
+        std::vector<llvm::Function*> functions;
+        bool complete = true;
+        for (llvm::CallGraphNode* node : *scc) {
+            llvm::Function* function = node->getFunction();
+            if (function && !function->isDeclaration()) {
+                functions.push_back(function);
+                complete = complete && isComplete(*function);
+            }
+        }
+        if (!functions.empty() && complete) {
+            inferSCC(functions, scc.hasCycle());
+        }
+    }
+}
+
+FunctionAttributeInference::MemoryAccess FunctionAttributeInference::getInferredAccess(const llvm::Function& function) const {
+    auto it = inferred_access.find(&function);
+    return it != inferred_access.end() ? it->second : MemoryAccess::WRITE;
+}
+
+void FunctionAttributeInference::reportStatistics(CompilerStats& stats) const {
+    stats.set("attributes.nounwind functions", nounwind_functions);
+    stats.set("attributes.readnone functions", readnone_functions);
+    stats.set("attributes.readonly functions", readonly_functions);
+    stats.set("attributes.willreturn functions", willreturn_functions);
+    stats.set("attributes.norecurse functions", norecurse_functions);
+}
+
+void FunctionAttributeInference::inferSCC(const std::vector<llvm::Function*>& scc, bool recursive) {
+    auto in_scc = [&](const llvm::Function* function) {
+        return std::find(scc.begin(), scc.end(), function) != scc.end();
+    };
+
+    // Calls within the SCC only add what the other members do themselves, so they are skipped;
+    // the recursion itself rules out willreturn and norecurse
+    MemoryAccess access = MemoryAccess::NONE;
+    bool may_unwind = false;
+    bool may_not_return = recursive;
+    bool may_recurse = recursive;
+
+    for (llvm::Function* function : scc) {
+        may_not_return = may_not_return || hasLoop(*function);
+
+        for (llvm::BasicBlock& block : *function) {
+            for (llvm::Instruction& instruction : block) {
+                // Array copies and zeroing are judged by the memory they touch, like loads and stores
+                if (auto intrinsic = llvm::dyn_cast<llvm::MemIntrinsic>(&instruction)) {
+                    if (intrinsic->isVolatile() || !isLocalMemory(intrinsic->getRawDest())) {
+                        access = MemoryAccess::WRITE;
+                    } else if (auto transfer = llvm::dyn_cast<llvm::MemTransferInst>(intrinsic);
+                               transfer && !isLocalMemory(transfer->getRawSource())) {
+                        access = std::max(access, MemoryAccess::READ);
+                    }
+                } else if (auto call = llvm::dyn_cast<llvm::CallBase>(&instruction)) {
+                    llvm::Function* callee = call->getCalledFunction();
+                    if (callee && in_scc(callee)) {
+                        continue;
+                    }
+
+                    may_unwind = may_unwind || !call->doesNotThrow();
+                    may_not_return = may_not_return || !call->hasFnAttr(llvm::Attribute::WillReturn);
+                    may_recurse = may_recurse || !callee;
+
+                    if (call->doesNotAccessMemory()) {
+                        continue;
+                    }
+                    access = std::max(access, call->onlyReadsMemory() ? MemoryAccess::READ : MemoryAccess::WRITE);
+                } else if (auto load = llvm::dyn_cast<llvm::LoadInst>(&instruction)) {
+                    if (load->isVolatile()) {
+                        access = MemoryAccess::WRITE;
+                    } else if (!isLocalMemory(load->getPointerOperand())) {
+                        access = std::max(access, MemoryAccess::READ);
+                    }
+                } else if (auto store = llvm::dyn_cast<llvm::StoreInst>(&instruction)) {
+                    if (store->isVolatile() || !isLocalMemory(store->getPointerOperand())) {
+                        access = MemoryAccess::WRITE;
+                    }
+                } else if (instruction.mayWriteToMemory()) {
+                    access = MemoryAccess::WRITE;
+                } else if (instruction.mayReadFromMemory()) {
+                    access = std::max(access, MemoryAccess::READ);
+                }
+            }
+        }
+    }
+
+    for (llvm::Function* function : scc) {
+        inferred_access[function] = access;
+
+        if (!may_unwind && !function->doesNotThrow()) {
+            function->setDoesNotThrow();
+            nounwind_functions++;
+        }
+
+        // A declared memory attribute (from @pure) is kept even when the body could strengthen it
+        if (!function->onlyReadsMemory()) {
+            if (access == MemoryAccess::NONE) {
+                function->setDoesNotAccessMemory();
+                readnone_functions++;
+            } else if (access == MemoryAccess::READ) {
+                function->setOnlyReadsMemory();
+                readonly_functions++;
+            }
+        }
+
+        if (!may_not_return && !function->willReturn()) {
+            function->setWillReturn();
+            willreturn_functions++;
+        }
+
+        if (!may_recurse && !function->doesNotRecurse()) {
+            function->setDoesNotRecurse();
+            norecurse_functions++;
+        }
+    }
+}
+
+} // namespace pangea
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../utils/stats.h"
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Module.h>
+#include <unordered_map>
+#include <vector>
+
+namespace pangea {
+
+// Infers the function attributes LLVM would otherwise have to assume the
+// worst about: nounwind, readnone/readonly, willreturn and norecurse. Functions
+// are visited one call graph SCC at a time, callees first, so each call is
+// judged by the attributes already given to its callee. Foreign functions keep
+// whatever their declaration says; Pangea code never passes its functions to
+// them, so a foreign call is assumed not to re-enter the module.
+class FunctionAttributeInference {
+public:
+    // What a function does to memory visible outside it; its own allocas do not count
+    enum class MemoryAccess { NONE, READ, WRITE };
+
+private:
+    std::unordered_map<const llvm::Function*, MemoryAccess> inferred_access;
+
+    size_t nounwind_functions = 0;
+    size_t readnone_functions = 0;
+    size_t readonly_functions = 0;
+    size_t willreturn_functions = 0;
+    size_t norecurse_functions = 0;
+
+public:
+    /**
+     * Add attributes to every function defined in a module
+     * @param module A verified module
+     */
+    void run(llvm::Module& module);
+
+    /**
+     * How a defined function accesses memory according to its body, regardless of
+     * the attributes it was declared with
+     * @return The access found by the last run, or WRITE for functions it did not see
+     */
+    MemoryAccess getInferredAccess(const llvm::Function& function) const;
+
+    void reportStatistics(CompilerStats& stats) const;
+
+private:
+    void inferSCC(const std::vector<llvm::Function*>& scc, bool recursive);
+};
+
+} // namespace pangea
@@ -1,6 +1,8 @@
 #include "llvm_codegen.h"
+#include "../semantic/type_context.h"
+#include "../semantic/constant_evaluator.h"
 #include <iostream>
-#include <unordered_set>
+#include <atomic>
 #include <optional>
 #include <cstdlib>
 #include <filesystem>
@@ -9,10 +11,16 @@
 #include <llvm/MC/TargetRegistry.h>
 #include <llvm/Support/FileSystem.h>
 #include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/Intrinsics.h>
+#include <llvm/IR/MDBuilder.h>
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Passes/StandardInstrumentations.h>
 #include <llvm/TargetParser/Host.h>
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 #include <llvm/ExecutionEngine/MCJIT.h>
 #include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Support/MathExtras.h>
+#include <llvm/Support/TimeProfiler.h>
 
 #ifdef _WIN32
     #include <windows.h>
@@ -28,20 +36,30 @@
 
 namespace pangea {
 
-LLVMCodeGenerator::LLVMCodeGenerator(ErrorReporter* reporter, bool verbose, bool enable_builtins) 
-    : error_reporter(reporter), verbose(verbose) {
+// Each generator gets its own pass id, so value slots left in a (possibly cached) AST
+// by an earlier generator are never mistaken for this one's
+static std::atomic<uint32_t> next_pass_id{1};
+
+LLVMCodeGenerator::LLVMCodeGenerator(ErrorReporter* reporter, bool verbose, bool enable_builtins, bool bounds_checks) 
+    : error_reporter(reporter), verbose(verbose), bounds_checks(bounds_checks),
+      pass_id(next_pass_id.fetch_add(1, std::memory_order_relaxed)) {
     context = std::make_unique<llvm::LLVMContext>();
     module = std::make_unique<llvm::Module>("pangea_module", *context);
     builder = std::make_unique<llvm::IRBuilder<>>(*context);
 }
 
-void LLVMCodeGenerator::generateCode(Program& program) {
+void LLVMCodeGenerator::generateCode(Program& program, const DeclarationTable* declaration_table) {
+    // Only needed while lowering; the table belongs to the caller
+    declarations = declaration_table;
     try {
         program.accept(*this);
+        inferFunctionAttributes();
     } catch (const std::exception& e) {
+        declarations = nullptr;
         std::cerr << "Error during LLVM code generation: " << e.what() << std::endl;
         throw;
     }
+    declarations = nullptr;
 }
 
 void LLVMCodeGenerator::emitToFile(const std::string& filename) {
@@ -61,6 +79,102 @@ void LLVMCodeGenerator::emitToString(std::string& output) {
     module->print(string_stream, nullptr);
 }
 
+void LLVMCodeGenerator::optimize(unsigned level, llvm::TargetMachine* target_machine) {
+    if (level == 0) {
+        // No loop pass runs, so every hint is dropped
+        if (error_reporter) {
+            for (const auto& loop : annotated_loops) {
+                error_reporter->reportWarning(loop.location, "Loop hints " + loop.hints + " have no effect below -O1");
+            }
+        }
+        return;
+    }
+
+    llvm::TimeTraceScope trace("Optimize module");
+
+    if (target_machine) {
+        module->setTargetTriple(target_machine->getTargetTriple().str());
+        module->setDataLayout(target_machine->createDataLayout());
+    }
+
+    llvm::LoopAnalysisManager loop_analyses;
+    llvm::FunctionAnalysisManager function_analyses;
+    llvm::CGSCCAnalysisManager cgscc_analyses;
+    llvm::ModuleAnalysisManager module_analyses;
+
+    // The standard instrumentation includes the time-trace handler, so --time-trace gets one scope per pass
+    llvm::PassInstrumentationCallbacks pass_callbacks;
+    llvm::StandardInstrumentations instrumentation(*context, false);
+    instrumentation.registerCallbacks(pass_callbacks, &module_analyses);
+
+    llvm::PassBuilder pass_builder(target_machine, llvm::PipelineTuningOptions(), std::nullopt, &pass_callbacks);
+    pass_builder.registerModuleAnalyses(module_analyses);
+    pass_builder.registerCGSCCAnalyses(cgscc_analyses);
+    pass_builder.registerFunctionAnalyses(function_analyses);
+    pass_builder.registerLoopAnalyses(loop_analyses);
+    pass_builder.crossRegisterProxies(loop_analyses, function_analyses, cgscc_analyses, module_analyses);
+
+    llvm::OptimizationLevel optimization_level = llvm::OptimizationLevel::O3;
+    if (level == 1) {
+        optimization_level = llvm::OptimizationLevel::O1;
+    } else if (level == 2) {
+        optimization_level = llvm::OptimizationLevel::O2;
+    }
+
+    // Route the loop passes' remarks to the loops that asked for a transformation
+    std::vector<LoopRemarkCollector::Remark> loop_remarks;
+    std::unique_ptr<llvm::DiagnosticHandler> previous_handler;
+    if (!annotated_loops.empty()) {
+        previous_handler = context->getDiagnosticHandler();
+        context->setDiagnosticHandler(std::make_unique<LoopRemarkCollector>(loop_remarks));
+    }
+
+    llvm::ModulePassManager passes = pass_builder.buildPerModuleDefaultPipeline(optimization_level);
+    passes.run(*module, module_analyses);
+
+    if (previous_handler) {
+        context->setDiagnosticHandler(std::move(previous_handler));
+        reportLoopRemarks(loop_remarks);
+    }
+}
+
+void LLVMCodeGenerator::reportStatistics(CompilerStats& stats) const {
+    size_t defined_functions = 0;
+    size_t basic_blocks = 0;
+    size_t instructions = 0;
+    for (const auto& function : *module) {
+        if (function.isDeclaration()) continue;
+        defined_functions++;
+        basic_blocks += function.size();
+        instructions += function.getInstructionCount();
+    }
+
+    stats.set("codegen.bound declarations", bound_declarations);
+    stats.set("codegen.skipped external declarations", skipped_declarations);
+    stats.set("codegen.folded constants", folded_constants);
+    stats.set("codegen.entry block allocas", entry_allocas);
+    stats.set("codegen.short-circuit branches", branched_logical_operators);
+    stats.set("codegen.short-circuit selects", selected_logical_operators);
+    stats.set("codegen.hinted branches", hinted_branches);
+    stats.set("codegen.internal functions", internal_functions);
+    stats.set("codegen.source attributes", source_attributes);
+    stats.set("codegen.noalias parameters", noalias_parameters);
+    stats.set("codegen.dereferenceable parameters", dereferenceable_parameters);
+    stats.set("codegen.power multiply chains", power_chains);
+    stats.set("codegen.power calls", power_calls);
+    stats.set("codegen.counted loops", counted_loops);
+    stats.set("codegen.bounds checks", emitted_bounds_checks);
+    stats.set("codegen.bounds checks elided", elided_bounds_checks);
+    stats.set("codegen.annotated loops", annotated_loops.size());
+    attribute_inference.reportStatistics(stats);
+    stats.set("codegen.expression value slots", expression_values.size());
+    stats.set("llvm.functions (defined)", defined_functions);
+    stats.set("llvm.functions (declared)", module->size() - defined_functions);
+    stats.set("llvm.global variables", module->global_size());
+    stats.set("llvm.basic blocks", basic_blocks);
+    stats.set("llvm.instructions", instructions);
+}
+
 bool LLVMCodeGenerator::verify() {
     if (verbose) {
         std::cout << "Starting LLVM module verification..." << std::endl;
@@ -74,8 +188,6 @@ bool LLVMCodeGenerator::verify() {
         error_stream.flush();
         
         if (verification_failed) {
-            std::cerr << "Module verification failed with errors:" << std::endl;
-            std::cerr << error_string << std::endl;
             reportCodegenError(SourceLocation(), "Module verification failed: " + error_string);
             return false;
         }
@@ -113,15 +225,25 @@ void LLVMCodeGenerator::visit(LiteralExpression& node) {
     llvm::Value* value = nullptr;
     
     switch (node.literal_token.type) {
-        case TokenType::INTEGER_LITERAL:
-            // Default integer literals to i32 to match semantic analysis
-            value = llvm::ConstantInt::get(llvm::Type::getInt32Ty(*context), node.literal_token.int_value);
+        case TokenType::INTEGER_LITERAL: {
+            // Use the width the type checker chose (suffix, or i64 for large values)
+            llvm::Type* int_type = node.resolved_type ? convertSemanticType(*node.resolved_type) : nullptr;
+            if (!int_type || !int_type->isIntegerTy()) {
+                int_type = llvm::Type::getInt32Ty(*context);
+            }
+            value = llvm::ConstantInt::get(int_type, node.literal_token.int_value);
             break;
+        }
             
-        case TokenType::FLOAT_LITERAL:
-            // Default float literals to f64 to match semantic analysis
-            value = llvm::ConstantFP::get(llvm::Type::getDoubleTy(*context), node.literal_token.float_value);
+        case TokenType::FLOAT_LITERAL: {
+            // f64 unless the type checker saw an f32 suffix
+            llvm::Type* float_type = node.resolved_type ? convertSemanticType(*node.resolved_type) : nullptr;
+            if (!float_type || !float_type->isFloatingPointTy()) {
+                float_type = llvm::Type::getDoubleTy(*context);
+            }
+            value = llvm::ConstantFP::get(float_type, node.literal_token.float_value);
             break;
+        }
             
         case TokenType::BOOLEAN_LITERAL:
             value = llvm::ConstantInt::get(llvm::Type::getInt1Ty(*context), node.literal_token.bool_value ? 1 : 0);
@@ -145,27 +267,13 @@ void LLVMCodeGenerator::visit(LiteralExpression& node) {
 }
 
 void LLVMCodeGenerator::visit(IdentifierExpression& node) {
-    // First check if it's a function (for function calls)
-    llvm::Function* func = module->getFunction(node.name);
-    if (func) {
-        // This is a function identifier - set it as the expression value
-        setExpressionValue(node, func);
+    // References to folded constants become immediates instead of loads
+    if (emitFoldedConstant(node)) {
         return;
     }
 
-    // Check if it's a type identifier (class, struct, enum constructor)
-    // These are handled specially in CallExpression for instantiation
-    if (isTypeIdentifier(node.name)) {
-        // For type identifiers used in constructor calls, create a placeholder
-        // The actual instantiation logic will be handled in CallExpression
-        llvm::Value* type_placeholder = llvm::ConstantPointerNull::get(
-            llvm::PointerType::get(llvm::Type::getInt8Ty(*context), 0));
-        setExpressionValue(node, type_placeholder);
-        return;
-    }
-
-    // Then check if it's a variable using the improved symbol table
-    LLVMCodeGenerator::VariableInfo* var_info = lookupVariable(node.name);
+    // Functions, variables and type names are all bound by the declaration's id
+    LLVMCodeGenerator::VariableInfo* var_info = lookupVariable(node.symbol_id);
     if (!var_info) {
         reportCodegenError(node.location, "Unknown variable: " + node.name);
         return;
@@ -173,6 +281,12 @@ void LLVMCodeGenerator::visit(IdentifierExpression& node) {
 
     llvm::Value* value = var_info->value;
 
+    // Arrays are never loaded whole; an array expression stands for the address of its storage
+    if (node.resolved_type && node.resolved_type->kind == SemanticType::Kind::ARRAY) {
+        setExpressionValue(node, value);
+        return;
+    }
+
     // Load the value if it's an alloca (local variable) or global variable
     if (auto alloca = llvm::dyn_cast<llvm::AllocaInst>(value)) {
         value = builder->CreateLoad(alloca->getAllocatedType(), value, node.name);
@@ -184,6 +298,15 @@ void LLVMCodeGenerator::visit(IdentifierExpression& node) {
 }
 
 void LLVMCodeGenerator::visit(BinaryExpression& node) {
+    if (emitFoldedConstant(node)) {
+        return;
+    }
+
+    if (node.operator_token == TokenType::LOGICAL_AND || node.operator_token == TokenType::LOGICAL_OR) {
+        generateShortCircuit(node);
+        return;
+    }
+
     // Generate code for both operands
     node.left->accept(*this);
     node.right->accept(*this);
@@ -196,13 +319,22 @@ void LLVMCodeGenerator::visit(BinaryExpression& node) {
         return;
     }
 
+    // The exponent keeps its own type, so float ** int can use powi
+    if (node.operator_token == TokenType::POWER) {
+        if (llvm::Value* result = generatePower(node, left_val, right_val)) {
+            setExpressionValue(node, result);
+        }
+        return;
+    }
+
     // Handle type promotion for mixed-type operations
     llvm::Type* left_type = left_val->getType();
     llvm::Type* right_type = right_val->getType();
     llvm::Type* common_type = nullptr;
 
     if (left_type != right_type && isNumericType(left_type) && isNumericType(right_type)) {
-        auto [promoted_left, promoted_right] = promoteToCommonType(left_val, right_val);
+        auto [promoted_left, promoted_right] = promoteToCommonType(left_val, getNumericKind(*node.left, left_type),
+                                                                   right_val, getNumericKind(*node.right, right_type));
         if (!promoted_left || !promoted_right) {
             reportCodegenError(node.location, "Failed to promote operands to common type");
             return;
@@ -216,12 +348,6 @@ void LLVMCodeGenerator::visit(BinaryExpression& node) {
 
     llvm::Value* result = nullptr;
 
-    // Handle special case operators
-    if (node.operator_token == TokenType::POWER) {
-        reportCodegenError(node.location, "Power operator not yet fully implemented");
-        return;
-    }
-
     // Try arithmetic operations first (covers int/float/bitwise)
     result = generateArithmeticOperation(node.operator_token, left_val, right_val, common_type);
 
@@ -230,11 +356,6 @@ void LLVMCodeGenerator::visit(BinaryExpression& node) {
         result = generateComparisonOperation(node.operator_token, left_val, right_val);
     }
 
-    // If not comparison, try boolean operations
-    if (!result) {
-        result = generateBooleanOperation(node.operator_token, left_val, right_val);
-    }
-
     // Handle pointer comparisons
     if (!result && (left_type->isPointerTy() || right_type->isPointerTy())) {
         TokenType op = node.operator_token;
@@ -254,6 +375,10 @@ void LLVMCodeGenerator::visit(BinaryExpression& node) {
 }
 
 void LLVMCodeGenerator::visit(UnaryExpression& node) {
+    if (emitFoldedConstant(node)) {
+        return;
+    }
+
     node.operand->accept(*this);
     
     llvm::Value* operand_val = getExpressionValue(*node.operand);
@@ -294,6 +419,17 @@ void LLVMCodeGenerator::visit(UnaryExpression& node) {
 }
 
 void LLVMCodeGenerator::visit(CallExpression& node) {
+    // Calls of a const fn evaluated at compile time
+    if (emitFoldedConstant(node)) {
+        return;
+    }
+    if (node.constant_array) {
+        // Array results are read-only data, which array declarations copy from like any other source
+        setExpressionValue(node, getFoldedArrayGlobal(*node.constant_array));
+        folded_constants++;
+        return;
+    }
+
     node.callee->accept(*this);
     
     // Handle method calls (member expressions)
@@ -312,7 +448,8 @@ void LLVMCodeGenerator::visit(CallExpression& node) {
     }
     
     // Look up function - it should already be declared via foreign fn or regular fn
-    llvm::Function* callee_func = module->getFunction(callee_id->name);
+    VariableInfo* callee_info = lookupVariable(callee_id->symbol_id);
+    llvm::Function* callee_func = callee_info ? llvm::dyn_cast_or_null<llvm::Function>(callee_info->value) : nullptr;
     if (!callee_func) {
         reportCodegenError(node.location, "Unknown function: " + callee_id->name + 
                           " (functions must be declared with 'fn' or 'foreign fn')");
@@ -330,6 +467,19 @@ void LLVMCodeGenerator::visit(CallExpression& node) {
         }
         args.push_back(arg_val);
     }
+
+    // An array result goes to storage in the caller, which then stands for the call
+    llvm::AllocaInst* array_result = nullptr;
+    if (callee_func->hasStructRetAttr()) {
+        // Outside a function there is nowhere to put the result; the global
+        // being initialized reports that its initializer is not a constant
+        if (!current_function || !alloca_insert_point) {
+            return;
+        }
+        llvm::Type* result_type = callee_func->getParamAttribute(0, llvm::Attribute::StructRet).getValueAsType();
+        array_result = createEntryBlockAlloca(result_type, "arrayret");
+        args.insert(args.begin(), array_result);
+    }
     
     // Handle variadic functions - apply standard C varargs promotions
     if (callee_func->isVarArg()) {
@@ -374,13 +524,23 @@ void LLVMCodeGenerator::visit(CallExpression& node) {
     }
     
     // Create call instruction - only assign name if function returns a value
-    llvm::Value* result;
+    llvm::CallInst* result;
     if (callee_func->getReturnType()->isVoidTy()) {
         result = builder->CreateCall(callee_func, args);
     } else {
         result = builder->CreateCall(callee_func, args, "calltmp");
     }
-    setExpressionValue(node, result);
+    result->setCallingConv(callee_func->getCallingConv());
+
+    // byval and sret change what the pointer means, so the call site must say them too
+    for (unsigned i = 0; i < callee_func->arg_size(); ++i) {
+        for (auto kind : {llvm::Attribute::ByVal, llvm::Attribute::StructRet}) {
+            if (callee_func->hasParamAttribute(i, kind)) {
+                result->addParamAttr(i, callee_func->getParamAttribute(i, kind));
+            }
+        }
+    }
+    setExpressionValue(node, array_result ? static_cast<llvm::Value*>(array_result) : result);
 }
 
 void LLVMCodeGenerator::visit(MemberExpression& node) {
@@ -410,10 +570,167 @@ void LLVMCodeGenerator::visit(MemberExpression& node) {
 }
 
 void LLVMCodeGenerator::visit(IndexExpression& node) {
-    reportCodegenError(node.location, "Array indexing not yet implemented");
+    llvm::Type* element_type = nullptr;
+    llvm::Value* address = generateElementAddress(node, element_type);
+    if (!address) {
+        return;
+    }
+    // A row of a nested array stands for its address, like any array
+    setExpressionValue(node, element_type->isArrayTy() ? address : builder->CreateLoad(element_type, address, "elem"));
+}
+
+llvm::Value* LLVMCodeGenerator::generateElementAddress(IndexExpression& node, llvm::Type*& element_type) {
+    const SemanticType* object_type = node.object->resolved_type;
+    bool is_array = object_type && object_type->kind == SemanticType::Kind::ARRAY;
+    if (!object_type || (!is_array && object_type->kind != SemanticType::Kind::POINTER) || !object_type->element_type) {
+        reportCodegenError(node.location, "Cannot index a value of this type");
+        return nullptr;
+    }
+
+    // An array is indexed where it lives; a cptr's value is the address of its first element
+    llvm::Value* base = nullptr;
+    if (is_array) {
+        base = generateArrayAddress(*node.object);
+    } else {
+        node.object->accept(*this);
+        base = getExpressionValue(*node.object);
+    }
+    node.index->accept(*this);
+    llvm::Value* index = getExpressionValue(*node.index);
+    element_type = convertSemanticType(*object_type->element_type);
+    if (!base || !index || !element_type) {
+        reportCodegenError(node.location, "Invalid index expression");
+        return nullptr;
+    }
+
+    // Widen the index to pointer width as its signedness says
+    PrimitiveKind index_kind = getNumericKind(*node.index, index->getType());
+    index = convertNumeric(index, index_kind, primitive::isSigned(index_kind) ? PrimitiveKind::I64 : PrimitiveKind::U64);
+    if (!index) {
+        reportCodegenError(node.index->location, "Index must be an integer");
+        return nullptr;
+    }
+    if (!is_array) {
+        return builder->CreateInBoundsGEP(element_type, base, index, "elemptr");
+    }
+
+    generateBoundsCheck(node, index, object_type->length);
+    llvm::Type* array_type = convertSemanticType(*object_type);
+    return builder->CreateInBoundsGEP(array_type, base, {builder->getInt64(0), index}, "elemptr");
+}
+
+llvm::Value* LLVMCodeGenerator::generateArrayAddress(Expression& array) {
+    array.accept(*this);
+    llvm::Value* address = getExpressionValue(array);
+    if (!address || !address->getType()->isPointerTy()) {
+        reportCodegenError(array.location, "Invalid array expression");
+        return nullptr;
+    }
+    return address;
+}
+
+void LLVMCodeGenerator::generateArrayCopy(llvm::Value* destination, llvm::Value* source, llvm::Type* type) {
+    const llvm::DataLayout& layout = module->getDataLayout();
+    llvm::Align align = layout.getABITypeAlign(type);
+    builder->CreateMemCpy(destination, align, source, align, layout.getTypeAllocSize(type).getFixedValue());
+}
+
+void LLVMCodeGenerator::generateBoundsCheck(IndexExpression& node, llvm::Value* index, uint64_t length) {
+    // A constant index is checked now, whatever the mode; unsigned values past INT64_MAX read as negative
+    if (std::optional<ConstantValue> value = getFoldedValue(*node.index)) {
+        if (value->integer < 0 || static_cast<uint64_t>(value->integer) >= length) {
+            std::string shown = primitive::isSigned(value->kind) ? std::to_string(value->integer)
+                                                                 : std::to_string(static_cast<uint64_t>(value->integer));
+            reportCodegenError(node.index->location, "Index " + shown + " is out of bounds for an array of " +
+                               std::to_string(length) + " elements");
+        }
+        return;
+    }
+
+    if (!bounds_checks) {
+        return;
+    }
+    if (isIndexInRange(*node.index, length)) {
+        elided_bounds_checks++;
+        return;
+    }
+
+    // The index is already 64 bits wide, so one unsigned compare also catches negative values
+    llvm::Function* function = builder->GetInsertBlock()->getParent();
+    llvm::BasicBlock* fail_block = createBasicBlock("outofbounds", function);
+    llvm::BasicBlock* continue_block = createBasicBlock("inbounds", function);
+    llvm::Value* in_bounds = builder->CreateICmpULT(index, builder->getInt64(length), "inbounds");
+    builder->CreateCondBr(in_bounds, continue_block, fail_block, llvm::MDBuilder(*context).createBranchWeights(2000, 1));
+
+    builder->SetInsertPoint(fail_block);
+    builder->CreateIntrinsic(llvm::Intrinsic::trap, {}, {});
+    builder->CreateUnreachable();
+
+    builder->SetInsertPoint(continue_block);
+    emitted_bounds_checks++;
+}
+
+bool LLVMCodeGenerator::isIndexInRange(const Expression& index, uint64_t length) const {
+    auto identifier = dynamic_cast<const IdentifierExpression*>(&index);
+    auto range = identifier ? iterator_ranges.find(identifier->symbol_id) : iterator_ranges.end();
+    if (range == iterator_ranges.end()) {
+        return false;
+    }
+
+    // An empty range never reaches the body
+    auto [first, last] = range->second;
+    return first > last || (first >= 0 && static_cast<uint64_t>(last) < length);
+}
+
+void LLVMCodeGenerator::generateElementAssignment(AssignmentExpression& node, IndexExpression& target, llvm::Value* value) {
+    llvm::Type* element_type = nullptr;
+    llvm::Value* address = generateElementAddress(target, element_type);
+    if (!address) {
+        return;
+    }
+
+    PrimitiveKind element_kind = target.resolved_type ? target.resolved_type->primitive_kind : PrimitiveKind::NONE;
+    PrimitiveKind value_kind = getNumericKind(*node.right, value->getType());
+
+    if (node.operator_token != TokenType::ASSIGN) {
+        llvm::Value* current = builder->CreateLoad(element_type, address, "elem");
+        auto [promoted_current, promoted_value] = promoteToCommonType(current, element_kind, value, value_kind);
+        value = promoted_current
+            ? generateArithmeticOperation(TokenUtils::compoundAssignmentOperator(node.operator_token),
+                                          promoted_current, promoted_value, promoted_current->getType())
+            : nullptr;
+        if (!value) {
+            reportCodegenError(node.location, "Invalid compound assignment operation or unsupported type combination");
+            return;
+        }
+        value_kind = primitive::commonKind(element_kind, value_kind);
+    }
+
+    if (primitive::isNumeric(element_kind) && primitive::isNumeric(value_kind)) {
+        value = convertNumeric(value, value_kind, element_kind);
+    }
+    if (!value || value->getType() != element_type) {
+        reportCodegenError(node.location, "Cannot store this value in an element of type " + target.resolved_type->toString());
+        return;
+    }
+
+    builder->CreateStore(value, address);
+    setExpressionValue(node, value);
 }
 
 void LLVMCodeGenerator::visit(AssignmentExpression& node) {
+    if (node.operator_token == TokenType::ASSIGN && node.left->resolved_type &&
+        node.left->resolved_type->kind == SemanticType::Kind::ARRAY) {
+        llvm::Value* source = generateArrayAddress(*node.right);
+        llvm::Value* destination = source ? generateArrayAddress(*node.left) : nullptr;
+        if (!destination) {
+            return;
+        }
+        generateArrayCopy(destination, source, convertSemanticType(*node.left->resolved_type));
+        setExpressionValue(node, destination);
+        return;
+    }
+
     // Generate code for right-hand side
     node.right->accept(*this);
     llvm::Value* right_val = getExpressionValue(*node.right);
@@ -422,6 +739,11 @@ void LLVMCodeGenerator::visit(AssignmentExpression& node) {
         return;
     }
 
+    if (auto element = dynamic_cast<IndexExpression*>(node.left.get())) {
+        generateElementAssignment(node, *element, right_val);
+        return;
+    }
+
     // For now, only support identifier assignments
     auto identifier = dynamic_cast<IdentifierExpression*>(node.left.get());
     if (!identifier) {
@@ -430,7 +752,7 @@ void LLVMCodeGenerator::visit(AssignmentExpression& node) {
     }
 
     // Use improved variable lookup system
-    VariableInfo* var_info = lookupVariable(identifier->name);
+    VariableInfo* var_info = lookupVariable(identifier->symbol_id);
     if (!var_info) {
         reportCodegenError(node.location, "Unknown variable: " + identifier->name);
         return;
@@ -454,7 +776,8 @@ void LLVMCodeGenerator::visit(AssignmentExpression& node) {
         llvm::Type* common_type = nullptr;
 
         if (current_type != right_type && isNumericType(current_type) && isNumericType(right_type)) {
-            auto [promoted_current, promoted_right] = promoteToCommonType(current_val, right_val);
+            auto [promoted_current, promoted_right] = promoteToCommonType(current_val, getNumericKind(*identifier, current_type),
+                                                                          right_val, getNumericKind(*node.right, right_type));
             if (!promoted_current || !promoted_right) {
                 reportCodegenError(node.location, "Failed to promote operands for compound assignment");
                 return;
@@ -467,7 +790,8 @@ void LLVMCodeGenerator::visit(AssignmentExpression& node) {
         }
 
         // Use the DRY arithmetic operation helper
-        right_val = generateArithmeticOperation(node.operator_token, current_val, right_val, common_type);
+        right_val = generateArithmeticOperation(TokenUtils::compoundAssignmentOperator(node.operator_token),
+                                                current_val, right_val, common_type);
 
         if (!right_val) {
             reportCodegenError(node.location,
@@ -497,7 +821,7 @@ void LLVMCodeGenerator::visit(PostfixExpression& node) {
     }
     
     // Use improved variable lookup for postfix expression
-    LLVMCodeGenerator::VariableInfo* var_info = lookupVariable(identifier->name);
+    LLVMCodeGenerator::VariableInfo* var_info = lookupVariable(identifier->symbol_id);
     if (!var_info) {
         reportCodegenError(node.location, "Unknown variable: " + identifier->name);
         return;
@@ -559,6 +883,10 @@ void LLVMCodeGenerator::visit(PostfixExpression& node) {
 }
 
 void LLVMCodeGenerator::visit(CastExpression& node) {
+    if (emitFoldedConstant(node)) {
+        return;
+    }
+
     // Generate code for the expression being cast
     node.expression->accept(*this);
     
@@ -645,6 +973,10 @@ void LLVMCodeGenerator::visit(CastExpression& node) {
             return;
         }
     }
+    // Pointer to pointer casts only change the pointee type
+    else if (source_type->isPointerTy() && target_type->isPointerTy()) {
+        result = builder->CreatePointerCast(source_val, target_type, "ptrcast");
+    }
     // String conversions (placeholder - would need runtime support)
     else if (target_type->isPointerTy()) {
         // Cast to string - for now, just return a placeholder
@@ -666,6 +998,10 @@ void LLVMCodeGenerator::visit(CastExpression& node) {
 }
 
 void LLVMCodeGenerator::visit(AsExpression& node) {
+    if (emitFoldedConstant(node)) {
+        return;
+    }
+
     // 'as' operator is equivalent to cast<T>(x) - always succeeds but may truncate
     // Generate code for the expression being cast
     node.expression->accept(*this);
@@ -791,10 +1127,11 @@ void LLVMCodeGenerator::visit(IfStatement& node) {
     llvm::BasicBlock* merge_block = createBasicBlock("ifcont", function);
     
     // Branch based on condition
+    llvm::MDNode* weights = getBranchWeights(node.hint);
     if (else_block) {
-        builder->CreateCondBr(condition_val, then_block, else_block);
+        builder->CreateCondBr(condition_val, then_block, else_block, weights);
     } else {
-        builder->CreateCondBr(condition_val, then_block, merge_block);
+        builder->CreateCondBr(condition_val, then_block, merge_block, weights);
     }
     
     // Generate then block
@@ -851,22 +1188,166 @@ void LLVMCodeGenerator::visit(WhileStatement& node) {
     // Use DRY condition evaluation helper
     condition_val = evaluateCondition(condition_val);
     
-    builder->CreateCondBr(condition_val, body_block, after_block);
+    builder->CreateCondBr(condition_val, body_block, after_block, getBranchWeights(node.hint));
     
     // Generate loop body
     builder->SetInsertPoint(body_block);
     node.body->accept(*this);
-    builder->CreateBr(loop_block);
+    llvm::BranchInst* backedge = builder->CreateBr(loop_block);
+
+    std::vector<llvm::Metadata*> properties = getLoopHintProperties(node.attributes);
+    if (!properties.empty()) {
+        backedge->setMetadata(llvm::LLVMContext::MD_loop, createLoopMetadata(properties));
+    }
     
     // Continue after loop
     builder->SetInsertPoint(after_block);
 }
 
 void LLVMCodeGenerator::visit(ForStatement& node) {
-    reportCodegenError(node.location, "For loops not yet implemented");
+    if (!node.range_end) {
+        reportCodegenError(node.location, "For loops can only iterate over integer ranges");
+        return;
+    }
+
+    node.iterable->accept(*this);
+    node.range_end->accept(*this);
+    llvm::Value* start = getExpressionValue(*node.iterable);
+    llvm::Value* end = getExpressionValue(*node.range_end);
+    if (!start || !end) {
+        reportCodegenError(node.location, "Invalid range bounds");
+        return;
+    }
+
+    PrimitiveKind start_kind = getNumericKind(*node.iterable, start->getType());
+    PrimitiveKind end_kind = getNumericKind(*node.range_end, end->getType());
+    PrimitiveKind kind = primitive::commonKind(start_kind, end_kind);
+    if (!primitive::isInteger(kind)) {
+        reportCodegenError(node.location, "Range bounds must be integers");
+        return;
+    }
+    start = convertNumeric(start, start_kind, kind);
+    end = convertNumeric(end, end_kind, kind);
+    llvm::Type* type = start->getType();
+    bool is_signed = primitive::isSigned(kind);
+    unsigned width = primitive::bitWidth(kind);
+
+    // The step decides the direction and trip count, so it has to be known here
+    int64_t step = 1;
+    if (node.step) {
+        std::optional<ConstantValue> value = getFoldedValue(*node.step);
+        if (!value || !primitive::isInteger(value->kind) || value->integer == 0 ||
+            (!primitive::isSigned(value->kind) && value->integer < 0)) {
+            reportCodegenError(node.step->location, "Loop step must be a non-zero integer constant");
+            return;
+        }
+        step = value->integer;
+    }
+    uint64_t magnitude = step < 0 ? uint64_t(0) - static_cast<uint64_t>(step) : static_cast<uint64_t>(step);
+    uint64_t max_magnitude = width >= 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+    if (is_signed) {
+        max_magnitude >>= 1;
+    }
+    if (magnitude > max_magnitude + (is_signed && step < 0 ? 1 : 0)) {
+        reportCodegenError(node.step->location, "Loop step does not fit in the iterator type " + std::string(primitive::name(kind)));
+        return;
+    }
+    bool ascending = step > 0;
+
+    // Trip count: ceil(distance / |step|) when the range is not empty. The distance is
+    // exact as an unsigned number, so neither it nor the count can overflow
+    llvm::Value* non_empty = ascending
+        ? (is_signed ? builder->CreateICmpSLT(start, end, "nonempty") : builder->CreateICmpULT(start, end, "nonempty"))
+        : (is_signed ? builder->CreateICmpSGT(start, end, "nonempty") : builder->CreateICmpUGT(start, end, "nonempty"));
+    llvm::Value* distance = ascending ? builder->CreateSub(end, start, "distance") : builder->CreateSub(start, end, "distance");
+    llvm::Value* trip_count = distance;
+    if (magnitude != 1) {
+        llvm::Value* last = builder->CreateSub(distance, llvm::ConstantInt::get(type, 1), "lastdistance");
+        llvm::Value* steps = builder->CreateUDiv(last, llvm::ConstantInt::get(type, magnitude), "steps");
+        trip_count = builder->CreateAdd(steps, llvm::ConstantInt::get(type, 1), "trips", true);
+    }
+    trip_count = builder->CreateSelect(non_empty, trip_count, llvm::ConstantInt::get(type, 0), "tripcount");
+
+    // The body reads the iterator from its slot; mem2reg turns it back into the phi
+    llvm::AllocaInst* iterator = createLocalVariable(node.iterator_symbol_id, node.iterator_name, type, node.location);
+    if (!iterator) {
+        return;
+    }
+
+    llvm::Function* function = builder->GetInsertBlock()->getParent();
+    llvm::BasicBlock* preheader = builder->GetInsertBlock();
+    llvm::BasicBlock* header_block = createBasicBlock("for", function);
+    llvm::BasicBlock* body_block = createBasicBlock("forbody", function);
+    llvm::BasicBlock* latch_block = createBasicBlock("forlatch", function);
+    llvm::BasicBlock* after_block = createBasicBlock("afterfor", function);
+    builder->CreateBr(header_block);
+
+    // The exit test is on the count alone, so the iterator's last increment may
+    // overflow (into a value nothing uses) and every increment can be nsw
+    builder->SetInsertPoint(header_block);
+    llvm::PHINode* count = builder->CreatePHI(type, 2, "forcount");
+    llvm::PHINode* value = builder->CreatePHI(type, 2, node.iterator_name);
+    builder->CreateCondBr(builder->CreateICmpULT(count, trip_count, "forcond"), body_block, after_block);
+
+    // The iterator cannot be assigned, so with constant bounds its range is known to the body.
+    // Only non-empty loops get one, which also keeps bound - 1 and bound + 1 from overflowing
+    std::optional<ConstantValue> first = getFoldedValue(*node.iterable);
+    std::optional<ConstantValue> bound = getFoldedValue(*node.range_end);
+    bool known_range = first && bound && primitive::isInteger(first->kind) && primitive::isInteger(bound->kind) &&
+                       first->integer >= 0 && bound->integer >= 0 &&
+                       (ascending ? first->integer < bound->integer : first->integer > bound->integer);
+    if (known_range) {
+        iterator_ranges[node.iterator_symbol_id] = ascending ? std::make_pair(first->integer, bound->integer - 1)
+                                                             : std::make_pair(bound->integer + 1, first->integer);
+    }
+
+    builder->SetInsertPoint(body_block);
+    builder->CreateStore(value, iterator);
+    node.body->accept(*this);
+    if (!builder->GetInsertBlock()->getTerminator()) {
+        builder->CreateBr(latch_block);
+    }
+    iterator_ranges.erase(node.iterator_symbol_id);
+
+    builder->SetInsertPoint(latch_block);
+    llvm::Value* next_count = builder->CreateAdd(count, llvm::ConstantInt::get(type, 1), "nextcount", true);
+    llvm::Value* next_value = nullptr;
+    if (is_signed) {
+        next_value = builder->CreateAdd(value, llvm::ConstantInt::get(type, step, true), "next", false, true);
+    } else if (ascending) {
+        next_value = builder->CreateAdd(value, llvm::ConstantInt::get(type, magnitude), "next", true);
+    } else {
+        next_value = builder->CreateSub(value, llvm::ConstantInt::get(type, magnitude), "next", true);
+    }
+    llvm::BranchInst* backedge = builder->CreateBr(header_block);
+
+    // Counted loops always terminate, so they may be assumed to make progress
+    std::vector<llvm::Metadata*> properties = getLoopHintProperties(node.attributes);
+    properties.insert(properties.begin(), llvm::MDNode::get(*context, llvm::MDString::get(*context, "llvm.loop.mustprogress")));
+    backedge->setMetadata(llvm::LLVMContext::MD_loop, createLoopMetadata(properties));
+
+    count->addIncoming(llvm::ConstantInt::get(type, 0), preheader);
+    count->addIncoming(next_count, latch_block);
+    value->addIncoming(start, preheader);
+    value->addIncoming(next_value, latch_block);
+    counted_loops++;
+
+    builder->SetInsertPoint(after_block);
 }
 
 void LLVMCodeGenerator::visit(ReturnStatement& node) {
+    // Array results are copied into the caller's storage
+    if (node.value && current_function->hasStructRetAttr()) {
+        llvm::Value* source = generateArrayAddress(*node.value);
+        if (!source) {
+            return;
+        }
+        llvm::Type* type = current_function->getParamAttribute(0, llvm::Attribute::StructRet).getValueAsType();
+        generateArrayCopy(current_function->getArg(0), source, type);
+        builder->CreateRetVoid();
+        return;
+    }
+
     if (node.value) {
         node.value->accept(*this);
         llvm::Value* return_val = getExpressionValue(*node.value);
@@ -887,6 +1368,14 @@ void LLVMCodeGenerator::visit(DeclarationStatement& node) {
 }
 
 void LLVMCodeGenerator::visit(FunctionDeclaration& node) {
+    // Only foreign functions something calls become LLVM declares
+    if (node.is_foreign && declarations && !declarations->isReferenced(node.symbol_id)) {
+        skipped_declarations++;
+        return;
+    }
+
+    llvm::TimeTraceScope trace("Codegen function", node.name);
+
     // Convert parameter types
     std::vector<llvm::Type*> param_types;
     bool has_variadic = false;
@@ -905,7 +1394,8 @@ void LLVMCodeGenerator::visit(FunctionDeclaration& node) {
             break;
         }
         
-        param_types.push_back(param_type);
+        // Arrays are passed as a pointer to a copy the caller makes (byval), as C passes large structs
+        param_types.push_back(param_type->isArrayTy() ? param_type->getPointerTo() : param_type);
     }
     
     // Convert return type
@@ -914,41 +1404,64 @@ void LLVMCodeGenerator::visit(FunctionDeclaration& node) {
         reportCodegenError(node.location, "Invalid return type");
         return;
     }
+
+    // An array result is written through a pointer to the caller's storage (sret), passed first
+    if (return_type->isArrayTy()) {
+        param_types.insert(param_types.begin(), return_type->getPointerTo());
+        return_type = llvm::Type::getVoidTy(*context);
+    }
     
     // Create function type (variadic if has raw_va_list parameter)
     llvm::FunctionType* func_type = llvm::FunctionType::get(return_type, param_types, has_variadic);
     
     // Check if this is a foreign function declaration
     if (node.is_foreign) {
-        // Create external function declaration only
-        llvm::Function* function = llvm::Function::Create(
-            func_type, 
-            llvm::Function::ExternalLinkage, 
-            node.name, 
-            module.get()
-        );
-        
+        // Several modules may declare the same foreign function; they all bind to one declaration
+        llvm::Function* function = module->getFunction(node.name);
+        if (!function) {
+            // Create external function declaration only
+            function = llvm::Function::Create(
+                func_type, 
+                llvm::Function::ExternalLinkage, 
+                node.name, 
+                module.get()
+            );
+            
+            // Foreign functions are C functions, which never unwind
+            function->setDoesNotThrow();
+        }
+        applySourceAttributes(function, node);
+        applyParameterAttributes(function, node);
+
         // Set parameter names
-        auto arg_it = function->arg_begin();
-        for (size_t i = 0; i < node.parameters.size() && i < param_types.size(); ++i, ++arg_it) {
+        auto arg_it = function->arg_begin() + (function->hasStructRetAttr() ? 1 : 0);
+        for (size_t i = 0; i < node.parameters.size() && arg_it != function->arg_end(); ++i, ++arg_it) {
             arg_it->setName(node.parameters[i].name);
         }
         
+        declareVariable(node.symbol_id, VariableInfo(function, true, node.location, node.is_exported, true));
         return; // Foreign functions don't have bodies
     }
     
-    // Regular function - create with body
-    llvm::Function* function = createFunction(node.name, func_type);
+    // Regular function - create with body; only exported functions and main are visible to the linker
+    llvm::Function* function = createFunction(node.name, func_type, node.is_exported || node.name == "main" || !node.body);
     if (!function) {
         reportCodegenError(node.location, "Failed to create function");
         return;
     }
+    declareVariable(node.symbol_id, VariableInfo(function, true, node.location, node.is_exported, true));
+    applySourceAttributes(function, node);
+    applyParameterAttributes(function, node);
     
     // Set parameter names
-    auto arg_it = function->arg_begin();
-    for (size_t i = 0; i < node.parameters.size() && i < param_types.size(); ++i, ++arg_it) {
+    unsigned first_parameter = function->hasStructRetAttr() ? 1 : 0;
+    auto arg_it = function->arg_begin() + first_parameter;
+    for (size_t i = 0; i < node.parameters.size() && arg_it != function->arg_end(); ++i, ++arg_it) {
         arg_it->setName(node.parameters[i].name);
     }
+    if (first_parameter > 0) {
+        function->getArg(0)->setName("result");
+    }
     
     // Only create function body for non-foreign functions
     if (node.body) {
@@ -959,15 +1472,25 @@ void LLVMCodeGenerator::visit(FunctionDeclaration& node) {
         // Save current function and set new one
         llvm::Function* old_function = current_function;
         current_function = function;
+
+        // Locals are allocated ahead of this marker, the body is emitted after it
+        llvm::Instruction* old_alloca_insert_point = alloca_insert_point;
+        llvm::Type* marker_type = builder->getInt32Ty();
+        alloca_insert_point = new llvm::BitCastInst(llvm::UndefValue::get(marker_type), marker_type, "allocapt", entry_block);
         
         // Create allocas for parameters
         enterFunctionScope(function);
-        arg_it = function->arg_begin();
-        for (size_t i = 0; i < node.parameters.size() && i < param_types.size(); ++i, ++arg_it) {
-            llvm::AllocaInst* alloca = builder->CreateAlloca(arg_it->getType(), nullptr, node.parameters[i].name);
+        arg_it = function->arg_begin() + first_parameter;
+        for (size_t i = 0; i < node.parameters.size() && arg_it != function->arg_end(); ++i, ++arg_it) {
+            // A byval array already is this function's own copy
+            if (arg_it->hasByValAttr()) {
+                declareVariable(node.parameters[i].symbol_id, VariableInfo(&*arg_it, false, node.location, false, false));
+                continue;
+            }
+            llvm::AllocaInst* alloca = createEntryBlockAlloca(arg_it->getType(), node.parameters[i].name);
             builder->CreateStore(&*arg_it, alloca);
             VariableInfo param_info(alloca, false, node.location, false, false);
-            declareVariable(node.parameters[i].name, std::move(param_info));
+            declareVariable(node.parameters[i].symbol_id, std::move(param_info));
         }
 
         // Generate function body
@@ -979,18 +1502,37 @@ void LLVMCodeGenerator::visit(FunctionDeclaration& node) {
         }
         
         // Restore previous state
+        alloca_insert_point->eraseFromParent();
+        alloca_insert_point = old_alloca_insert_point;
         exitFunctionScope();
         current_function = old_function;
     }
 }
 
 void LLVMCodeGenerator::visit(VariableDeclaration& node) {
-    const bool is_const = dynamic_cast<ConstType*>(node.type.get()) != nullptr;
+    // Likewise for globals defined elsewhere
+    if (!current_function && !node.initializer && declarations && !declarations->isReferenced(node.symbol_id)) {
+        skipped_declarations++;
+        return;
+    }
+
+    llvm::Type* declared_type = node.type ? convertType(*node.type)
+        : node.initializer && node.initializer->resolved_type ? convertSemanticType(*node.initializer->resolved_type)
+        : nullptr;
+    if (declared_type && declared_type->isArrayTy()) {
+        generateArrayDeclaration(node, declared_type);
+        return;
+    }
+
+    // Immutable lets that folded are constants too, so their globals land in read-only data
+    const bool is_const = dynamic_cast<ConstType*>(node.type.get()) != nullptr || node.constant_value;
     const bool is_exported = node.is_exported;
 
-    // Evaluate initializer if present
+    // Evaluate initializer if present; folded constants need no code at all
     llvm::Value* init_val = nullptr;
-    if (node.initializer) {
+    if (node.constant_value) {
+        init_val = getFoldedConstant(*node.constant_value);
+    } else if (node.initializer) {
         node.initializer->accept(*this);
         init_val = getExpressionValue(*node.initializer);
 
@@ -998,7 +1540,7 @@ void LLVMCodeGenerator::visit(VariableDeclaration& node) {
         if (!init_val) {
             if (auto id_expr = dynamic_cast<IdentifierExpression*>(node.initializer.get())) {
                 // First check if it's a local or global variable in new system
-                VariableInfo* var_info = lookupVariable(id_expr->name);
+                VariableInfo* var_info = lookupVariable(id_expr->symbol_id);
                 
                 if (!var_info) {
                     reportCodegenError(node.initializer->location, "Invalid initializer for variable: " + node.name);
@@ -1037,7 +1579,7 @@ void LLVMCodeGenerator::visit(VariableDeclaration& node) {
 
         auto *g = new llvm::GlobalVariable(*module, var_type, is_const, linkage, init_const, node.name);
         VariableInfo global_info(g, is_const, node.location, is_exported, true);
-        declareVariable(node.name, std::move(global_info));
+        declareVariable(node.symbol_id, std::move(global_info));
         return;
     }
 
@@ -1064,14 +1606,14 @@ void LLVMCodeGenerator::visit(VariableDeclaration& node) {
             }
 
             VariableInfo const_info(folded, true, node.location, false, false);
-            declareVariable(node.name, std::move(const_info));
+            declareVariable(node.symbol_id, std::move(const_info));
             return;
         }
         // Fall through to alloca+store if initializer isn't a constant
     }
 
     // Normal mutable local variable: alloca + store
-    llvm::AllocaInst* alloca = builder->CreateAlloca(var_type, nullptr, node.name);
+    llvm::AllocaInst* alloca = createEntryBlockAlloca(var_type, node.name);
     if (init_val) {
         llvm::Value* to_store = init_val;
         if (to_store->getType() != var_type) {
@@ -1089,7 +1631,64 @@ void LLVMCodeGenerator::visit(VariableDeclaration& node) {
     }
 
     VariableInfo var_info(alloca, false, node.location, false, false);
-    declareVariable(node.name, std::move(var_info));
+    declareVariable(node.symbol_id, std::move(var_info));
+}
+
+void LLVMCodeGenerator::generateArrayDeclaration(VariableDeclaration& node, llvm::Type* array_type) {
+    const ConstantArray* folded = node.initializer ? node.initializer->constant_array : nullptr;
+    // Immutable arrays a const fn filled cannot change either, as with folded scalars
+    const bool is_const = dynamic_cast<ConstType*>(node.type.get()) != nullptr || (folded && !node.is_mutable);
+
+    if (!current_function) {
+        // Only another constant array can initialize a global one
+        llvm::Constant* init_const = llvm::ConstantAggregateZero::get(array_type);
+        if (folded) {
+            init_const = getFoldedArray(*folded);
+        } else if (node.initializer) {
+            node.initializer->accept(*this);
+            auto *source = llvm::dyn_cast_or_null<llvm::GlobalVariable>(getExpressionValue(*node.initializer));
+            if (!source || !source->isConstant() || !source->hasInitializer()) {
+                reportCodegenError(node.location, "Global initializer must be a constant: " + node.name);
+                return;
+            }
+            init_const = source->getInitializer();
+        }
+
+        auto linkage = node.is_exported ? llvm::GlobalValue::ExternalLinkage
+                                        : llvm::GlobalValue::InternalLinkage;
+        auto *g = new llvm::GlobalVariable(*module, array_type, is_const, linkage, init_const, node.name);
+        declareVariable(node.symbol_id, VariableInfo(g, is_const, node.location, node.is_exported, true));
+
+        // A constant global doubles as the folded array's data, so the table is embedded once
+        if (folded && is_const && array_type == init_const->getType()) {
+            llvm::GlobalVariable*& shared = folded_arrays[folded];
+            if (shared && shared->hasPrivateLinkage()) {
+                // Uses generated before this declaration move over to it
+                shared->replaceAllUsesWith(g);
+                shared->eraseFromParent();
+                shared = nullptr;
+            }
+            if (!shared) {
+                shared = g;
+            }
+        }
+        return;
+    }
+
+    // Locals are filled in place, like clang does for C arrays: a memcpy from the initializer or a memset
+    // to zero, never an aggregate store, which instruction selection splits into one store per element
+    llvm::Value* source = node.initializer ? generateArrayAddress(*node.initializer) : nullptr;
+    if (node.initializer && !source) {
+        return;
+    }
+    llvm::AllocaInst* alloca = createEntryBlockAlloca(array_type, node.name);
+    if (source) {
+        generateArrayCopy(alloca, source, array_type);
+    } else {
+        uint64_t size = module->getDataLayout().getTypeAllocSize(array_type).getFixedValue();
+        builder->CreateMemSet(alloca, builder->getInt8(0), size, alloca->getAlign());
+    }
+    declareVariable(node.symbol_id, VariableInfo(alloca, false, node.location, false, false));
 }
 
 void LLVMCodeGenerator::visit(ImportDeclaration& node) {
@@ -1099,6 +1698,8 @@ void LLVMCodeGenerator::visit(ImportDeclaration& node) {
 }
 
 void LLVMCodeGenerator::visit(Module& node) {
+    llvm::TimeTraceScope trace("Codegen module", node.module_name);
+
     // Process all imports first (for symbol resolution)
     for (auto& import : node.imports) {
         import->accept(*this);
@@ -1131,16 +1732,22 @@ void LLVMCodeGenerator::visit(ClassDeclaration& node) {
     // Class declarations are handled during semantic analysis
     // The actual class structure is managed by the type system
     // Methods and constructors are handled separately
+    declareTypePlaceholder(node.symbol_id, node.location);
 }
 
 void LLVMCodeGenerator::visit(StructDeclaration& node) {
     // Struct declarations are handled during semantic analysis
     // The actual struct layout is managed by the type system
+    declareTypePlaceholder(node.symbol_id, node.location);
 }
 
 void LLVMCodeGenerator::visit(EnumDeclaration& node) {
     // Enum declarations are handled during semantic analysis
     // Enum values are treated as constants by the type system
+    declareTypePlaceholder(node.symbol_id, node.location);
+    for (auto& variant : node.variants) {
+        declareTypePlaceholder(variant.symbol_id, variant.location);
+    }
 }
 
 llvm::Type* LLVMCodeGenerator::convertType(Type& ast_type) {
@@ -1153,8 +1760,7 @@ llvm::Type* LLVMCodeGenerator::convertType(Type& ast_type) {
         llvm::Type* element_type = convertType(*array->element_type);
         if (!element_type) return nullptr;
         
-        // For now, treat arrays as pointers
-        return element_type->getPointerTo();
+        return llvm::ArrayType::get(element_type, array->size);
     } else if (auto pointer = dynamic_cast<PointerType*>(&ast_type)) {
         llvm::Type* pointee_type = convertType(*pointer->pointee_type);
         if (!pointee_type) return nullptr;
@@ -1207,89 +1813,102 @@ llvm::Type* LLVMCodeGenerator::getPrimitiveType(TokenType token_type) {
     }
 }
 
-llvm::Value* LLVMCodeGenerator::getExpressionValue(Expression& expr) {
-    // Check if we already stored a value for this expression
-    auto it = expression_cache.find(&expr);
-    if (it != expression_cache.end())
-        return it->second;
+llvm::Type* LLVMCodeGenerator::convertSemanticType(const SemanticType& type) {
+    switch (type.kind) {
+        case SemanticType::Kind::PRIMITIVE: {
+            static const std::unordered_map<std::string, TokenType> primitive_tokens = {
+                {"i8", TokenType::I8}, {"i16", TokenType::I16}, {"i32", TokenType::I32}, {"i64", TokenType::I64},
+                {"u8", TokenType::U8}, {"u16", TokenType::U16}, {"u32", TokenType::U32}, {"u64", TokenType::U64},
+                {"f32", TokenType::F32}, {"f64", TokenType::F64}, {"bool", TokenType::BOOL}, {"string", TokenType::STRING}
+            };
+            auto it = primitive_tokens.find(type.name);
+            return it != primitive_tokens.end() ? getPrimitiveType(it->second) : nullptr;
+        }
 
-    return nullptr;
+        case SemanticType::Kind::VOID_TYPE:
+            return llvm::Type::getVoidTy(*context);
+
+        case SemanticType::Kind::ARRAY: {
+            llvm::Type* element_type = type.element_type ? convertSemanticType(*type.element_type) : nullptr;
+            return element_type ? llvm::ArrayType::get(element_type, type.length) : nullptr;
+        }
+
+        case SemanticType::Kind::POINTER: {
+            llvm::Type* element_type = type.element_type ? convertSemanticType(*type.element_type) : nullptr;
+            if (!element_type || element_type->isVoidTy()) {
+                element_type = llvm::Type::getInt8Ty(*context);
+            }
+            return element_type->getPointerTo();
+        }
+
+        default:
+            return nullptr;
+    }
+}
+
+llvm::Value* LLVMCodeGenerator::getExpressionValue(Expression& expr) {
+    // Slots stamped by another generator belong to a different compilation
+    if (expr.value_pass != pass_id) {
+        return nullptr;
+    }
+    return expression_values[expr.value_slot];
 }
 
 void LLVMCodeGenerator::setExpressionValue(Expression& expr, llvm::Value* value) {
-    expression_cache[&expr] = value;
+    if (expr.value_pass != pass_id) {
+        expr.value_pass = pass_id;
+        expr.value_slot = static_cast<uint32_t>(expression_values.size());
+        expression_values.push_back(value);
+        return;
+    }
+    expression_values[expr.value_slot] = value;
 }
 
 // ===== NEW VARIABLE MANAGEMENT METHODS =====
 
 // Note: VariableInfo is defined inside the LLVMCodeGenerator class
 // Use full qualification in implementation
-LLVMCodeGenerator::VariableInfo* LLVMCodeGenerator::declareVariable(const std::string& name, VariableInfo&& info) {
-    // For local variables (function context), register in local scope
-    if (current_function && !info.is_global) {
-        if (!local_scopes.empty()) {
-            auto& current_scope = local_scopes.back();
-            auto result = current_scope.emplace(name, nullptr);
-            if (result.second) { // If inserted successfully (first time)
-                // Store the actual info in a scoped location within the global symbol table
-                std::string scoped_name = std::string("__local_") + std::to_string(reinterpret_cast<uintptr_t>(current_function)) + "_" + name;
-                auto global_result = symbol_table.emplace(scoped_name, std::move(info));
-                result.first->second = &global_result.first->second;
-                return &global_result.first->second;
-            }
-        }
+LLVMCodeGenerator::VariableInfo* LLVMCodeGenerator::declareVariable(SymbolId id, VariableInfo&& info) {
+    // Redefinitions are left unbound by NameResolver
+    if (id == NO_SYMBOL) {
+        return nullptr;
     }
 
-    // Global variables go directly in symbol table
-    auto result = symbol_table.emplace(name, std::move(info));
-    return &result.first->second;
-}
-
-LLVMCodeGenerator::VariableInfo* LLVMCodeGenerator::lookupVariable(const std::string& name) {
-    // First check current scope
-    if (!local_scopes.empty()) {
-        for (auto scope_it = local_scopes.rbegin(); scope_it != local_scopes.rend(); ++scope_it) {
-            auto it = scope_it->find(name);
-            if (it != scope_it->end()) {
-                return it->second;
-            }
-        }
+    if (id >= variables.size()) {
+        variables.resize(id + 1);
     }
-
-    // Then check global symbol table
-    auto it = symbol_table.find(name);
-    if (it != symbol_table.end()) {
-        return &it->second;
+    if (!variables[id].value) {
+        bound_declarations++;
     }
-
-    return nullptr;
-}
-
-const LLVMCodeGenerator::VariableInfo* LLVMCodeGenerator::lookupVariable(const std::string& name) const {
-    return const_cast<LLVMCodeGenerator*>(this)->lookupVariable(name);
+    variables[id] = std::move(info);
+    return &variables[id];
 }
 
-bool LLVMCodeGenerator::hasVariable(const std::string& name) const {
-    return lookupVariable(name) != nullptr;
+LLVMCodeGenerator::VariableInfo* LLVMCodeGenerator::lookupVariable(SymbolId id) {
+    // Unresolved names, and declarations not generated yet, have no value
+    if (id >= variables.size() || !variables[id].value) {
+        return nullptr;
+    }
+    return &variables[id];
 }
 
-void LLVMCodeGenerator::enterScope() {
-    local_scopes.emplace_back();
+const LLVMCodeGenerator::VariableInfo* LLVMCodeGenerator::lookupVariable(SymbolId id) const {
+    return const_cast<LLVMCodeGenerator*>(this)->lookupVariable(id);
 }
 
-void LLVMCodeGenerator::exitScope() {
-    if (!local_scopes.empty()) {
-        local_scopes.pop_back();
-    }
+void LLVMCodeGenerator::declareTypePlaceholder(SymbolId id, const SourceLocation& location) {
+    // Type names used as values (constructor calls) evaluate to a placeholder;
+    // the actual instantiation logic will be handled in CallExpression
+    llvm::Value* type_placeholder = llvm::ConstantPointerNull::get(
+        llvm::PointerType::get(llvm::Type::getInt8Ty(*context), 0));
+    declareVariable(id, VariableInfo(type_placeholder, true, location, false, true));
 }
 
 void LLVMCodeGenerator::enterFunctionScope(llvm::Function* function) {
     current_function = function;
-    enterScope();
 }
 
 void LLVMCodeGenerator::exitFunctionScope() {
-    exitScope();
     current_function = nullptr;
 }
 
@@ -1320,25 +1939,31 @@ llvm::Value* LLVMCodeGenerator::resolveInitializerValue(llvm::Value* initializer
     return initializer_val;
 }
 
-llvm::AllocaInst* LLVMCodeGenerator::createLocalVariable(const std::string& name, llvm::Type* type, const SourceLocation& location) {
+llvm::AllocaInst* LLVMCodeGenerator::createEntryBlockAlloca(llvm::Type* type, const std::string& name) {
+    llvm::IRBuilder<> entry_builder(alloca_insert_point);
+    entry_allocas++;
+    return entry_builder.CreateAlloca(type, nullptr, name);
+}
+
+llvm::AllocaInst* LLVMCodeGenerator::createLocalVariable(SymbolId id, const std::string& name, llvm::Type* type, const SourceLocation& location) {
     if (!current_function) {
         reportCodegenError(location, "Cannot create local variable outside of function context: " + name);
         return nullptr;
     }
 
-    llvm::AllocaInst* alloca = builder->CreateAlloca(type, nullptr, name);
+    llvm::AllocaInst* alloca = createEntryBlockAlloca(type, name);
     VariableInfo info(alloca, false, location, false, false);
-    declareVariable(name, std::move(info));
+    declareVariable(id, std::move(info));
     return alloca;
 }
 
-llvm::GlobalVariable* LLVMCodeGenerator::createGlobalVariable(const std::string& name, llvm::Type* type,
+llvm::GlobalVariable* LLVMCodeGenerator::createGlobalVariable(SymbolId id, const std::string& name, llvm::Type* type,
                                                              llvm::Constant* initializer, bool is_const,
                                                              bool is_exported, const SourceLocation& location) {
     auto linkage = is_exported ? llvm::GlobalValue::ExternalLinkage : llvm::GlobalValue::InternalLinkage;
     auto* global_var = new llvm::GlobalVariable(*module, type, is_const, linkage, initializer, name);
     VariableInfo info(global_var, is_const, location, is_exported, true);
-    declareVariable(name, std::move(info));
+    declareVariable(id, std::move(info));
     return global_var;
 }
 
@@ -1444,40 +2069,341 @@ llvm::Value* LLVMCodeGenerator::generateComparisonOperation(TokenType op,
     return nullptr;
 }
 
-llvm::Value* LLVMCodeGenerator::generateBooleanOperation(TokenType op,
-                                                        llvm::Value* left_val,
-                                                        llvm::Value* right_val) {
-    llvm::Type* left_type = left_val->getType();
+void LLVMCodeGenerator::generateShortCircuit(BinaryExpression& node) {
+    const bool is_and = node.operator_token == TokenType::LOGICAL_AND;
 
-    // Handle boolean operations (i1 type)
-    if (left_type->isIntegerTy(1)) {
-        switch (op) {
-            case TokenType::LOGICAL_AND:
-                return builder->CreateAnd(left_val, right_val, "andtmp");
-            case TokenType::LOGICAL_OR:
-                return builder->CreateOr(left_val, right_val, "ortmp");
-            default:
-                return nullptr;
+    node.left->accept(*this);
+    llvm::Value* left_val = getExpressionValue(*node.left);
+    if (!left_val) {
+        reportCodegenError(node.location, "Invalid operands for binary expression");
+        return;
+    }
+    llvm::Value* left_bool = evaluateCondition(left_val);
+
+    // A right operand that is cheap and cannot trap is evaluated unconditionally, saving a branch
+    unsigned budget = max_speculated_operand_nodes;
+    if (isCheapAndSideEffectFree(*node.right, budget)) {
+        node.right->accept(*this);
+        llvm::Value* right_val = getExpressionValue(*node.right);
+        if (!right_val) {
+            reportCodegenError(node.location, "Invalid operands for binary expression");
+            return;
         }
+        llvm::Value* right_bool = evaluateCondition(right_val);
+
+        llvm::Value* result = is_and ? builder->CreateSelect(left_bool, right_bool, builder->getFalse(), "andtmp")
+                                     : builder->CreateSelect(left_bool, builder->getTrue(), right_bool, "ortmp");
+        selected_logical_operators++;
+        setExpressionValue(node, result);
+        return;
     }
-    // Handle logical operations on non-boolean integers (treat non-zero as true)
-    else if (left_type->isIntegerTy()) {
-        // Convert integers to boolean (non-zero = true, zero = false)
-        llvm::Value* left_bool = builder->CreateICmpNE(left_val,
-            llvm::ConstantInt::get(left_type, 0), "left_bool");
-        llvm::Value* right_bool = builder->CreateICmpNE(right_val,
-            llvm::ConstantInt::get(right_val->getType(), 0), "right_bool");
 
-        switch (op) {
-            case TokenType::LOGICAL_AND:
-                return builder->CreateAnd(left_bool, right_bool, "andtmp");
-            case TokenType::LOGICAL_OR:
-                return builder->CreateOr(left_bool, right_bool, "ortmp");
+    // Otherwise the right operand only runs when the left one does not decide the result
+    llvm::Function* function = builder->GetInsertBlock()->getParent();
+    llvm::BasicBlock* left_block = builder->GetInsertBlock();
+    llvm::BasicBlock* right_block = createBasicBlock(is_and ? "and.rhs" : "or.rhs", function);
+    llvm::BasicBlock* merge_block = createBasicBlock(is_and ? "and.end" : "or.end", function);
+
+    if (is_and) {
+        builder->CreateCondBr(left_bool, right_block, merge_block);
+    } else {
+        builder->CreateCondBr(left_bool, merge_block, right_block);
+    }
+
+    builder->SetInsertPoint(right_block);
+    node.right->accept(*this);
+    llvm::Value* right_val = getExpressionValue(*node.right);
+    if (!right_val) {
+        reportCodegenError(node.location, "Invalid operands for binary expression");
+        return;
+    }
+    llvm::Value* right_bool = evaluateCondition(right_val);
+
+    // The right operand may itself have branched
+    llvm::BasicBlock* right_end = builder->GetInsertBlock();
+    builder->CreateBr(merge_block);
+
+    builder->SetInsertPoint(merge_block);
+    llvm::PHINode* result = builder->CreatePHI(builder->getInt1Ty(), 2, is_and ? "andtmp" : "ortmp");
+    result->addIncoming(is_and ? builder->getFalse() : builder->getTrue(), left_block);
+    result->addIncoming(right_bool, right_end);
+    branched_logical_operators++;
+    setExpressionValue(node, result);
+}
+
+bool LLVMCodeGenerator::isCheapAndSideEffectFree(Expression& expr, unsigned& budget) {
+    if (budget == 0) {
+        return false;
+    }
+    budget--;
+
+    if (expr.constant_value || dynamic_cast<LiteralExpression*>(&expr) || dynamic_cast<IdentifierExpression*>(&expr)) {
+        return true;
+    }
+    if (auto unary = dynamic_cast<UnaryExpression*>(&expr)) {
+        // Dereferences may fault
+        switch (unary->operator_token) {
+            case TokenType::MINUS:
+            case TokenType::LOGICAL_NOT:
+            case TokenType::BITWISE_NOT:
+                return isCheapAndSideEffectFree(*unary->operand, budget);
             default:
-                return nullptr;
+                return false;
         }
     }
-    return nullptr;
+    if (auto binary = dynamic_cast<BinaryExpression*>(&expr)) {
+        // Division can trap, and power may be a call
+        switch (binary->operator_token) {
+            case TokenType::DIVIDE:
+            case TokenType::MODULO:
+            case TokenType::POWER:
+                return false;
+            default:
+                return isCheapAndSideEffectFree(*binary->left, budget) && isCheapAndSideEffectFree(*binary->right, budget);
+        }
+    }
+    if (auto cast = dynamic_cast<CastExpression*>(&expr)) {
+        return isCheapAndSideEffectFree(*cast->expression, budget);
+    }
+    if (auto as = dynamic_cast<AsExpression*>(&expr)) {
+        return isCheapAndSideEffectFree(*as->expression, budget);
+    }
+    return false;
+}
+
+llvm::Value* LLVMCodeGenerator::generatePower(BinaryExpression& node, llvm::Value* base, llvm::Value* exponent) {
+    PrimitiveKind base_kind = getNumericKind(*node.left, base->getType());
+    PrimitiveKind exponent_kind = getNumericKind(*node.right, exponent->getType());
+    PrimitiveKind result_kind = primitive::commonKind(base_kind, exponent_kind);
+    if (result_kind == PrimitiveKind::NONE) {
+        reportCodegenError(node.location, "Invalid operands for power operator");
+        return nullptr;
+    }
+    llvm::Value* x = convertNumeric(base, base_kind, result_kind);
+
+    std::optional<ConstantValue> constant = getFoldedValue(*node.right);
+    if (constant && primitive::isInteger(constant->kind)) {
+        if (primitive::isInteger(result_kind)) {
+            // Negative exponents are left to the helper
+            std::optional<ConstantValue> n = ConstantEvaluator::castValue(*constant, result_kind);
+            if (n && (!primitive::isSigned(result_kind) || n->integer >= 0)) {
+                return generatePowerChain(x, static_cast<uint64_t>(n->integer));
+            }
+        } else if (constant->integer >= 0 && constant->integer <= max_float_power_chain) {
+            return generatePowerChain(x, static_cast<uint64_t>(constant->integer));
+        }
+    }
+
+    power_calls++;
+    if (primitive::isFloat(result_kind)) {
+        // powi takes an i32 exponent
+        unsigned exponent_bits = primitive::bitWidth(exponent_kind);
+        if (primitive::isInteger(exponent_kind) && (primitive::isSigned(exponent_kind) ? exponent_bits <= 32 : exponent_bits < 32)) {
+            llvm::Value* n = convertNumeric(exponent, exponent_kind, PrimitiveKind::I32);
+            return builder->CreateIntrinsic(llvm::Intrinsic::powi, {x->getType(), n->getType()}, {x, n}, {}, "powi");
+        }
+        llvm::Value* y = convertNumeric(exponent, exponent_kind, result_kind);
+        return builder->CreateBinaryIntrinsic(llvm::Intrinsic::pow, x, y, {}, "pow");
+    }
+
+    llvm::Function* helper = getIntegerPowerHelper(result_kind);
+    llvm::CallInst* call = builder->CreateCall(helper, {x, convertNumeric(exponent, exponent_kind, result_kind)}, "ipow");
+    call->setCallingConv(helper->getCallingConv());
+    return call;
+}
+
+llvm::Value* LLVMCodeGenerator::generatePowerChain(llvm::Value* base, uint64_t exponent) {
+    llvm::Type* type = base->getType();
+    if (exponent == 0) {
+        return type->isFloatingPointTy() ? llvm::ConstantFP::get(type, 1.0) : llvm::ConstantInt::get(type, 1);
+    }
+    power_chains++;
+
+    auto multiply = [&](llvm::Value* a, llvm::Value* b) {
+        return type->isFloatingPointTy() ? builder->CreateFMul(a, b, "powmul") : builder->CreateMul(a, b, "powmul");
+    };
+
+    // Square-and-multiply from the leading bit down: x**5 is (x*x)*(x*x)*x
+    llvm::Value* result = base;
+    for (int bit = static_cast<int>(llvm::Log2_64(exponent)) - 1; bit >= 0; --bit) {
+        result = multiply(result, result);
+        if ((exponent >> bit) & 1) {
+            result = multiply(result, base);
+        }
+    }
+    return result;
+}
+
+llvm::Function* LLVMCodeGenerator::getIntegerPowerHelper(PrimitiveKind kind) {
+    std::string name = "pangea.ipow." + std::string(primitive::name(kind));
+    if (llvm::Function* existing = module->getFunction(name)) {
+        return existing;
+    }
+
+    llvm::Type* type = getPrimitiveLLVMType(kind);
+    unsigned width = primitive::bitWidth(kind);
+    auto function = llvm::Function::Create(llvm::FunctionType::get(type, {type, type}, false),
+                                           llvm::Function::InternalLinkage, name, module.get());
+    function->setCallingConv(llvm::CallingConv::Fast);
+    function->setDoesNotThrow();
+    function->setDoesNotAccessMemory();
+    function->setWillReturn();
+    function->addFnAttr(llvm::Attribute::Speculatable);
+
+    llvm::IRBuilderBase::InsertPointGuard guard(*builder);
+    llvm::Argument* base = function->getArg(0);
+    llvm::Argument* exponent = function->getArg(1);
+    base->setName("base");
+    exponent->setName("exponent");
+
+    llvm::BasicBlock* entry = llvm::BasicBlock::Create(*context, "entry", function);
+    llvm::BasicBlock* loop = llvm::BasicBlock::Create(*context, "loop", function);
+    llvm::BasicBlock* done = llvm::BasicBlock::Create(*context, "done", function);
+    builder->SetInsertPoint(entry);
+    builder->CreateBr(loop);
+
+    // One step per exponent bit, whatever the exponent, so the only branch is the
+    // fixed-count back edge: the result takes base**(2**i) when bit i is set
+    builder->SetInsertPoint(loop);
+    llvm::PHINode* step = builder->CreatePHI(type, 2, "step");
+    llvm::PHINode* result = builder->CreatePHI(type, 2, "result");
+    llvm::PHINode* square = builder->CreatePHI(type, 2, "square");
+    llvm::PHINode* bits = builder->CreatePHI(type, 2, "bits");
+    llvm::Value* bit_set = builder->CreateTrunc(bits, llvm::Type::getInt1Ty(*context), "bitset");
+    llvm::Value* product = builder->CreateMul(result, square, "product");
+    llvm::Value* next_result = builder->CreateSelect(bit_set, product, result, "nextresult");
+    llvm::Value* next_square = builder->CreateMul(square, square, "nextsquare");
+    llvm::Value* next_bits = builder->CreateLShr(bits, 1, "nextbits");
+    llvm::Value* next_step = builder->CreateAdd(step, llvm::ConstantInt::get(type, 1), "nextstep", true, true);
+    builder->CreateCondBr(builder->CreateICmpEQ(next_step, llvm::ConstantInt::get(type, width), "lastbit"), done, loop);
+
+    step->addIncoming(llvm::ConstantInt::get(type, 0), entry);
+    step->addIncoming(next_step, loop);
+    result->addIncoming(llvm::ConstantInt::get(type, 1), entry);
+    result->addIncoming(next_result, loop);
+    square->addIncoming(base, entry);
+    square->addIncoming(next_square, loop);
+    bits->addIncoming(exponent, entry);
+    bits->addIncoming(next_bits, loop);
+
+    // A negative exponent truncates 1 / base**-n to 0 unless |base| is 1, where the
+    // bits of the exponent already give the right sign; 0 ** -n is 0 rather than a trap
+    builder->SetInsertPoint(done);
+    llvm::Value* power = next_result;
+    if (primitive::isSigned(kind)) {
+        llvm::Value* negative = builder->CreateICmpSLT(exponent, llvm::ConstantInt::get(type, 0), "negative");
+        llvm::Value* shifted = builder->CreateAdd(base, llvm::ConstantInt::get(type, 1), "shifted");
+        llvm::Value* large = builder->CreateICmpUGT(shifted, llvm::ConstantInt::get(type, 2), "large");
+        power = builder->CreateSelect(builder->CreateAnd(negative, large), llvm::ConstantInt::get(type, 0), power, "power");
+    }
+    builder->CreateRet(power);
+    return function;
+}
+
+llvm::MDNode* LLVMCodeGenerator::createLoopMetadata(llvm::ArrayRef<llvm::Metadata*> properties) {
+    // A loop ID is a distinct node whose first operand is itself
+    llvm::SmallVector<llvm::Metadata*, 4> operands = {nullptr};
+    operands.append(properties.begin(), properties.end());
+    llvm::MDNode* loop_id = llvm::MDNode::getDistinct(*context, operands);
+    loop_id->replaceOperandWith(0, loop_id);
+    return loop_id;
+}
+
+std::vector<llvm::Metadata*> LLVMCodeGenerator::getLoopHintProperties(const std::vector<Attribute>& attributes) {
+    std::vector<llvm::Metadata*> properties;
+    if (attributes.empty()) {
+        return properties;
+    }
+
+    auto property = [&](const char* name, llvm::Constant* value) {
+        properties.push_back(llvm::MDNode::get(*context, {llvm::MDString::get(*context, name), llvm::ConstantAsMetadata::get(value)}));
+    };
+
+    // The checker validated the arguments; these are the properties clang's loop pragmas produce
+    AnnotatedLoop loop{attributes.front().location, "", false, false};
+    for (const auto& attribute : attributes) {
+        std::optional<uint64_t> count = attribute.arguments.empty() ? std::nullopt : attribute.arguments[0].integerValue();
+        if (attribute.name == "vectorize") {
+            property("llvm.loop.vectorize.enable", builder->getTrue());
+            if (count) {
+                property("llvm.loop.vectorize.width", builder->getInt32(static_cast<uint32_t>(*count)));
+            }
+            loop.wants_vectorize = true;
+        } else if (attribute.name == "no_vectorize") {
+            property("llvm.loop.vectorize.width", builder->getInt32(1));
+        } else if (attribute.name == "interleave") {
+            property("llvm.loop.interleave.count", builder->getInt32(static_cast<uint32_t>(count.value_or(1))));
+            loop.wants_vectorize = true;
+        } else if (attribute.name == "unroll") {
+            if (attribute.arguments.empty()) {
+                properties.push_back(llvm::MDNode::get(*context, llvm::MDString::get(*context, "llvm.loop.unroll.enable")));
+                loop.wants_unroll = true;
+            } else if (!count) {
+                properties.push_back(llvm::MDNode::get(*context, llvm::MDString::get(*context, "llvm.loop.unroll.full")));
+                loop.wants_unroll = true;
+            } else if (*count == 1) {
+                properties.push_back(llvm::MDNode::get(*context, llvm::MDString::get(*context, "llvm.loop.unroll.disable")));
+            } else {
+                property("llvm.loop.unroll.count", builder->getInt32(static_cast<uint32_t>(*count)));
+                loop.wants_unroll = true;
+            }
+        }
+        loop.hints += (loop.hints.empty() ? "" : " ") + attribute.toString();
+    }
+
+    property(LoopRemarkCollector::loop_tag, builder->getInt32(static_cast<uint32_t>(annotated_loops.size())));
+    annotated_loops.push_back(std::move(loop));
+    return properties;
+}
+
+void LLVMCodeGenerator::reportLoopRemarks(const std::vector<LoopRemarkCollector::Remark>& remarks) {
+    if (!error_reporter) {
+        return;
+    }
+
+    // One warning per loop whose requested transformation was missed, explained by the
+    // vectorizer's analysis when there is one; remarks about transformations nobody asked
+    // for (the vectorizer reports on every loop it skips) are ignored
+    for (size_t i = 0; i < annotated_loops.size(); ++i) {
+        const AnnotatedLoop& loop = annotated_loops[i];
+        auto requested = [&](const LoopRemarkCollector::Remark& remark) {
+            return remark.loop == i && ((remark.pass == "loop-vectorize" && loop.wants_vectorize) ||
+                                        (remark.pass == "loop-unroll" && loop.wants_unroll) ||
+                                        remark.pass == "transform-warning");
+        };
+
+        const LoopRemarkCollector::Remark* failure = nullptr;
+        const LoopRemarkCollector::Remark* reason = nullptr;
+        for (const auto& remark : remarks) {
+            if (!requested(remark)) {
+                continue;
+            }
+            if (remark.is_failure && !failure) {
+                failure = &remark;
+            } else if (!remark.is_failure && !reason) {
+                reason = &remark;
+            }
+        }
+
+        if (failure) {
+            error_reporter->reportWarning(loop.location, "Loop hints " + loop.hints + " not honoured: " +
+                                          (reason ? reason->message : failure->message));
+        }
+    }
+}
+
+llvm::MDNode* LLVMCodeGenerator::getBranchWeights(BranchHint hint) {
+    // The weights llvm.expect is lowered to
+    switch (hint) {
+        case BranchHint::LIKELY:
+            hinted_branches++;
+            return llvm::MDBuilder(*context).createBranchWeights(2000, 1);
+        case BranchHint::UNLIKELY:
+            hinted_branches++;
+            return llvm::MDBuilder(*context).createBranchWeights(1, 2000);
+        default:
+            return nullptr;
+    }
 }
 
 llvm::Value* LLVMCodeGenerator::evaluateCondition(llvm::Value* condition_val) {
@@ -1497,8 +2423,17 @@ void LLVMCodeGenerator::reportCodegenError(const SourceLocation& location, const
     }
 }
 
-llvm::Function* LLVMCodeGenerator::createFunction(const std::string& name, llvm::FunctionType* func_type) {
-    llvm::Function* function = llvm::Function::Create(func_type, llvm::Function::ExternalLinkage, name, module.get());
+llvm::Function* LLVMCodeGenerator::createFunction(const std::string& name, llvm::FunctionType* func_type, bool is_exported) {
+    auto linkage = is_exported ? llvm::Function::ExternalLinkage : llvm::Function::InternalLinkage;
+    llvm::Function* function = llvm::Function::Create(func_type, linkage, name, module.get());
+
+    // Every caller of an internal function is in this module, so it need not follow the C ABI
+    if (!is_exported) {
+        internal_functions++;
+        if (!func_type->isVarArg()) {
+            function->setCallingConv(llvm::CallingConv::Fast);
+        }
+    }
     return function;
 }
 
@@ -1507,25 +2442,86 @@ llvm::BasicBlock* LLVMCodeGenerator::createBasicBlock(const std::string& name, l
     return llvm::BasicBlock::Create(*context, name, func);
 }
 
-bool LLVMCodeGenerator::isTypeIdentifier(const std::string& name) {
-    // Check if this identifier represents a type (class, struct, enum)
-    // This is a simple heuristic - in a full implementation, we'd maintain
-    // a proper symbol table with type information from semantic analysis
-    
-    // Common type naming patterns (typically start with uppercase)
-    if (!name.empty() && std::isupper(name[0])) {
-        return true;
+void LLVMCodeGenerator::applySourceAttributes(llvm::Function* function, const FunctionDeclaration& node) {
+    // TypeChecker already rejected unknown and conflicting attributes
+    for (const auto& attribute : node.attributes) {
+        if (attribute.name == "inline") {
+            function->addFnAttr(llvm::Attribute::AlwaysInline);
+        } else if (attribute.name == "noinline") {
+            function->addFnAttr(llvm::Attribute::NoInline);
+        } else if (attribute.name == "cold") {
+            function->addFnAttr(llvm::Attribute::Cold);
+        } else if (attribute.name == "hot") {
+            function->addFnAttr(llvm::Attribute::Hot);
+        } else if (attribute.name == "pure") {
+            // Reads at most, and always returns: calls with the same arguments can be merged or dropped
+            function->setOnlyReadsMemory();
+            function->setWillReturn();
+            if (node.body) {
+                pure_functions.emplace_back(function, &node);
+            }
+        } else {
+            continue;
+        }
+        source_attributes++;
     }
-    
-    // Known built-in type names that might not follow the uppercase convention
-    static const std::unordered_set<std::string> builtin_types{
-        "i8", "i16", "i32", "i64",
-        "u8", "u16", "u32", "u64", 
-        "f32", "f64",
-        "bool", "string", "void"
-    };
-    
-    return builtin_types.find(name) != builtin_types.end();
+}
+
+void LLVMCodeGenerator::applyParameterAttributes(llvm::Function* function, const FunctionDeclaration& node) {
+    // Storage for an array result comes first; nothing else can reach it during the call
+    unsigned first_parameter = 0;
+    llvm::Type* return_type = convertType(*node.return_type);
+    if (return_type && return_type->isArrayTy()) {
+        function->addParamAttr(0, llvm::Attribute::getWithStructRetType(*context, return_type));
+        function->addParamAttr(0, llvm::Attribute::NoAlias);
+        first_parameter = 1;
+    }
+
+    // raw_va_list parameters have no LLVM argument
+    for (unsigned i = 0; i < node.parameters.size() && i + first_parameter < function->arg_size(); ++i) {
+        unsigned arg = i + first_parameter;
+        const Type* type = node.parameters[i].type.get();
+        if (auto const_type = dynamic_cast<const ConstType*>(type)) {
+            type = const_type->base_type.get();
+        }
+        if (dynamic_cast<const ArrayType*>(type)) {
+            function->addParamAttr(arg, llvm::Attribute::getWithByValType(*context, convertType(*node.parameters[i].type)));
+            continue;
+        }
+        auto pointer = dynamic_cast<const PointerType*>(type);
+        if (!pointer || pointer->pointer_kind != TokenType::CPTR) {
+            continue;
+        }
+
+        if (pointer->is_restrict) {
+            function->addParamAttr(arg, llvm::Attribute::NoAlias);
+            noalias_parameters++;
+        }
+
+        if (pointer->length > 0) {
+            // Lengths of cptr<void, N> count bytes
+            llvm::Type* element_type = convertType(*pointer->pointee_type);
+            uint64_t element_size = element_type && element_type->isSized()
+                ? module->getDataLayout().getTypeAllocSize(element_type).getFixedValue()
+                : 1;
+            function->addParamAttr(arg, llvm::Attribute::NonNull);
+            function->addDereferenceableParamAttr(arg, pointer->length * element_size);
+            dereferenceable_parameters++;
+        }
+    }
+}
+
+void LLVMCodeGenerator::inferFunctionAttributes() {
+    attribute_inference.run(*module);
+
+    // @pure is trusted by callers, so say when the body contradicts it
+    for (const auto& [function, node] : pure_functions) {
+        if (attribute_inference.getInferredAccess(*function) == FunctionAttributeInference::MemoryAccess::WRITE && error_reporter) {
+            error_reporter->reportWarning(node->location, "Function '" + node->name +
+                                          "' is marked @pure but may write memory or call functions that do");
+        }
+    }
+    pure_functions.clear();
 }
 
 bool LLVMCodeGenerator::isRawVaListType(const Type& type) {
@@ -1563,100 +2559,127 @@ bool LLVMCodeGenerator::isNumericType(llvm::Type* type) {
     return type->isIntegerTy() || type->isFloatingPointTy();
 }
 
-int LLVMCodeGenerator::getNumericTypeRank(llvm::Type* type) {
-    // Numeric promotion rank (higher = wider type)
+PrimitiveKind LLVMCodeGenerator::getNumericKind(const Expression& expr, llvm::Type* type) {
+    // The checker's type carries signedness; trust it as long as it describes this value
+    if (expr.resolved_type) {
+        PrimitiveKind kind = expr.resolved_type->primitive_kind;
+        if (primitive::isNumeric(kind) && getPrimitiveLLVMType(kind) == type) {
+            return kind;
+        }
+    }
+
     if (type->isIntegerTy()) {
-        unsigned bits = type->getIntegerBitWidth();
-        switch (bits) {
-            case 1: return 0;  // bool
-            case 8: return 1;  // i8/u8
-            case 16: return 2; // i16/u16
-            case 32: return 3; // i32/u32
-            case 64: return 4; // i64/u64
-            default: return 3; // default to i32 rank
+        switch (type->getIntegerBitWidth()) {
+            case 8: return PrimitiveKind::I8;
+            case 16: return PrimitiveKind::I16;
+            case 32: return PrimitiveKind::I32;
+            case 64: return PrimitiveKind::I64;
+            default: return PrimitiveKind::NONE;
         }
     } else if (type->isFloatTy()) {
-        return 5; // f32
+        return PrimitiveKind::F32;
     } else if (type->isDoubleTy()) {
-        return 6; // f64
+        return PrimitiveKind::F64;
+    }
+    return PrimitiveKind::NONE;
+}
+
+llvm::Type* LLVMCodeGenerator::getPrimitiveLLVMType(PrimitiveKind kind) {
+    if (primitive::isFloat(kind)) {
+        return kind == PrimitiveKind::F64 ? llvm::Type::getDoubleTy(*context) : llvm::Type::getFloatTy(*context);
+    }
+    return llvm::Type::getIntNTy(*context, primitive::bitWidth(kind));
+}
+
+llvm::Value* LLVMCodeGenerator::convertNumeric(llvm::Value* value, PrimitiveKind from, PrimitiveKind to) {
+    llvm::Type* target = getPrimitiveLLVMType(to);
+
+    switch (primitive::conversion(from, to)) {
+        case NumericConversion::IDENTITY:
+            return value;
+        case NumericConversion::SIGN_EXTEND:
+            return builder->CreateSExt(value, target, "sext");
+        case NumericConversion::ZERO_EXTEND:
+            return builder->CreateZExt(value, target, "zext");
+        case NumericConversion::TRUNCATE:
+            // Same-width integers only differ in how they are interpreted
+            return value->getType() == target ? value : builder->CreateTrunc(value, target, "trunc");
+        case NumericConversion::SIGNED_TO_FLOAT:
+            return builder->CreateSIToFP(value, target, "i2f");
+        case NumericConversion::UNSIGNED_TO_FLOAT:
+            return builder->CreateUIToFP(value, target, "u2f");
+        case NumericConversion::FLOAT_TO_SIGNED:
+            return builder->CreateFPToSI(value, target, "f2i");
+        case NumericConversion::FLOAT_TO_UNSIGNED:
+            return builder->CreateFPToUI(value, target, "f2u");
+        case NumericConversion::FLOAT_EXTEND:
+            return builder->CreateFPExt(value, target, "fpext");
+        case NumericConversion::FLOAT_TRUNCATE:
+            return builder->CreateFPTrunc(value, target, "fptrunc");
+        case NumericConversion::ILLEGAL:
+            break;
     }
-    return 0;
+    return nullptr;
 }
 
-llvm::Type* LLVMCodeGenerator::getCommonNumericType(llvm::Type* left, llvm::Type* right) {
-    // Return the common type for arithmetic operations (usual arithmetic conversions)
-    if (!isNumericType(left) || !isNumericType(right)) {
-        return nullptr; // Not numeric types
+std::pair<llvm::Value*, llvm::Value*> LLVMCodeGenerator::promoteToCommonType(llvm::Value* left, PrimitiveKind left_kind,
+                                                                             llvm::Value* right, PrimitiveKind right_kind) {
+    // Usual arithmetic conversions, shared with the type checker
+    PrimitiveKind common_kind = primitive::commonKind(left_kind, right_kind);
+    if (common_kind == PrimitiveKind::NONE) {
+        return {nullptr, nullptr};
     }
-    
-    // If either is floating point, promote to the wider floating point type
-    if (left->isFloatingPointTy() || right->isFloatingPointTy()) {
-        if (left->isDoubleTy() || right->isDoubleTy()) {
-            return llvm::Type::getDoubleTy(*context); // f64
-        }
-        return llvm::Type::getFloatTy(*context); // f32
+
+    return {convertNumeric(left, left_kind, common_kind), convertNumeric(right, right_kind, common_kind)};
+}
+
+llvm::Constant* LLVMCodeGenerator::getFoldedConstant(const ConstantValue& value) {
+    llvm::Type* type = getPrimitiveLLVMType(value.kind);
+    if (primitive::isFloat(value.kind)) {
+        return llvm::ConstantFP::get(type, value.real);
     }
-    
-    // Both are integers - promote to the wider type
-    int left_rank = getNumericTypeRank(left);
-    int right_rank = getNumericTypeRank(right);
-    
-    return (left_rank >= right_rank) ? left : right;
+    return llvm::ConstantInt::get(type, static_cast<uint64_t>(value.integer), primitive::isSigned(value.kind));
 }
 
-std::pair<llvm::Value*, llvm::Value*> LLVMCodeGenerator::promoteToCommonType(llvm::Value* left, llvm::Value* right) {
-    llvm::Type* left_type = left->getType();
-    llvm::Type* right_type = right->getType();
-    
-    // Get the common type
-    llvm::Type* common_type = getCommonNumericType(left_type, right_type);
-    if (!common_type) {
-        return {nullptr, nullptr};
+llvm::Constant* LLVMCodeGenerator::getFoldedArray(const ConstantArray& array) {
+    std::vector<llvm::Constant*> elements;
+    elements.reserve(array.elements.size());
+    for (const ConstantValue& element : array.elements) {
+        elements.push_back(getFoldedConstant(element));
     }
-    
-    // Convert left operand if needed
-    llvm::Value* promoted_left = left;
-    if (left_type != common_type) {
-        if (left_type->isIntegerTy() && common_type->isFloatingPointTy()) {
-            // Integer to float
-            promoted_left = builder->CreateSIToFP(left, common_type, "i2f");
-        } else if (left_type->isFloatingPointTy() && common_type->isFloatingPointTy()) {
-            // Float to float (f32 to f64)
-            promoted_left = builder->CreateFPExt(left, common_type, "fpext");
-        } else if (left_type->isIntegerTy() && common_type->isIntegerTy()) {
-            // Integer to integer (widening)
-            unsigned left_bits = left_type->getIntegerBitWidth();
-            unsigned common_bits = common_type->getIntegerBitWidth();
-            if (left_bits < common_bits) {
-                promoted_left = builder->CreateSExt(left, common_type, "sext");
-            } else if (left_bits > common_bits) {
-                promoted_left = builder->CreateTrunc(left, common_type, "trunc");
-            }
-        }
+    auto *type = llvm::ArrayType::get(getPrimitiveLLVMType(array.element_kind), array.elements.size());
+    return llvm::ConstantArray::get(type, elements);
+}
+
+llvm::GlobalVariable* LLVMCodeGenerator::getFoldedArrayGlobal(const ConstantArray& array) {
+    llvm::GlobalVariable*& global = folded_arrays[&array];
+    if (!global) {
+        llvm::Constant* table = getFoldedArray(array);
+        global = new llvm::GlobalVariable(*module, table->getType(), true, llvm::GlobalValue::PrivateLinkage,
+                                          table, "const.table");
+        global->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
     }
-    
-    // Convert right operand if needed
-    llvm::Value* promoted_right = right;
-    if (right_type != common_type) {
-        if (right_type->isIntegerTy() && common_type->isFloatingPointTy()) {
-            // Integer to float
-            promoted_right = builder->CreateSIToFP(right, common_type, "i2f");
-        } else if (right_type->isFloatingPointTy() && common_type->isFloatingPointTy()) {
-            // Float to float (f32 to f64)
-            promoted_right = builder->CreateFPExt(right, common_type, "fpext");
-        } else if (right_type->isIntegerTy() && common_type->isIntegerTy()) {
-            // Integer to integer (widening)
-            unsigned right_bits = right_type->getIntegerBitWidth();
-            unsigned common_bits = common_type->getIntegerBitWidth();
-            if (right_bits < common_bits) {
-                promoted_right = builder->CreateSExt(right, common_type, "sext");
-            } else if (right_bits > common_bits) {
-                promoted_right = builder->CreateTrunc(right, common_type, "trunc");
-            }
-        }
+    return global;
+}
+
+bool LLVMCodeGenerator::emitFoldedConstant(Expression& node) {
+    if (!node.constant_value) {
+        return false;
     }
-    
-    return {promoted_left, promoted_right};
+
+    setExpressionValue(node, getFoldedConstant(*node.constant_value));
+    folded_constants++;
+    return true;
+}
+
+std::optional<ConstantValue> LLVMCodeGenerator::getFoldedValue(const Expression& expr) {
+    if (expr.constant_value) {
+        return *expr.constant_value;
+    }
+    if (auto literal = dynamic_cast<const LiteralExpression*>(&expr)) {
+        return ConstantEvaluator::literalValue(*literal);
+    }
+    return std::nullopt;
 }
 
 } // namespace pangea
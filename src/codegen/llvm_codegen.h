@@ -3,7 +3,12 @@
 
 #include "../ast/ast_visitor.h"
 #include "../ast/ast_nodes.h"
+#include "function_attributes.h"
+#include "loop_remarks.h"
+#include "../semantic/name_resolver.h"
+#include "../semantic/primitive_kind.h"
 #include "../utils/error_reporter.h"
+#include "../utils/stats.h"
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
@@ -58,31 +63,98 @@ private:
         }
     };
 
-    // Comprehensive symbol table with metadata
-    std::unordered_map<std::string, VariableInfo> symbol_table;
+    // Values bound to each declaration, indexed by the SymbolIds NameResolver assigned.
+    // Scoping was settled during name resolution, so locals need no scope stack here.
+    std::vector<VariableInfo> variables;
+    size_t bound_declarations = 0;
 
-    // Hierarchical scopes for local variables
-    std::vector<std::unordered_map<std::string, VariableInfo*>> local_scopes;
+    // Optional; when set, foreign functions and extern globals nothing refers to are not declared
+    const DeclarationTable* declarations = nullptr;
+    size_t skipped_declarations = 0;
+    size_t folded_constants = 0;
+    size_t internal_functions = 0;
+    // Read-only data for each array const fn calls folded to; identical calls share one array
+    std::unordered_map<const ConstantArray*, llvm::GlobalVariable*> folded_arrays;
 
     // Current function context
     llvm::Function* current_function = nullptr;
 
-    // Expression value cache (renamed for clarity)
-    std::unordered_map<Expression*, llvm::Value*> expression_cache;
+    // Placeholder in the entry block of the function being generated; every local's
+    // alloca goes in front of it, so none runs inside a loop and mem2reg can promote them
+    llvm::Instruction* alloca_insert_point = nullptr;
+    size_t entry_allocas = 0;
+
+    // Right operands of && and || up to this many nodes are evaluated unconditionally
+    static constexpr unsigned max_speculated_operand_nodes = 5;
+    size_t branched_logical_operators = 0;
+    size_t selected_logical_operators = 0;
+    size_t hinted_branches = 0;
+
+    // Attributes LLVM cannot see for itself, inferred once the whole module is generated
+    FunctionAttributeInference attribute_inference;
+    std::vector<std::pair<llvm::Function*, const FunctionDeclaration*>> pure_functions; // Checked against the inference
+    size_t source_attributes = 0;
+    size_t noalias_parameters = 0;
+    size_t dereferenceable_parameters = 0;
+
+    // Float powers with constant exponents up to this are multiplied out rather than calling powi
+    static constexpr int64_t max_float_power_chain = 16;
+    size_t power_chains = 0;
+    size_t power_calls = 0;
+    size_t counted_loops = 0;
+
+    // Array indexing; a check is skipped when the index is a for loop iterator whose
+    // constant range lies within the array
+    bool bounds_checks;
+    std::unordered_map<SymbolId, std::pair<int64_t, int64_t>> iterator_ranges; // Iterators of the loops being generated
+    size_t emitted_bounds_checks = 0;
+    size_t elided_bounds_checks = 0;
+
+    // Loops with @vectorize, @unroll, ... hints, indexed by the tag in their llvm.loop node;
+    // optimize() warns about the hints the optimizer could not honour
+    struct AnnotatedLoop {
+        SourceLocation location;
+        std::string hints;
+        bool wants_vectorize; // @vectorize or @interleave, which LoopVectorize carries out
+        bool wants_unroll;
+    };
+    std::vector<AnnotatedLoop> annotated_loops;
+
+    // Expression values, indexed by Expression::value_slot for expressions stamped with pass_id
+    std::vector<llvm::Value*> expression_values;
+    uint32_t pass_id;
     
 public:
-    explicit LLVMCodeGenerator(ErrorReporter* reporter, bool verbose, bool enable_builtins = true);
+    // bounds_checks: trap on array indices that are not proven in bounds
+    explicit LLVMCodeGenerator(ErrorReporter* reporter, bool verbose, bool enable_builtins = true, bool bounds_checks = false);
     ~LLVMCodeGenerator() = default;
     
-    void generateCode(Program& program);
+    /**
+     * Generate LLVM IR for a type-checked program
+     * @param program The program to lower
+     * @param declaration_table Optional NameResolver table used to skip unreferenced external declarations
+     */
+    void generateCode(Program& program, const DeclarationTable* declaration_table = nullptr);
     void emitToFile(const std::string& filename);
     void emitToString(std::string& output);
     bool verify();
 
+    /**
+     * Run LLVM's standard optimization pipeline over the generated module
+     * @param level Optimization level, 0-3 as in -O0 to -O3; 0 leaves the module untouched and warns about loop hints
+     * @param target_machine Provides the data layout and cost model the passes tune for (optional)
+     */
+    void optimize(unsigned level, llvm::TargetMachine* target_machine = nullptr);
+    void reportStatistics(CompilerStats& stats) const;
+
     // Getters for LLVM components (needed by builtins)
     llvm::LLVMContext& getContext() { return *context; }
     llvm::Module& getModule() { return *module; }
     llvm::IRBuilder<>& getBuilder() { return *builder; }
+
+    // Hand the finished module (and the context it lives in) to another owner, e.g. a JIT
+    std::unique_ptr<llvm::Module> takeModule() { return std::move(module); }
+    std::unique_ptr<llvm::LLVMContext> takeContext() { return std::move(context); }
     
 private:
     // Type visitors
@@ -129,6 +201,7 @@ private:
 private:
     llvm::Type* convertType(Type& ast_type);
     llvm::Type* getPrimitiveType(TokenType token_type);
+    llvm::Type* convertSemanticType(const SemanticType& type);
 
     llvm::Value* getExpressionValue(Expression& expr);
     void setExpressionValue(Expression& expr, llvm::Value* value);
@@ -136,14 +209,12 @@ private:
     void reportCodegenError(const SourceLocation& location, const std::string& message);
 
     // ===== NEW VARIABLE MANAGEMENT METHODS =====
-    VariableInfo* declareVariable(const std::string& name, VariableInfo&& info);
-    VariableInfo* lookupVariable(const std::string& name);
-    const VariableInfo* lookupVariable(const std::string& name) const;
-    bool hasVariable(const std::string& name) const;
-
-    // Scope management
-    void enterScope();
-    void exitScope();
+    VariableInfo* declareVariable(SymbolId id, VariableInfo&& info);
+    VariableInfo* lookupVariable(SymbolId id);
+    const VariableInfo* lookupVariable(SymbolId id) const;
+    void declareTypePlaceholder(SymbolId id, const SourceLocation& location);
+
+    // Function context
     void enterFunctionScope(llvm::Function* function);
     void exitFunctionScope();
 
@@ -152,16 +223,19 @@ private:
     llvm::Value* resolveInitializerValue(llvm::Value* initializer_val, SourceLocation location);
 
     // Variable allocation
-    llvm::AllocaInst* createLocalVariable(const std::string& name, llvm::Type* type, const SourceLocation& location);
-    llvm::GlobalVariable* createGlobalVariable(const std::string& name, llvm::Type* type,
+    llvm::AllocaInst* createEntryBlockAlloca(llvm::Type* type, const std::string& name);
+    llvm::AllocaInst* createLocalVariable(SymbolId id, const std::string& name, llvm::Type* type, const SourceLocation& location);
+    llvm::GlobalVariable* createGlobalVariable(SymbolId id, const std::string& name, llvm::Type* type,
                                              llvm::Constant* initializer, bool is_const,
                                              bool is_exported, const SourceLocation& location);
 
     // Helper functions for code generation
-    llvm::Function* createFunction(const std::string& name, llvm::FunctionType* func_type);
+    llvm::Function* createFunction(const std::string& name, llvm::FunctionType* func_type, bool is_exported);
     llvm::BasicBlock* createBasicBlock(const std::string& name, llvm::Function* func = nullptr);
-    bool isTypeIdentifier(const std::string& name);
     bool isRawVaListType(const Type& type);
+    void applySourceAttributes(llvm::Function* function, const FunctionDeclaration& node);
+    void applyParameterAttributes(llvm::Function* function, const FunctionDeclaration& node);
+    void inferFunctionAttributes();
     bool isStringLiteral(llvm::Value* value);
 
     // Binary operations helpers (DRY refactoring)
@@ -172,16 +246,51 @@ private:
     llvm::Value* generateComparisonOperation(TokenType op,
                                           llvm::Value* left_val,
                                           llvm::Value* right_val);
-    llvm::Value* generateBooleanOperation(TokenType op,
-                                        llvm::Value* left_val,
-                                        llvm::Value* right_val);
     llvm::Value* evaluateCondition(llvm::Value* condition_val);
 
+    // && and ||: a select when the right operand is cheap enough to always evaluate, else branches and a phi
+    void generateShortCircuit(BinaryExpression& node);
+    bool isCheapAndSideEffectFree(Expression& expr, unsigned& budget);
+    // !prof metadata for a likely()/unlikely() condition; nullptr without a hint
+    llvm::MDNode* getBranchWeights(BranchHint hint);
+    // A distinct llvm.loop node carrying the given properties
+    llvm::MDNode* createLoopMetadata(llvm::ArrayRef<llvm::Metadata*> properties);
+    // llvm.loop properties for a loop's attributes, tag included; empty without attributes
+    std::vector<llvm::Metadata*> getLoopHintProperties(const std::vector<Attribute>& attributes);
+    void reportLoopRemarks(const std::vector<LoopRemarkCollector::Remark>& remarks);
+
+    // x ** y: multiply chains for constant integer exponents, else llvm.powi, llvm.pow or an integer helper
+    llvm::Value* generatePower(BinaryExpression& node, llvm::Value* base, llvm::Value* exponent);
+    llvm::Value* generatePowerChain(llvm::Value* base, uint64_t exponent);
+    llvm::Function* getIntegerPowerHelper(PrimitiveKind kind);
+
+    // a[i] on an array or a cptr: the element's address and type, or nullptr after reporting an error
+    llvm::Value* generateElementAddress(IndexExpression& node, llvm::Type*& element_type);
+    void generateElementAssignment(AssignmentExpression& node, IndexExpression& target, llvm::Value* value);
+    // Where an array-typed expression lives; array values are always handled through their address
+    llvm::Value* generateArrayAddress(Expression& array);
+    void generateArrayCopy(llvm::Value* destination, llvm::Value* source, llvm::Type* type);
+    void generateArrayDeclaration(VariableDeclaration& node, llvm::Type* array_type);
+    // Reports constant indices past the end; others are checked at run time when enabled
+    void generateBoundsCheck(IndexExpression& node, llvm::Value* index, uint64_t length);
+    bool isIndexInRange(const Expression& index, uint64_t length) const;
+
     // Type conversion helpers
     bool isNumericType(llvm::Type* type);
-    std::pair<llvm::Value*, llvm::Value*> promoteToCommonType(llvm::Value* left, llvm::Value* right);
-    llvm::Type* getCommonNumericType(llvm::Type* left, llvm::Type* right);
-    int getNumericTypeRank(llvm::Type* type);
+    // Kind of a numeric operand: the checker's type when it matches the value, else derived from the LLVM type
+    PrimitiveKind getNumericKind(const Expression& expr, llvm::Type* type);
+    llvm::Type* getPrimitiveLLVMType(PrimitiveKind kind);
+    llvm::Value* convertNumeric(llvm::Value* value, PrimitiveKind from, PrimitiveKind to);
+    std::pair<llvm::Value*, llvm::Value*> promoteToCommonType(llvm::Value* left, PrimitiveKind left_kind,
+                                                              llvm::Value* right, PrimitiveKind right_kind);
+
+    // Values the ConstantEvaluator folded
+    llvm::Constant* getFoldedConstant(const ConstantValue& value);
+    llvm::Constant* getFoldedArray(const ConstantArray& array);
+    llvm::GlobalVariable* getFoldedArrayGlobal(const ConstantArray& array);
+    bool emitFoldedConstant(Expression& node);
+    // The value an expression folded to, counting plain literals
+    std::optional<ConstantValue> getFoldedValue(const Expression& expr);
 };
 
 } // namespace pangea
@@ -0,0 +1,103 @@
+#include "loop_remarks.h"
+#include <llvm/IR/CFG.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Metadata.h>
+
+namespace pangea {
+
+namespace {
+
+bool isLoopPass(llvm::StringRef pass) {
+    return pass == "loop-vectorize" || pass == "loop-unroll" || pass == "transform-warning";
+}
+
+std::optional<size_t> getTag(const llvm::Instruction* terminator) {
+    llvm::MDNode* loop_id = terminator ? terminator->getMetadata(llvm::LLVMContext::MD_loop) : nullptr;
+    if (!loop_id) {
+        return std::nullopt;
+    }
+
+    // The first operand is the loop ID itself
+    for (unsigned i = 1; i < loop_id->getNumOperands(); ++i) {
+        auto property = llvm::dyn_cast<llvm::MDNode>(loop_id->getOperand(i));
+        if (!property || property->getNumOperands() != 2) {
+            continue;
+        }
+        auto name = llvm::dyn_cast<llvm::MDString>(property->getOperand(0));
+        auto index = llvm::mdconst::dyn_extract<llvm::ConstantInt>(property->getOperand(1));
+        if (name && index && name->getString() == LoopRemarkCollector::loop_tag) {
+            return index->getZExtValue();
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace
+
+bool LoopRemarkCollector::handleDiagnostics(const llvm::DiagnosticInfo& info) {
+    auto remark = llvm::dyn_cast<llvm::DiagnosticInfoIROptimization>(&info);
+    if (!remark) {
+        return false;
+    }
+
+    // The vectorizer explains failures on loops with forced hints under the pass name
+    // that makes a remark print unconditionally
+    std::string pass = remark->getPassName().str();
+    bool is_analysis = llvm::isa<llvm::OptimizationRemarkAnalysis>(remark);
+    if (is_analysis && pass == llvm::OptimizationRemarkAnalysis::AlwaysPrint) {
+        pass = "loop-vectorize";
+    }
+    if (!isLoopPass(pass)) {
+        return false;
+    }
+
+    // Loop passes describe a loop by its header, or by an instruction in its body
+    const llvm::Value* region = remark->getCodeRegion();
+    const llvm::BasicBlock* block = region ? llvm::dyn_cast<llvm::BasicBlock>(region) : nullptr;
+    if (auto instruction = region ? llvm::dyn_cast<llvm::Instruction>(region) : nullptr) {
+        block = instruction->getParent();
+    }
+
+    // Transformations that happened are of no interest
+    bool is_failure = llvm::isa<llvm::OptimizationRemarkMissed>(remark) ||
+                      llvm::isa<llvm::DiagnosticInfoOptimizationFailure>(remark);
+    std::optional<size_t> loop = block ? findLoopTag(*block) : std::nullopt;
+    if (loop && (is_failure || is_analysis)) {
+        remarks.push_back(Remark{*loop, pass, remark->getMsg(), is_failure});
+    }
+    return true;
+}
+
+bool LoopRemarkCollector::isAnalysisRemarkEnabled(llvm::StringRef pass) const {
+    return pass == "loop-vectorize";
+}
+
+bool LoopRemarkCollector::isMissedOptRemarkEnabled(llvm::StringRef pass) const {
+    return isLoopPass(pass);
+}
+
+bool LoopRemarkCollector::isPassedOptRemarkEnabled(llvm::StringRef /*pass*/) const {
+    return false;
+}
+
+bool LoopRemarkCollector::isAnyRemarkEnabled() const {
+    return true;
+}
+
+std::optional<size_t> LoopRemarkCollector::findLoopTag(const llvm::BasicBlock& block) {
+    if (std::optional<size_t> tag = getTag(block.getTerminator())) {
+        return tag;
+    }
+
+    // For a header, the latch branching back to it
+    for (const llvm::BasicBlock* predecessor : llvm::predecessors(&block)) {
+        if (std::optional<size_t> tag = getTag(predecessor->getTerminator())) {
+            return tag;
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace pangea
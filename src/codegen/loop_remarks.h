@@ -0,0 +1,48 @@
+#pragma once
+
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/DiagnosticHandler.h>
+#include <llvm/IR/DiagnosticInfo.h>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace pangea {
+
+// Collects what the optimizer says about loops that carry source hints
+// (@vectorize, @unroll, ...). Codegen tags each such loop's llvm.loop node with
+// `!{!"pangea.loop", i32 index}`; the tag survives the rewrites LoopVectorize and
+// LoopUnroll make to loop IDs, so a remark can be traced back to its loop even
+// though the IR has no debug locations. Remarks about untagged loops are dropped.
+class LoopRemarkCollector : public llvm::DiagnosticHandler {
+public:
+    static constexpr const char* loop_tag = "pangea.loop";
+
+    struct Remark {
+        size_t loop;           // Index from the loop's tag
+        std::string pass;      // loop-vectorize, loop-unroll or transform-warning
+        std::string message;
+        bool is_failure;       // A missed transformation, rather than analysis explaining one
+    };
+
+private:
+    std::vector<Remark>& remarks;
+
+public:
+    explicit LoopRemarkCollector(std::vector<Remark>& collected) : remarks(collected) {}
+
+    bool handleDiagnostics(const llvm::DiagnosticInfo& info) override;
+    bool isAnalysisRemarkEnabled(llvm::StringRef pass) const override;
+    bool isMissedOptRemarkEnabled(llvm::StringRef pass) const override;
+    bool isPassedOptRemarkEnabled(llvm::StringRef pass) const override;
+    bool isAnyRemarkEnabled() const override;
+
+    /**
+     * Find the tag of the loop a remark's code region belongs to
+     * @param block A loop header or a block of its body
+     * @return The index in the tag, if the block's own or an incoming branch carries one
+     */
+    static std::optional<size_t> findLoopTag(const llvm::BasicBlock& block);
+};
+
+} // namespace pangea
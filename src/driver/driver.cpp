@@ -0,0 +1,389 @@
+#include "driver.h"
+#include "../lexer/lexer.h"
+#include "../ast/ast_printer.h"
+#include "../semantic/constant_evaluator.h"
+#include "../semantic/name_resolver.h"
+#include "../semantic/type_checker.h"
+#include "../codegen/llvm_codegen.h"
+#include "../codegen/compile.h"
+#include "../ast/ast_statistics.h"
+#include "../utils/thread_pool.h"
+#include <charconv>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+
+namespace pangea {
+
+void printUsage(const char* program_name) {
+    std::cout << "Usage: " << program_name << " [options] <input_file>" << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  -o <file>     Specify output file (default: a.exe)" << std::endl;
+    std::cout << "  -v, --verbose Enable verbose output (show all compilation steps)" << std::endl;
+    std::cout << "  --color=MODE  Control colored output (always|auto|never, default: auto)" << std::endl;
+    std::cout << "  --llvm        Output LLVM IR instead of executable" << std::endl;
+    std::cout << "  --tokens      Print tokens and exit" << std::endl;
+    std::cout << "  --ast         Print AST and exit" << std::endl;
+    std::cout << "  --no-stdlib   Don't auto-import standard library" << std::endl;
+    std::cout << "  --no-builtins Don't auto-import builtins" << std::endl;
+    std::cout << "  -O<level>     Optimization level 0-3 (default: 0, no optimization)" << std::endl;
+    std::cout << "  --bounds-checks=MODE  Check array indices at run time (none|debug|always, default: debug, at -O0 only)" << std::endl;
+    std::cout << "  -j <N>        Use N threads for parallel phases (default: one per core, 1 = serial, at most 256)" << std::endl;
+    std::cout << "  --max-errors=N        Stop after N errors (default: 0, no limit)" << std::endl;
+    std::cout << "  --const-eval-steps=N  Steps a const fn call may take at compile time (default: 1000000)" << std::endl;
+    std::cout << "  --time-report Print wall/CPU time spent in each compiler phase" << std::endl;
+    std::cout << "  --time-trace[=FILE]   Write a Chrome trace of the compilation (default: <output>.json)" << std::endl;
+    std::cout << "  --stats       Print token/AST/symbol counts, allocations and peak memory per phase" << std::endl;
+    std::cout << "  --server[=SOCKET]     Run as a compile server keeping parsed modules and LLVM state warm" << std::endl;
+    std::cout << "  --use-server[=SOCKET] Forward this compilation to a running compile server" << std::endl;
+    std::cout << "  --help        Show this help message" << std::endl;
+}
+
+bool parseCommandLine(const std::vector<std::string>& args, CompileOptions& options, int& exit_code) {
+    exit_code = 0;
+
+    // Parse command line arguments
+    for (size_t i = 0; i < args.size(); ++i) {
+        const std::string& arg = args[i];
+
+        if (arg == "-o") {
+            i++;
+            if (i >= args.size()) {
+                std::cerr << "No output file declared." << std::endl;
+                exit_code = 1;
+                return false;
+            }
+            options.output_file = args[i];
+        } else if (arg == "-j" || (arg.starts_with("-j") && arg.size() > 2)) {
+            std::string count = arg.size() > 2 ? arg.substr(2) : (++i < args.size() ? args[i] : "");
+            unsigned long long jobs = 0;
+            auto [end, error] = std::from_chars(count.data(), count.data() + count.size(), jobs);
+            if (count.empty() || end != count.data() + count.size() ||
+                (error != std::errc() && error != std::errc::result_out_of_range)) {
+                std::cerr << "Error: -j expects a thread count" << std::endl;
+                exit_code = 1;
+                return false;
+            }
+            bool too_many = error == std::errc::result_out_of_range || jobs > CompileOptions::max_jobs;
+            options.jobs = too_many ? CompileOptions::max_jobs : static_cast<unsigned>(jobs);
+        } else if (arg.starts_with("-O") && arg.size() == 3) {
+            if (arg[2] < '0' || arg[2] > '3') {
+                std::cerr << "Error: Invalid optimization level '" << arg << "'. Use -O0, -O1, -O2 or -O3." << std::endl;
+                exit_code = 1;
+                return false;
+            }
+            options.opt_level = static_cast<unsigned>(arg[2] - '0');
+        } else if (arg.starts_with("--max-errors=")) {
+            std::string limit = arg.substr(13);
+            size_t max_errors = 0;
+            auto [end, error] = std::from_chars(limit.data(), limit.data() + limit.size(), max_errors);
+            if (limit.empty() || end != limit.data() + limit.size() ||
+                (error != std::errc() && error != std::errc::result_out_of_range)) {
+                std::cerr << "Error: --max-errors expects a number" << std::endl;
+                exit_code = 1;
+                return false;
+            }
+            // A limit too large to represent is never reached, so it behaves as the largest one
+            options.max_errors = error == std::errc::result_out_of_range ? SIZE_MAX : max_errors;
+        } else if (arg.starts_with("--const-eval-steps=")) {
+            std::string limit = arg.substr(19);
+            size_t steps = 0;
+            auto [end, error] = std::from_chars(limit.data(), limit.data() + limit.size(), steps);
+            if (limit.empty() || end != limit.data() + limit.size() ||
+                (error != std::errc() && error != std::errc::result_out_of_range)) {
+                std::cerr << "Error: --const-eval-steps expects a number" << std::endl;
+                exit_code = 1;
+                return false;
+            }
+            options.const_eval_steps = error == std::errc::result_out_of_range ? SIZE_MAX : steps;
+        } else if (arg.starts_with("--bounds-checks=")) {
+            std::optional<BoundsCheckMode> mode = parseBoundsCheckMode(arg.substr(16));
+            if (!mode) {
+                std::cerr << "Error: Invalid bounds check mode '" << arg.substr(16) << "'. Use none, debug, or always." << std::endl;
+                exit_code = 1;
+                return false;
+            }
+            options.bounds_checks = *mode;
+        } else if (arg == "--llvm") {
+            options.output_llvm = true;
+        } else if (arg == "--help") {
+            printUsage("pangea");
+            return false;
+        } else if (arg == "--tokens") {
+            options.print_tokens = true;
+        } else if (arg == "--ast") {
+            options.print_ast = true;
+        } else if (arg == "-v" || arg == "--verbose") {
+            options.verbose = true;
+        } else if (arg.starts_with("--color=")) {
+            options.color_mode = arg.substr(8);
+            if (options.color_mode != "always" && options.color_mode != "auto" && options.color_mode != "never") {
+                std::cerr << "Error: Invalid color mode '" << options.color_mode << "'. Use always, auto, or never." << std::endl;
+                exit_code = 1;
+                return false;
+            }
+        } else if (arg == "--no-stdlib") {
+            options.no_stdlib = true;
+        } else if (arg == "--no-builtins") {
+            options.no_builtins = true;
+        } else if (arg == "--stats") {
+            options.stats = true;
+        } else if (arg == "--time-report") {
+            options.time_report = true;
+        } else if (arg == "--time-trace" || arg.starts_with("--time-trace=")) {
+            options.time_trace_file = arg.size() > 13 ? arg.substr(13) : "";
+            if (options.time_trace_file.empty()) {
+                options.time_trace_file = "-"; // Resolved once the output file is known
+            }
+        } else if (arg == "--server" || arg.starts_with("--server=")) {
+            options.server_mode = true;
+            if (arg.size() > 9) options.server_socket = arg.substr(9);
+        } else if (arg == "--use-server" || arg.starts_with("--use-server=")) {
+            options.use_server = true;
+            if (arg.size() > 13) options.server_socket = arg.substr(13);
+        } else if (arg.starts_with("--")) {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            exit_code = 1;
+            return false;
+        } else {
+            options.input_file = arg;
+        }
+    }
+
+    if (options.time_trace_file == "-") {
+        options.time_trace_file = options.output_file + ".json";
+    }
+
+    if (options.input_file.empty() && !options.server_mode) {
+        std::cerr << "Error: No input file specified" << std::endl;
+        printUsage("pangea");
+        exit_code = 1;
+        return false;
+    }
+
+    return true;
+}
+
+static int runPipeline(const CompileOptions& options, ModuleCache* cache, PhaseTimer* timer, CompilerStats* stats) {
+    // Initialize error reporter with color support
+    ErrorReporter error_reporter(options.color_mode);
+    error_reporter.setMaxErrors(options.max_errors);
+
+    // Create module manager for separate compilation
+    ModuleManager module_manager(&error_reporter, options.verbose, cache, timer);
+
+    if (options.print_tokens) {
+        // Just tokenize the main file for debugging
+        std::string source = readFile(options.input_file);
+        if (source.empty()) {
+            return 1;
+        }
+
+        Lexer lexer(source, options.input_file, &error_reporter);
+        auto tokens = lexer.tokenize();
+
+        if (error_reporter.hasErrors()) {
+            error_reporter.printDiagnostics();
+            return 1;
+        }
+
+        std::cout << "Tokens:" << std::endl;
+        for (const auto& token : tokens) {
+            std::cout << token.toString() << std::endl;
+        }
+        return 0;
+    }
+
+    // Create program with separate module compilation
+
+    if (options.verbose)
+    {
+        std::cout << "[VERBOSE] Creating program: " << options.input_file << std::endl;
+    }
+
+    auto program = module_manager.createProgram(options.input_file, !options.no_stdlib, !options.no_builtins);
+
+    if (stats) {
+        module_manager.reportStatistics(*stats);
+        if (program) {
+            ASTStatistics ast_statistics;
+            ast_statistics.collect(*program);
+            stats->set("ast.total nodes", ast_statistics.getTotalNodes());
+            for (const auto& [kind, count] : ast_statistics.getNodeCounts()) {
+                stats->set("ast." + kind, count);
+            }
+        }
+    }
+
+    if (!program || error_reporter.hasErrors()) {
+        error_reporter.printDiagnostics();
+        return 1;
+    }
+
+    if (options.print_ast) {
+        std::ofstream out(options.output_file + ".ast", std::ios::out | std::ios::trunc);
+        ASTPrinter printer(out);
+        printer.printProgram(*program);
+        return 0;
+    }
+
+    if (options.verbose)
+    {
+        std::cout << "[VERBOSE] Running semantic analysis..." << std::endl;
+    }
+
+    // Name resolution
+    NameResolver name_resolver;
+
+    {
+        PhaseScope phase(timer, "resolve");
+        name_resolver.resolve(*program);
+    }
+
+    // Semantic analysis; -j 1 keeps everything on this thread. The pool's workers
+    // are joined when the pipeline returns, before runCompiler writes the time trace
+    std::unique_ptr<ThreadPool> pool;
+    if (options.jobs != 1) {
+        pool = std::make_unique<ThreadPool>(options.jobs);
+    }
+
+    TypeChecker type_checker(&error_reporter, !options.no_builtins);
+
+    {
+        PhaseScope phase(timer, "type check");
+        type_checker.analyze(*program, name_resolver.getDeclarations(), pool.get());
+    }
+
+    if (stats) {
+        name_resolver.reportStatistics(*stats);
+        type_checker.reportStatistics(*stats);
+    }
+
+    if (error_reporter.hasErrors()) {
+        error_reporter.printDiagnostics();
+        return 1;
+    }
+
+    // Constant folding over the typed AST
+    ConstantEvaluator constant_evaluator(&error_reporter, options.const_eval_steps);
+
+    {
+        PhaseScope phase(timer, "fold");
+        constant_evaluator.evaluate(*program, name_resolver.getDeclarations());
+    }
+
+    if (stats) {
+        constant_evaluator.reportStatistics(*stats);
+    }
+
+    if (options.verbose)
+    {
+        std::cout << "[VERBOSE] Generating LLVM IR..." << std::endl;
+    }
+
+    // LLVM code generation
+    LLVMCodeGenerator codegen(&error_reporter, options.verbose, !options.no_builtins,
+                              boundsChecksEnabled(options.bounds_checks, options.opt_level));
+
+    {
+        PhaseScope phase(timer, "codegen");
+        codegen.generateCode(*program, &name_resolver.getDeclarations());
+    }
+
+    if (stats) {
+        codegen.reportStatistics(*stats);
+    }
+
+    bool verified;
+    {
+        PhaseScope phase(timer, "verify");
+        verified = codegen.verify();
+    }
+    if (!verified) {
+        error_reporter.printDiagnostics();
+        return 1;
+    }
+
+    if (error_reporter.hasErrors()) {
+        error_reporter.printDiagnostics();
+        return 1;
+    }
+
+    if (options.opt_level > 0) {
+        PhaseScope phase(timer, "optimize");
+        // Without a host target the passes still run, just without its cost model
+        std::string target_error;
+        codegen.optimize(options.opt_level, Compiler::getHostTargetMachine(target_error));
+    } else {
+        // Only warns about the loop hints nothing will act on
+        codegen.optimize(0);
+    }
+
+    // Warnings of a compilation that otherwise succeeded, including loop hints the optimizer missed
+    if (error_reporter.getWarningCount() > 0) {
+        error_reporter.printDiagnostics();
+    }
+
+    if (options.verbose)
+    {
+        std::cout << "[VERBOSE] Code generation completed." << std::endl;
+        std::cout << "[VERBOSE] Emitting code to file: " << options.output_file << std::endl;
+    }
+
+    // Choose output format based on flags
+    if (options.output_llvm) {
+        // Output LLVM IR
+        PhaseScope phase(timer, "emit");
+        codegen.emitToFile(options.output_file + ".ll");
+        std::cout << "LLVM IR generated successfully: " << options.output_file << std::endl;
+    } else {
+        // Compile to executable using the new Compiler class
+        Compiler compiler(&codegen, options.verbose, nullptr, timer);
+        if (compiler.compileToExecutable(options.output_file)) {
+            std::cout << "Compiled successfully: " << options.output_file << std::endl;
+        } else {
+            return 1; // Error messages already printed by compiler
+        }
+    }
+
+    return 0;
+}
+
+int runCompiler(const CompileOptions& options, ModuleCache* cache) {
+    PhaseTimer timer;
+    CompilerStats stats;
+
+    if (!options.time_trace_file.empty()) {
+        beginTimeTrace("pangea");
+    }
+
+    int exit_code;
+    {
+        llvm::TimeTraceScope trace("Compile", options.input_file);
+        bool use_timer = options.time_report || options.stats;
+        exit_code = runPipeline(options, cache, use_timer ? &timer : nullptr, options.stats ? &stats : nullptr);
+    }
+
+    if (options.time_report) {
+        timer.printReport(std::cout);
+    }
+
+    if (options.stats) {
+        stats.printReport(std::cout);
+        timer.printMemoryReport(std::cout);
+    }
+
+    if (!options.time_trace_file.empty()) {
+        if (endTimeTrace(options.time_trace_file)) {
+            if (options.verbose) {
+                std::cout << "[VERBOSE] Time trace written to: " << options.time_trace_file << std::endl;
+            }
+        } else {
+            std::cerr << "Error: Could not write time trace: " << options.time_trace_file << std::endl;
+        }
+    }
+
+    return exit_code;
+}
+
+} // namespace pangea
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "module_manager.h"
+#include "../codegen/bounds_checks.h"
+#include <string>
+#include <vector>
+
+namespace pangea {
+
+// Options for a single compiler invocation (parsed from the command line)
+struct CompileOptions {
+    std::string input_file;
+    std::string output_file = "a.exe";
+    std::string color_mode = "auto";
+    bool print_tokens = false;
+    bool print_ast = false;
+    bool output_llvm = false;
+    bool verbose = false;
+    bool no_stdlib = false;
+    bool no_builtins = false;
+    unsigned jobs = 0;            // -j N: worker threads for parallel phases (0 = one per core)
+    static constexpr unsigned max_jobs = 256; // Larger -j values are capped; more threads only add contention
+    size_t max_errors = 0;        // --max-errors=N: stop after N errors (0 = no limit)
+    size_t const_eval_steps = 1000000; // --const-eval-steps=N: work allowed per compile-time const fn call
+    unsigned opt_level = 0;       // -O0 to -O3: LLVM optimization pipeline run before emitting
+    BoundsCheckMode bounds_checks = BoundsCheckMode::DEBUG; // --bounds-checks=MODE
+
+    // Profiling
+    bool time_report = false;     // --time-report: per-phase wall/CPU table
+    std::string time_trace_file;  // --time-trace=FILE: Chrome trace output
+    bool stats = false;           // --stats: counts, allocations and memory per phase
+
+    // Compile server
+    bool server_mode = false;     // --server: run as a daemon
+    bool use_server = false;      // --use-server: forward this compile to a daemon
+    std::string server_socket;    // empty means the default socket path
+};
+
+void printUsage(const char* program_name);
+
+/**
+ * Parse command line arguments (without the program name)
+ * @param args Arguments to parse
+ * @param options Parsed options
+ * @param exit_code Set when the invocation should stop (help, bad arguments)
+ * @return true if compilation should proceed
+ */
+bool parseCommandLine(const std::vector<std::string>& args, CompileOptions& options, int& exit_code);
+
+/**
+ * Run the full compilation pipeline for one input file
+ * @param options Parsed compile options
+ * @param cache Optional parsed-module cache shared between compilations
+ * @return Process exit code
+ */
+int runCompiler(const CompileOptions& options, ModuleCache* cache = nullptr);
+
+} // namespace pangea
@@ -0,0 +1,277 @@
+#include "module_manager.h"
+#include "../lexer/lexer.h"
+#include "../parser/parser.h"
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace pangea {
+
+std::string readFile(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file '" << filename << "'" << std::endl;
+        return "";
+    }
+
+    std::string content;
+    std::string line;
+    while (std::getline(file, line)) {
+        content += line + "\n";
+    }
+
+    return content;
+}
+
+// ModuleCache implementation
+std::shared_ptr<Module> ModuleCache::lookup(const std::string& module_path, const std::string& file_path) const {
+    // Relative paths depend on the client's working directory, so entries are keyed by the file itself
+    std::error_code ec;
+    auto canonical_path = std::filesystem::canonical(file_path, ec);
+    if (ec) {
+        return nullptr;
+    }
+
+    auto it = entries.find(canonical_path.string());
+    if (it == entries.end() || it->second.module_path != module_path || it->second.file_path != file_path) {
+        return nullptr; // The AST records the import and file paths it was parsed under
+    }
+
+    auto modified = std::filesystem::last_write_time(canonical_path, ec);
+    if (ec || modified != it->second.modified) {
+        return nullptr; // Stale - the file changed since it was parsed
+    }
+
+    return it->second.module;
+}
+
+void ModuleCache::store(const std::string& module_path, const std::string& file_path, std::shared_ptr<Module> module) {
+    std::error_code ec;
+    auto canonical_path = std::filesystem::canonical(file_path, ec);
+    if (ec) {
+        return;
+    }
+
+    auto modified = std::filesystem::last_write_time(canonical_path, ec);
+    if (ec) {
+        return;
+    }
+
+    entries[canonical_path.string()] = Entry{module_path, file_path, modified, std::move(module)};
+}
+
+// ModuleManager implementation
+void ModuleManager::reportStatistics(CompilerStats& stats) const {
+    stats.set("modules.parsed", modules_parsed);
+    stats.set("modules.reused from cache", modules_reused);
+    stats.set("lexer.tokens", tokens_lexed);
+}
+
+std::string ModuleManager::resolveModulePath(const std::string& module_path) {
+    // Try different extensions and paths
+    std::vector<std::string> candidates = {
+        module_path + ".pang",
+        module_path,
+        "stdlib/" + module_path + ".pang",
+        "stdlib/" + module_path
+    };
+
+    for (const auto& candidate : candidates) {
+        if (std::filesystem::exists(candidate)) {
+            return candidate;
+        }
+    }
+
+    return ""; // Not found
+}
+
+std::unique_ptr<Module> ModuleManager::parseModule(const std::string& source, const std::string& file_path) {
+    // Lexical analysis
+    std::vector<Token> tokens;
+    {
+        PhaseScope phase(timer, "lex", file_path);
+        Lexer lexer(source, file_path, error_reporter);
+        tokens = lexer.tokenize();
+    }
+    tokens_lexed += tokens.size();
+    modules_parsed++;
+
+    if (error_reporter->hasErrors()) {
+        return nullptr;
+    }
+
+    // Parse the module
+    std::unique_ptr<Program> program;
+    {
+        PhaseScope phase(timer, "parse", file_path);
+        Parser parser(std::move(tokens), error_reporter);
+        program = parser.parseProgram();
+    }
+
+    if (error_reporter->hasErrors()) {
+        return nullptr;
+    }
+
+    // Extract the main module from the program
+    return std::move(program->main_module);
+}
+
+bool ModuleManager::loadModule(const std::string& module_path, const SourceLocation& import_location) {
+    // Check if already loaded
+    if (loaded_modules.find(module_path) != loaded_modules.end()) {
+        return true;
+    }
+
+    // Check for circular dependencies
+    if (loading_modules.find(module_path) != loading_modules.end()) {
+        error_reporter->reportError(import_location, "Circular dependency detected for module: " + module_path);
+        return false;
+    }
+
+    // Resolve the actual file path
+    std::string file_path = resolveModulePath(module_path);
+    if (file_path.empty()) {
+        error_reporter->reportError(import_location, "Could not find module: " + module_path);
+        return false;
+    }
+
+    PhaseScope phase(timer, "module load", module_path);
+
+    // Diagnostics are ordered by file in the order modules are loaded, cached or not
+    error_reporter->registerFile(file_path);
+
+    std::shared_ptr<Module> module = module_cache ? module_cache->lookup(module_path, file_path) : nullptr;
+
+    if (module) {
+        modules_reused++;
+        if (verbose) {
+            std::cout << "Reusing cached module: " << module_path << " from " << file_path << std::endl;
+        }
+    } else {
+        if (verbose) {
+            std::cout << "Loading module: " << module_path << " from " << file_path << std::endl;
+        }
+
+        // Read and parse the module
+        std::string source;
+        {
+            PhaseScope read_phase(timer, "read", file_path);
+            source = readFile(file_path);
+        }
+        if (source.empty()) {
+            // TODO: warn if the file is empty, but still allow program to continue running
+            return false;
+        }
+
+        module = parseModule(source, file_path);
+        if (!module) {
+            return false;
+        }
+
+        module->module_name = module_path;
+        module->file_path = file_path;
+
+        if (module_cache) {
+            module_cache->store(module_path, file_path, module);
+        }
+    }
+
+    // Mark as loading
+    loading_modules.insert(module_path);
+
+    // Load dependencies first
+    bool dependencies_loaded = true;
+    for (auto& import : module->imports) {
+        dependencies_loaded &= loadModule(import->module_path, import->location);
+    }
+
+    // Mark as loaded
+    loading_modules.erase(module_path);
+
+    if (!dependencies_loaded) {
+        return false;
+    }
+
+    loaded_modules[module_path] = std::move(module);
+    load_order.push_back(module_path);
+
+    if (verbose) {
+        std::cout << "Successfully loaded module: " << module_path << std::endl;
+    }
+
+    return true;
+}
+
+std::unique_ptr<Program> ModuleManager::createProgram(const std::string& main_file, bool auto_import_stdlib, bool auto_import_builtins) {
+    // Read and parse main file
+    std::string source;
+    {
+        PhaseScope phase(timer, "read", main_file);
+        source = readFile(main_file);
+    }
+    if (source.empty()) {
+        error_reporter->reportError(SourceLocation(), "Main file is empty or could not be read: " + main_file);
+        return nullptr;
+    }
+
+    return createProgramFromSource(source, main_file, auto_import_stdlib, auto_import_builtins);
+}
+
+std::unique_ptr<Program> ModuleManager::createProgramFromSource(const std::string& source, const std::string& main_file,
+                                                                bool auto_import_stdlib, bool auto_import_builtins) {
+    auto program = std::make_unique<Program>(SourceLocation());
+
+    // Load the main module
+    std::string main_module_name = std::filesystem::path(main_file).stem().string();
+
+    error_reporter->registerFile(main_file);
+    auto main_module = parseModule(source, main_file);
+    if (!main_module) {
+        return nullptr;
+    }
+
+    // Set up the main module
+    program->main_module = std::move(main_module);
+    program->main_module->module_name = main_module_name;
+    program->main_module->file_path = main_file;
+
+    // Auto-import standard library modules if enabled
+    if (auto_import_stdlib) {
+        std::vector<std::string> stdlib_modules = {};
+
+        for (const auto& stdlib_module : stdlib_modules) {
+            if (verbose) {
+                std::cout << "Auto-importing standard library module: " << stdlib_module << std::endl;
+            }
+
+            if (loadModule(stdlib_module)) {
+                // Create an implicit import declaration for the auto-imported module
+                auto import_decl = std::make_unique<ImportDeclaration>(SourceLocation(), stdlib_module, std::vector<std::string>{}, true);
+                program->main_module->imports.push_back(std::move(import_decl));
+            }
+        }
+    }
+
+    // Load all explicitly imported modules
+    for (auto& import : program->main_module->imports) {
+        if (!loadModule(import->module_path, import->location)) {
+            error_reporter->reportError(import->location, "Failed to load module: " + import->module_path);
+            return nullptr;
+        }
+        if (verbose)
+        {
+            std::cout << "[VERBOSE] Loaded module: " << import->module_path << std::endl;
+        }
+    }
+
+    // Move all loaded modules to the program, imported modules before their importers
+    for (const auto& module_path : load_order) {
+        program->modules.push_back(std::move(loaded_modules[module_path]));
+    }
+    loaded_modules.clear();
+    load_order.clear();
+
+    return program;
+}
+
+} // namespace pangea
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "../ast/ast_nodes.h"
+#include "../utils/error_reporter.h"
+#include "../utils/timer.h"
+#include "../utils/stats.h"
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace pangea {
+
+std::string readFile(const std::string& filename);
+
+/**
+ * Parsed modules that outlive a single compilation.
+ * Used by the compile server so stdlib headers are only lexed and parsed once;
+ * entries are keyed by canonical file path and dropped as soon as the file on disk changes.
+ */
+class ModuleCache {
+private:
+    struct Entry {
+        std::string module_path;
+        std::string file_path;
+        std::filesystem::file_time_type modified;
+        std::shared_ptr<Module> module;
+    };
+
+    std::unordered_map<std::string, Entry> entries;
+
+public:
+    std::shared_ptr<Module> lookup(const std::string& module_path, const std::string& file_path) const;
+    void store(const std::string& module_path, const std::string& file_path, std::shared_ptr<Module> module);
+    void clear() { entries.clear(); }
+    size_t size() const { return entries.size(); }
+};
+
+// Module manager for handling separate compilation
+class ModuleManager {
+private:
+    std::unordered_map<std::string, std::shared_ptr<Module>> loaded_modules;
+    std::vector<std::string> load_order; // Dependencies always precede their importers
+    std::unordered_set<std::string> loading_modules; // For circular dependency detection
+    ErrorReporter* error_reporter;
+    ModuleCache* module_cache;
+    PhaseTimer* timer;
+    bool verbose;
+
+    // Statistics for --stats
+    size_t tokens_lexed = 0;
+    size_t modules_parsed = 0;
+    size_t modules_reused = 0;
+
+    std::unique_ptr<Module> parseModule(const std::string& source, const std::string& file_path);
+
+public:
+    ModuleManager(ErrorReporter* reporter, bool verbose_mode, ModuleCache* cache = nullptr, PhaseTimer* phase_timer = nullptr)
+        : error_reporter(reporter), module_cache(cache), timer(phase_timer), verbose(verbose_mode) {}
+
+    std::string resolveModulePath(const std::string& module_path);
+
+    void reportStatistics(CompilerStats& stats) const;
+
+    /**
+     * Load a module and, recursively, everything it imports
+     * @param module_path Import path as written in the source
+     * @param import_location Location of the import (for diagnostics)
+     * @return true if the module is available in the loaded set
+     */
+    bool loadModule(const std::string& module_path, const SourceLocation& import_location = SourceLocation());
+
+    std::unique_ptr<Program> createProgram(const std::string& main_file, bool auto_import_stdlib = true, bool auto_import_builtins = true);
+
+    /**
+     * Create a program whose main module comes from memory instead of a file
+     * @param source Main module source text
+     * @param main_file Name used for the main module in diagnostics
+     * @return The program, or nullptr if parsing or an import failed
+     */
+    std::unique_ptr<Program> createProgramFromSource(const std::string& source, const std::string& main_file,
+                                                     bool auto_import_stdlib = true, bool auto_import_builtins = true);
+};
+
+} // namespace pangea
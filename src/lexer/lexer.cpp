@@ -45,6 +45,7 @@ Token Lexer::nextToken() {
         case ',': return makeTokenAtPosition(TokenType::COMMA, ",", start_pos);
         case ';': return makeTokenAtPosition(TokenType::SEMICOLON, ";", start_pos);
         case '?': return makeTokenAtPosition(TokenType::QUESTION, "?", start_pos);
+        case '@': return makeTokenAtPosition(TokenType::AT, "@", start_pos);
         case '~': return makeTokenAtPosition(TokenType::BITWISE_NOT, "~", start_pos);
         case '^': return makeTokenAtPosition(TokenType::BITWISE_XOR, "^", start_pos);
         case '%':
@@ -100,6 +101,7 @@ Token Lexer::nextToken() {
             if (match(':')) return makeTokenAtPosition(TokenType::SCOPE_RESOLUTION, "::", start_pos);
             return makeTokenAtPosition(TokenType::COLON, ":", start_pos);
         case '.':
+            if (match('.')) return makeTokenAtPosition(TokenType::RANGE, "..", start_pos);
             return makeTokenAtPosition(TokenType::MEMBER_ACCESS, ".", start_pos);
     }
     
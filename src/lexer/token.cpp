@@ -82,6 +82,7 @@ const std::unordered_map<std::string, TokenType> TokenUtils::keywords = {
     // Foreign function interface
     {"foreign", TokenType::FOREIGN},
     {"cptr", TokenType::CPTR},
+    {"restrict", TokenType::RESTRICT},
     {"raw_va_list", TokenType::RAW_VA_LIST},
     {"type", TokenType::TYPE}
 };
@@ -142,6 +143,7 @@ std::string TokenUtils::tokenTypeToString(TokenType type) {
         case TokenType::TRY_CAST: return "TRY_CAST";
         case TokenType::AS: return "AS";
         case TokenType::TYPE: return "TYPE";
+        case TokenType::RESTRICT: return "RESTRICT";
         
         // Types
         case TokenType::I8: return "I8";
@@ -197,6 +199,7 @@ std::string TokenUtils::tokenTypeToString(TokenType type) {
         case TokenType::SCOPE_RESOLUTION: return "SCOPE_RESOLUTION";
         case TokenType::MEMBER_ACCESS: return "MEMBER_ACCESS";
         case TokenType::ARROW: return "ARROW";
+        case TokenType::RANGE: return "RANGE";
         
         // Punctuation
         case TokenType::LEFT_PAREN: return "LEFT_PAREN";
@@ -209,6 +212,7 @@ std::string TokenUtils::tokenTypeToString(TokenType type) {
         case TokenType::COMMA: return "COMMA";
         case TokenType::COLON: return "COLON";
         case TokenType::QUESTION: return "QUESTION";
+        case TokenType::AT: return "AT";
         
         // Special
         case TokenType::EOF_TOKEN: return "EOF";
@@ -228,4 +232,15 @@ bool TokenUtils::isKeyword(const std::string& identifier) {
     return keywords.find(identifier) != keywords.end();
 }
 
+TokenType TokenUtils::compoundAssignmentOperator(TokenType type) {
+    switch (type) {
+        case TokenType::PLUS_ASSIGN: return TokenType::PLUS;
+        case TokenType::MINUS_ASSIGN: return TokenType::MINUS;
+        case TokenType::MULTIPLY_ASSIGN: return TokenType::MULTIPLY;
+        case TokenType::DIVIDE_ASSIGN: return TokenType::DIVIDE;
+        case TokenType::MODULO_ASSIGN: return TokenType::MODULO;
+        default: return type;
+    }
+}
+
 } // namespace pangea
@@ -23,7 +23,7 @@ enum class TokenType {
     LET, MUT, CONST, TRUE, FALSE, NULL_KW, NEW, DELETE,
     THIS, SUPER, IMPL, TRAIT, SWITCH, CASE, IMPORT, EXPORT,
     MODULE, PUB, PRIV, STATIC, VIRTUAL, OVERRIDE, ABSTRACT,
-    OPERATOR, SELF, LLVM_INLINE, CAST, TRY_CAST, AS, TYPE,
+    OPERATOR, SELF, LLVM_INLINE, CAST, TRY_CAST, AS, TYPE, RESTRICT,
     
     // Types
     I8, I16, I32, I64, U8, U16, U32, U64, F32, F64, BOOL, STRING, VOID, UNIQUE, SHARED, WEAK,
@@ -38,13 +38,13 @@ enum class TokenType {
     BITWISE_LEFT_SHIFT, BITWISE_RIGHT_SHIFT,
     INCREMENT, DECREMENT,
     POWER,
-    SCOPE_RESOLUTION, MEMBER_ACCESS, ARROW,
+    SCOPE_RESOLUTION, MEMBER_ACCESS, ARROW, RANGE,
     
     // Punctuation
     LEFT_PAREN, RIGHT_PAREN,
     LEFT_BRACE, RIGHT_BRACE,
     LEFT_BRACKET, RIGHT_BRACKET,
-    SEMICOLON, COMMA, COLON, QUESTION,
+    SEMICOLON, COMMA, COLON, QUESTION, AT,
     
     // Special
     EOF_TOKEN,
@@ -91,6 +91,8 @@ public:
     static std::string tokenTypeToString(TokenType type);
     static TokenType getKeywordType(const std::string& identifier);
     static bool isKeyword(const std::string& identifier);
+    // The operator a compound assignment applies (PLUS for PLUS_ASSIGN); other types are returned unchanged
+    static TokenType compoundAssignmentOperator(TokenType type);
     
 private:
     static const std::unordered_map<std::string, TokenType> keywords;
@@ -171,6 +171,18 @@ std::unique_ptr<Declaration> Parser::parseDeclaration() {
         if (isAtEnd()) {
             return nullptr;
         }
+
+        // Attributes precede the declaration they apply to, export included
+        if (check(TokenType::AT)) {
+            std::vector<Attribute> attributes = parseAttributes();
+            auto declaration = parseDeclaration();
+            if (auto function = dynamic_cast<FunctionDeclaration*>(declaration.get())) {
+                function->attributes.insert(function->attributes.begin(), attributes.begin(), attributes.end());
+            } else if (declaration && error_reporter) {
+                error_reporter->reportError(attributes.front().location, "Attributes can only be applied to functions");
+            }
+            return declaration;
+        }
         
         // Handle export declarations
         if (match({TokenType::EXPORT})) {
@@ -213,6 +225,13 @@ std::unique_ptr<Declaration> Parser::parseDeclaration() {
         if (match({TokenType::FN})) {
             return parseFunctionDeclaration();
         }
+
+        if (match({TokenType::CONST})) {
+            consume(TokenType::FN, "Expected 'fn' after 'const'");
+            auto function = parseFunctionDeclaration();
+            function->is_const = true;
+            return function;
+        }
         
         if (match({TokenType::CLASS})) {
             return parseClassDeclaration();
@@ -246,6 +265,38 @@ std::unique_ptr<Declaration> Parser::parseDeclaration() {
     }
 }
 
+std::vector<Attribute> Parser::parseAttributes() {
+    std::vector<Attribute> attributes;
+    while (match({TokenType::AT})) {
+        Attribute attribute;
+        attribute.location = previous().location;
+        attribute.name = consume(TokenType::IDENTIFIER, "Expected attribute name after '@'").lexeme;
+
+        if (match({TokenType::LEFT_PAREN}) && !match({TokenType::RIGHT_PAREN})) {
+            do {
+                AttributeArgument argument;
+                if (check(TokenType::IDENTIFIER)) {
+                    argument.value = advance().lexeme;
+                    if (match({TokenType::ASSIGN})) {
+                        argument.key = argument.value;
+                        argument.value = check(TokenType::IDENTIFIER)
+                            ? advance().lexeme
+                            : consume(TokenType::INTEGER_LITERAL, "Expected attribute argument value after '='").lexeme;
+                    }
+                } else {
+                    argument.value = consume(TokenType::INTEGER_LITERAL, "Expected attribute argument").lexeme;
+                }
+                attribute.arguments.push_back(std::move(argument));
+            } while (match({TokenType::COMMA}));
+            consume(TokenType::RIGHT_PAREN, "Expected ')' after attribute arguments");
+        }
+
+        attributes.push_back(std::move(attribute));
+        skipNewlines();
+    }
+    return attributes;
+}
+
 std::unique_ptr<FunctionDeclaration> Parser::parseFunctionDeclaration() {
     Token name = consume(TokenType::IDENTIFIER, "Expected function name");
     
@@ -299,6 +350,16 @@ std::unique_ptr<VariableDeclaration> Parser::parseVariableDeclaration(bool is_mu
 // Statement parsing
 std::unique_ptr<Statement> Parser::parseStatement() {
     skipNewlines();
+
+    // Loop attributes: `@unroll(4) for i in 0..n { ... }`
+    if (check(TokenType::AT)) {
+        std::vector<Attribute> attributes = parseAttributes();
+        if (match({TokenType::WHILE})) return parseWhileStatement(std::move(attributes));
+        if (match({TokenType::FOR})) return parseForStatement(std::move(attributes));
+        reportError("Expected 'while' or 'for' after loop attributes");
+        throw std::runtime_error("Parse error: Expected 'while' or 'for' after loop attributes");
+    }
+
     if (match({TokenType::IF})) return parseIfStatement();
     if (match({TokenType::WHILE})) return parseWhileStatement();
     if (match({TokenType::FOR})) return parseForStatement();
@@ -356,25 +417,42 @@ std::unique_ptr<IfStatement> Parser::parseIfStatement() {
     );
 }
 
-std::unique_ptr<WhileStatement> Parser::parseWhileStatement() {
+std::unique_ptr<WhileStatement> Parser::parseWhileStatement(std::vector<Attribute> attributes) {
     auto condition = parseExpression();
     auto body = parseStatement();
     
-    return std::make_unique<WhileStatement>(
+    auto statement = std::make_unique<WhileStatement>(
         previous().location, std::move(condition), std::move(body)
     );
+    statement->attributes = std::move(attributes);
+    return statement;
 }
 
-std::unique_ptr<ForStatement> Parser::parseForStatement() {
+std::unique_ptr<ForStatement> Parser::parseForStatement(std::vector<Attribute> attributes) {
     Token iterator = consume(TokenType::IDENTIFIER, "Expected iterator name");
     consume(TokenType::IN, "Expected 'in' after iterator");
     auto iterable = parseExpression();
+
+    // `a..b step s`; step is only a keyword here
+    std::unique_ptr<Expression> range_end;
+    std::unique_ptr<Expression> step;
+    if (match({TokenType::RANGE})) {
+        range_end = parseExpression();
+        if (check(TokenType::IDENTIFIER) && peek().lexeme == "step") {
+            advance();
+            step = parseExpression();
+        }
+    }
     auto body = parseStatement();
     
-    return std::make_unique<ForStatement>(
+    auto statement = std::make_unique<ForStatement>(
         iterator.location, iterator.lexeme, 
         std::move(iterable), std::move(body)
     );
+    statement->range_end = std::move(range_end);
+    statement->step = std::move(step);
+    statement->attributes = std::move(attributes);
+    return statement;
 }
 
 std::unique_ptr<ReturnStatement> Parser::parseReturnStatement() {
@@ -641,18 +719,26 @@ std::unique_ptr<Type> Parser::parseType() {
     if (match({TokenType::CPTR, TokenType::UNIQUE, TokenType::SHARED, TokenType::WEAK})) {
         return parsePointerType();
     }
+
+    if (match({TokenType::RESTRICT})) {
+        consume(TokenType::CPTR, "Expected 'cptr' after 'restrict'");
+        return parsePointerType(true);
+    }
+
+    // [T; N], which nests: [[f32; 4]; 4]
+    if (match({TokenType::LEFT_BRACKET})) {
+        SourceLocation location = previous().location;
+        auto element_type = parseType();
+        consume(TokenType::SEMICOLON, "Expected ';' after array element type");
+        size_t size = parseArraySize();
+        consume(TokenType::RIGHT_BRACKET, "Expected ']' after array type");
+        return std::make_unique<ArrayType>(location, std::move(element_type), size);
+    }
     
     auto base_type = parsePrimitiveType();
     
     if (match({TokenType::LEFT_BRACKET})) {
-        if (peek().int_value <= 0) {
-            reportError("Expected positive array size");
-            throw std::runtime_error("Parse error: Expected positive array size");
-        }
-
-        size_t size = peek().int_value;
-
-        consume(TokenType::INTEGER_LITERAL, "Expected array size");
+        size_t size = parseArraySize();
         consume(TokenType::RIGHT_BRACKET, "Expected ']' after array type");
         return std::make_unique<ArrayType>(base_type->location, std::move(base_type), size);
     }
@@ -660,6 +746,17 @@ std::unique_ptr<Type> Parser::parseType() {
     return base_type;
 }
 
+size_t Parser::parseArraySize() {
+    if (peek().int_value <= 0) {
+        reportError("Expected positive array size");
+        throw std::runtime_error("Parse error: Expected positive array size");
+    }
+
+    size_t size = peek().int_value;
+    consume(TokenType::INTEGER_LITERAL, "Expected array size");
+    return size;
+}
+
 std::unique_ptr<Type> Parser::parsePrimitiveType() {
     // Handle all primitive types including new foreign types
     if (match({TokenType::I8, TokenType::I16, TokenType::I32, TokenType::I64, 
@@ -698,13 +795,27 @@ std::unique_ptr<Type> Parser::parsePrimitiveType() {
     throw std::runtime_error("Parse error: Expected type");
 }
 
-std::unique_ptr<Type> Parser::parsePointerType() {
+std::unique_ptr<Type> Parser::parsePointerType(bool is_restrict) {
     TokenType pointer_kind = previous().type;
     SourceLocation location = previous().location;
     
     consume(TokenType::LESS, "Expected '<' after pointer type");
     auto pointee = parseType(); // This will recursively handle nested pointers
 
+    // cptr<T, N>: a pointer to at least N elements
+    uint64_t length = 0;
+    if (match({TokenType::COMMA})) {
+        if (pointer_kind != TokenType::CPTR) {
+            reportError("Only cptr can have a length");
+            throw std::runtime_error("Parse error: Only cptr can have a length");
+        }
+        if (peek().type != TokenType::INTEGER_LITERAL || peek().int_value <= 0) {
+            reportError("Expected positive pointer length");
+            throw std::runtime_error("Parse error: Expected positive pointer length");
+        }
+        length = static_cast<uint64_t>(advance().int_value);
+    }
+
     // Check if > is repeated to make sure you don't get
     // Expected '>' after pointer type BITWISE_RIGHT_SHIFT '>>' error
     if (peek().type == TokenType::BITWISE_RIGHT_SHIFT) {
@@ -723,7 +834,10 @@ std::unique_ptr<Type> Parser::parsePointerType() {
 
     consume(TokenType::GREATER, "Expected '>' after pointer type");
     
-    return std::make_unique<PointerType>(location, std::move(pointee), pointer_kind);
+    auto pointer = std::make_unique<PointerType>(location, std::move(pointee), pointer_kind);
+    pointer->is_restrict = is_restrict;
+    pointer->length = length;
+    return pointer;
 }
 
 // Parameter and argument parsing
@@ -36,6 +36,7 @@ private:
     
     // Parsing methods
     std::unique_ptr<Declaration> parseDeclaration();
+    std::vector<Attribute> parseAttributes();
     std::unique_ptr<FunctionDeclaration> parseFunctionDeclaration();
     std::unique_ptr<FunctionDeclaration> parseForeignFunctionDeclaration();
     std::unique_ptr<VariableDeclaration> parseVariableDeclaration(bool is_mutable = false);
@@ -51,8 +52,8 @@ private:
     std::unique_ptr<Statement> parseStatement();
     std::unique_ptr<BlockStatement> parseBlockStatement();
     std::unique_ptr<IfStatement> parseIfStatement();
-    std::unique_ptr<WhileStatement> parseWhileStatement();
-    std::unique_ptr<ForStatement> parseForStatement();
+    std::unique_ptr<WhileStatement> parseWhileStatement(std::vector<Attribute> attributes = {});
+    std::unique_ptr<ForStatement> parseForStatement(std::vector<Attribute> attributes = {});
     std::unique_ptr<ReturnStatement> parseReturnStatement();
     std::unique_ptr<ExpressionStatement> parseExpressionStatement();
     
@@ -73,7 +74,8 @@ private:
     
     std::unique_ptr<Type> parseType();
     std::unique_ptr<Type> parsePrimitiveType();
-    std::unique_ptr<Type> parsePointerType();
+    std::unique_ptr<Type> parsePointerType(bool is_restrict = false);
+    size_t parseArraySize();
     
     std::vector<Parameter> parseParameterList();
     Parameter parseParameter();
@@ -0,0 +1,657 @@
+#include "const_interpreter.h"
+#include "type_context.h"
+#include <algorithm>
+#include <bit>
+
+namespace pangea {
+
+namespace {
+
+// Built-in scalar named by a declared type, looking through const
+PrimitiveKind scalarKind(const Type* type) {
+    if (auto const_type = dynamic_cast<const ConstType*>(type)) {
+        type = const_type->base_type.get();
+    }
+    auto primitive_type = dynamic_cast<const PrimitiveType*>(type);
+    return primitive_type ? primitive::fromName(primitive_type->toString()) : PrimitiveKind::NONE;
+}
+
+// Element kind and length of a fixed-size array of built-in scalars, looking through const
+std::optional<std::pair<PrimitiveKind, size_t>> arrayShape(const Type* type) {
+    if (auto const_type = dynamic_cast<const ConstType*>(type)) {
+        type = const_type->base_type.get();
+    }
+    auto array_type = dynamic_cast<const ArrayType*>(type);
+    PrimitiveKind kind = array_type ? scalarKind(array_type->element_type.get()) : PrimitiveKind::NONE;
+    if (kind == PrimitiveKind::NONE) {
+        return std::nullopt;
+    }
+    return std::make_pair(kind, array_type->size);
+}
+
+// Values crossing a parameter, return or store convert like a cast would
+std::optional<ConstantValue> convertTo(const ConstantValue& value, PrimitiveKind kind) {
+    return value.kind == kind ? value : ConstantEvaluator::castValue(value, kind);
+}
+
+} // namespace
+
+ConstInterpreter::ConstInterpreter(const std::vector<FunctionDeclaration*>& const_functions,
+                                   const std::vector<const ConstantValue*>& folded_constants, size_t budget)
+    : functions(const_functions), constants(folded_constants), step_budget(budget) {}
+
+std::optional<ConstantValue> ConstInterpreter::call(FunctionDeclaration& function,
+                                                    const std::vector<ConstantValue>& arguments) {
+    steps = 0;
+    flow = Flow::NORMAL;
+    failure.clear();
+    locals.clear();
+    frame_base = 0;
+    depth = 0;
+    returned_array.reset();
+    array_result = nullptr;
+
+    std::optional<ConstantValue> value = invoke(function, arguments);
+    total_steps += steps;
+    return flow == Flow::FAILED ? std::nullopt : value;
+}
+
+const ConstantArray* ConstInterpreter::callArray(FunctionDeclaration& function,
+                                                 const std::vector<ConstantValue>& arguments) {
+    call(function, arguments);
+    return flow == Flow::FAILED ? nullptr : array_result;
+}
+
+std::optional<ConstantValue> ConstInterpreter::invoke(FunctionDeclaration& function,
+                                                      const std::vector<ConstantValue>& arguments) {
+    if (!function.body || arguments.size() != function.parameters.size()) {
+        fail("'" + function.name + "' cannot be called with these arguments");
+        return std::nullopt;
+    }
+
+    std::vector<int64_t> key{static_cast<int64_t>(reinterpret_cast<intptr_t>(&function))};
+    std::vector<ConstantValue> parameters;
+    for (size_t i = 0; i < arguments.size(); ++i) {
+        std::optional<ConstantValue> value = convertTo(arguments[i], scalarKind(function.parameters[i].type.get()));
+        if (!value) {
+            fail("argument " + std::to_string(i + 1) + " of '" + function.name + "' has an unsupported type");
+            return std::nullopt;
+        }
+        parameters.push_back(*value);
+        key.push_back(primitive::isFloat(value->kind) ? std::bit_cast<int64_t>(value->real) : value->integer);
+    }
+
+    auto cached = memo.find(key);
+    if (cached != memo.end()) {
+        memoized_calls++;
+        return cached->second;
+    }
+    auto cached_array = array_memo.find(key);
+    if (cached_array != array_memo.end()) {
+        memoized_calls++;
+        array_result = &cached_array->second;
+        return std::nullopt;
+    }
+
+    if (depth >= max_call_depth) {
+        fail("calls nest deeper than " + std::to_string(max_call_depth) + " levels");
+        return std::nullopt;
+    }
+
+    size_t caller_base = frame_base;
+    PrimitiveKind caller_return_kind = return_kind;
+    std::optional<size_t> caller_return_length = return_length;
+    frame_base = locals.size();
+    if (auto shape = arrayShape(function.return_type.get())) {
+        return_kind = shape->first;
+        return_length = shape->second;
+    } else {
+        return_kind = scalarKind(function.return_type.get());
+        return_length.reset();
+    }
+    for (size_t i = 0; i < parameters.size(); ++i) {
+        locals.push_back(Local{function.parameters[i].symbol_id, parameters[i], std::nullopt});
+    }
+
+    depth++;
+    function.body->accept(*this);
+    depth--;
+
+    std::optional<ConstantValue> value;
+    if (flow == Flow::RETURN && returned_array) {
+        array_result = &array_memo.insert_or_assign(key, std::move(*returned_array)).first->second;
+        returned_array.reset();
+        flow = Flow::NORMAL;
+    } else if (flow == Flow::RETURN) {
+        value = result;
+        flow = Flow::NORMAL;
+    } else if (flow == Flow::NORMAL) {
+        fail("'" + function.name + "' ended without returning a value");
+    }
+    result.reset();
+
+    locals.resize(frame_base);
+    frame_base = caller_base;
+    return_kind = caller_return_kind;
+    return_length = caller_return_length;
+
+    if (value) {
+        memo.emplace(std::move(key), *value);
+    }
+    return value;
+}
+
+std::optional<ConstantValue> ConstInterpreter::evaluate(Expression& expr) {
+    if (flow == Flow::FAILED || !step()) {
+        return std::nullopt;
+    }
+
+    result.reset();
+    expr.accept(*this);
+    std::optional<ConstantValue> value = result;
+    result.reset();
+
+    if (!value) {
+        fail("an expression could not be evaluated");
+    }
+    return value;
+}
+
+std::optional<bool> ConstInterpreter::evaluateCondition(Expression& expr) {
+    std::optional<ConstantValue> value = evaluate(expr);
+    if (!value) {
+        return std::nullopt;
+    }
+
+    // Integers count as true when non-zero, as in generated code
+    if (value->kind != PrimitiveKind::BOOL && !primitive::isInteger(value->kind)) {
+        fail("a condition is not a bool or an integer");
+        return std::nullopt;
+    }
+    return value->integer != 0;
+}
+
+ConstInterpreter::Local* ConstInterpreter::findLocal(SymbolId id) {
+    for (size_t i = locals.size(); i > frame_base; --i) {
+        if (locals[i - 1].id == id) {
+            return &locals[i - 1];
+        }
+    }
+    return nullptr;
+}
+
+ConstantValue* ConstInterpreter::findElement(IndexExpression& node) {
+    // The index is evaluated first, since a call in it may move the locals
+    std::optional<ConstantValue> index = evaluate(*node.index);
+    if (!index) {
+        return nullptr;
+    }
+
+    auto identifier = dynamic_cast<IdentifierExpression*>(node.object.get());
+    Local* local = identifier ? findLocal(identifier->symbol_id) : nullptr;
+    if (!local || !local->array) {
+        fail("it indexes something other than a local array");
+        return nullptr;
+    }
+    if (!primitive::isInteger(index->kind)) {
+        fail("an index is not an integer");
+        return nullptr;
+    }
+
+    // Unsigned values past INT64_MAX read as negative, as they do in bounds checks
+    std::vector<ConstantValue>& elements = local->array->elements;
+    if (index->integer < 0 || static_cast<uint64_t>(index->integer) >= elements.size()) {
+        std::string shown = primitive::isSigned(index->kind) ? std::to_string(index->integer)
+                                                             : std::to_string(static_cast<uint64_t>(index->integer));
+        fail("index " + shown + " is out of bounds for an array of " + std::to_string(elements.size()) + " elements");
+        return nullptr;
+    }
+    return &elements[static_cast<size_t>(index->integer)];
+}
+
+ConstantValue* ConstInterpreter::findTarget(Expression& target) {
+    if (auto index = dynamic_cast<IndexExpression*>(&target)) {
+        return findElement(*index);
+    }
+
+    auto identifier = dynamic_cast<IdentifierExpression*>(&target);
+    Local* local = identifier ? findLocal(identifier->symbol_id) : nullptr;
+    if (!local || local->array) {
+        fail("it assigns to something other than a scalar local or an array element");
+        return nullptr;
+    }
+    return &local->value;
+}
+
+bool ConstInterpreter::step() {
+    if (++steps > step_budget) {
+        fail("it did not finish within " + std::to_string(step_budget) + " steps");
+        return false;
+    }
+    return true;
+}
+
+void ConstInterpreter::fail(const std::string& reason) {
+    // Keep the first reason; everything after it is fallout
+    if (flow != Flow::FAILED) {
+        failure = reason;
+        flow = Flow::FAILED;
+    }
+}
+
+void ConstInterpreter::visit(PrimitiveType& /*node*/) {
+}
+
+void ConstInterpreter::visit(ConstType& /*node*/) {
+}
+
+void ConstInterpreter::visit(ArrayType& /*node*/) {
+}
+
+void ConstInterpreter::visit(PointerType& /*node*/) {
+}
+
+void ConstInterpreter::visit(GenericType& /*node*/) {
+}
+
+void ConstInterpreter::visit(LiteralExpression& node) {
+    result = ConstantEvaluator::literalValue(node);
+    if (!result) {
+        fail("it uses a literal that is not a number or bool");
+    }
+}
+
+void ConstInterpreter::visit(IdentifierExpression& node) {
+    if (Local* local = findLocal(node.symbol_id)) {
+        if (local->array) {
+            fail("'" + node.name + "' is an array, which can only be indexed or returned");
+            return;
+        }
+        result = local->value;
+    } else if (node.symbol_id < constants.size() && constants[node.symbol_id]) {
+        result = *constants[node.symbol_id];
+    } else {
+        fail("'" + node.name + "' is neither a local nor a constant");
+    }
+}
+
+void ConstInterpreter::visit(BinaryExpression& node) {
+    std::optional<ConstantValue> left = evaluate(*node.left);
+    if (!left || !node.resolved_type) {
+        return;
+    }
+    PrimitiveKind kind = node.resolved_type->primitive_kind;
+
+    // && and || skip their right operand when the left one decides, like generated code
+    result = ConstantEvaluator::shortCircuit(node.operator_token, *left, kind);
+    if (result) {
+        return;
+    }
+
+    std::optional<ConstantValue> right = evaluate(*node.right);
+    if (!right) {
+        return;
+    }
+
+    result = ConstantEvaluator::applyBinary(node.operator_token, *left, *right, kind);
+    if (!result) {
+        fail("an operation is undefined for its operands");
+    }
+}
+
+void ConstInterpreter::visit(UnaryExpression& node) {
+    std::optional<ConstantValue> operand = evaluate(*node.operand);
+    if (!operand || !node.resolved_type) {
+        return;
+    }
+
+    result = ConstantEvaluator::applyUnary(node.operator_token, *operand, node.resolved_type->primitive_kind);
+    if (!result) {
+        fail("an operation is undefined for its operand");
+    }
+}
+
+void ConstInterpreter::visit(CallExpression& node) {
+    auto callee = dynamic_cast<IdentifierExpression*>(node.callee.get());
+    FunctionDeclaration* function = callee && callee->symbol_id < functions.size() ? functions[callee->symbol_id] : nullptr;
+    if (!function) {
+        fail("it calls " + (callee ? "'" + callee->name + "', which is not a const fn" : std::string("a non-constant callee")));
+        return;
+    }
+    if (arrayShape(function->return_type.get())) {
+        fail("it calls '" + function->name + "', which returns an array");
+        return;
+    }
+
+    std::vector<ConstantValue> arguments;
+    for (auto& arg : node.arguments) {
+        std::optional<ConstantValue> value = evaluate(*arg);
+        if (!value) {
+            return;
+        }
+        arguments.push_back(*value);
+    }
+
+    result = invoke(*function, arguments);
+}
+
+void ConstInterpreter::visit(MemberExpression& /*node*/) {
+    fail("member access is not supported at compile time");
+}
+
+void ConstInterpreter::visit(IndexExpression& node) {
+    if (ConstantValue* element = findElement(node)) {
+        result = *element;
+    }
+}
+
+void ConstInterpreter::visit(AssignmentExpression& node) {
+    std::optional<ConstantValue> value = evaluate(*node.right);
+    if (!value) {
+        return;
+    }
+
+    // Looked up after the right side, since a call there may move the locals
+    ConstantValue* local = findTarget(*node.left);
+    if (!local) {
+        return;
+    }
+
+    if (node.operator_token != TokenType::ASSIGN) {
+        // The operation happens in the common type and is stored back converted
+        PrimitiveKind common = primitive::commonKind(local->kind, value->kind);
+        value = ConstantEvaluator::applyBinary(TokenUtils::compoundAssignmentOperator(node.operator_token), *local, *value, common);
+        if (!value) {
+            fail("a compound assignment is undefined for its operands");
+            return;
+        }
+    }
+
+    value = convertTo(*value, local->kind);
+    if (!value) {
+        fail("an assigned value cannot be converted to its variable's type");
+        return;
+    }
+    *local = *value;
+    result = value;
+}
+
+void ConstInterpreter::visit(PostfixExpression& node) {
+    ConstantValue* local = findTarget(*node.operand);
+    if (!local) {
+        return;
+    }
+    if (!primitive::isNumeric(local->kind)) {
+        fail("it increments or decrements something that is not a number");
+        return;
+    }
+
+    ConstantValue one{local->kind, 1, 1.0};
+    TokenType op = node.operator_token == TokenType::INCREMENT ? TokenType::PLUS : TokenType::MINUS;
+    std::optional<ConstantValue> updated = ConstantEvaluator::applyBinary(op, *local, one, local->kind);
+    if (!updated) {
+        fail("an increment or decrement is undefined");
+        return;
+    }
+
+    // Postfix operations yield the original value
+    result = *local;
+    *local = *updated;
+}
+
+void ConstInterpreter::visit(CastExpression& node) {
+    std::optional<ConstantValue> operand = evaluate(*node.expression);
+    if (!operand || !node.resolved_type) {
+        return;
+    }
+
+    result = ConstantEvaluator::castValue(*operand, node.resolved_type->primitive_kind);
+    if (!result) {
+        fail("a cast cannot be evaluated at compile time");
+    }
+}
+
+void ConstInterpreter::visit(AsExpression& node) {
+    std::optional<ConstantValue> operand = evaluate(*node.expression);
+    if (!operand || !node.resolved_type) {
+        return;
+    }
+
+    result = ConstantEvaluator::castValue(*operand, node.resolved_type->primitive_kind);
+    if (!result) {
+        fail("a cast cannot be evaluated at compile time");
+    }
+}
+
+void ConstInterpreter::visit(ExpressionStatement& node) {
+    evaluate(*node.expression);
+}
+
+void ConstInterpreter::visit(BlockStatement& node) {
+    size_t scope_start = locals.size();
+    for (auto& stmt : node.statements) {
+        if (!step()) {
+            break;
+        }
+        stmt->accept(*this);
+        if (flow != Flow::NORMAL) {
+            break;
+        }
+    }
+    locals.resize(scope_start);
+}
+
+void ConstInterpreter::visit(IfStatement& node) {
+    std::optional<bool> condition = evaluateCondition(*node.condition);
+    if (!condition) {
+        return;
+    }
+
+    if (*condition) {
+        node.then_branch->accept(*this);
+    } else if (node.else_branch) {
+        node.else_branch->accept(*this);
+    }
+}
+
+void ConstInterpreter::visit(WhileStatement& node) {
+    while (flow == Flow::NORMAL) {
+        std::optional<bool> condition = evaluateCondition(*node.condition);
+        if (!condition || !*condition) {
+            return;
+        }
+        node.body->accept(*this);
+    }
+}
+
+void ConstInterpreter::visit(ForStatement& node) {
+    if (!node.range_end) {
+        fail("for loops can only iterate over integer ranges");
+        return;
+    }
+
+    std::optional<ConstantValue> start = evaluate(*node.iterable);
+    std::optional<ConstantValue> end = start ? evaluate(*node.range_end) : std::nullopt;
+    if (!end) {
+        return;
+    }
+
+    // The iterator has the bounds' common type, as in generated code
+    PrimitiveKind kind = primitive::commonKind(start->kind, end->kind);
+    start = primitive::isInteger(kind) ? convertTo(*start, kind) : std::nullopt;
+    end = primitive::isInteger(kind) ? convertTo(*end, kind) : std::nullopt;
+    if (!start || !end) {
+        fail("range bounds are not integers");
+        return;
+    }
+    bool is_signed = primitive::isSigned(kind);
+    unsigned width = primitive::bitWidth(kind);
+
+    std::optional<ConstantValue> stride_value = ConstantValue{kind, 1, 0.0};
+    if (node.step) {
+        stride_value = evaluate(*node.step);
+        if (!stride_value) {
+            return;
+        }
+        if (!primitive::isInteger(stride_value->kind) || stride_value->integer == 0 ||
+            (!primitive::isSigned(stride_value->kind) && stride_value->integer < 0)) {
+            fail("a loop step is not a non-zero integer");
+            return;
+        }
+    }
+    int64_t stride = stride_value->integer;
+    uint64_t magnitude = stride < 0 ? uint64_t(0) - static_cast<uint64_t>(stride) : static_cast<uint64_t>(stride);
+    uint64_t max_magnitude = width >= 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+    if (is_signed) {
+        max_magnitude >>= 1;
+    }
+    if (magnitude > max_magnitude + (is_signed && stride < 0 ? 1 : 0)) {
+        fail("a loop step does not fit in the iterator type");
+        return;
+    }
+    bool ascending = stride > 0;
+
+    // Same trip count as codegen: ceil(distance / |step|) for a non-empty range.
+    // Both bounds are extended to 64 bits, so the distance is exact as an unsigned number
+    uint64_t first = static_cast<uint64_t>(start->integer);
+    uint64_t bound = static_cast<uint64_t>(end->integer);
+    bool non_empty = is_signed ? (ascending ? start->integer < end->integer : start->integer > end->integer)
+                               : (ascending ? first < bound : first > bound);
+    uint64_t trip_count = non_empty ? ((ascending ? bound - first : first - bound) - 1) / magnitude + 1 : 0;
+
+    // A negative step wraps to the same bits in an unsigned iterator type
+    std::optional<ConstantValue> increment = convertTo(*stride_value, kind);
+    if (!increment) {
+        fail("a loop step cannot be converted to the iterator type");
+        return;
+    }
+
+    size_t scope_start = locals.size();
+    locals.push_back(Local{node.iterator_symbol_id, *start, std::nullopt});
+    for (uint64_t count = 0; count < trip_count && flow == Flow::NORMAL; ++count) {
+        if (!step()) {
+            break;
+        }
+        node.body->accept(*this);
+
+        // The body's block drops its own locals, and the iterator cannot be assigned
+        if (count + 1 < trip_count) {
+            ConstantValue& iterator = locals[scope_start].value;
+            std::optional<ConstantValue> next = ConstantEvaluator::applyBinary(TokenType::PLUS, iterator, *increment, kind);
+            if (!next) {
+                fail("a loop iterator could not be advanced");
+                break;
+            }
+            iterator = *next;
+        }
+    }
+    locals.resize(scope_start);
+}
+
+void ConstInterpreter::visit(ReturnStatement& node) {
+    if (!node.value) {
+        fail("it returns without a value");
+        return;
+    }
+
+    // An array is returned by naming a local array of the return type
+    if (return_length) {
+        auto identifier = dynamic_cast<IdentifierExpression*>(node.value.get());
+        Local* local = identifier && step() ? findLocal(identifier->symbol_id) : nullptr;
+        if (!local || !local->array || local->array->element_kind != return_kind ||
+            local->array->elements.size() != *return_length) {
+            fail("it returns something other than a local array of its return type");
+            return;
+        }
+        returned_array = *local->array;
+        result.reset();
+        flow = Flow::RETURN;
+        return;
+    }
+
+    std::optional<ConstantValue> value = evaluate(*node.value);
+    if (!value) {
+        return;
+    }
+
+    result = convertTo(*value, return_kind);
+    if (!result) {
+        fail("a returned value cannot be converted to the return type");
+        return;
+    }
+    flow = Flow::RETURN;
+}
+
+void ConstInterpreter::visit(DeclarationStatement& node) {
+    if (node.declaration) {
+        node.declaration->accept(*this);
+    }
+}
+
+void ConstInterpreter::visit(FunctionDeclaration& /*node*/) {
+    fail("nested functions are not supported at compile time");
+}
+
+void ConstInterpreter::visit(VariableDeclaration& node) {
+    if (auto shape = arrayShape(node.type.get())) {
+        if (node.initializer) {
+            fail("array '" + node.name + "' has an initializer; arrays start zeroed and are filled element by element");
+            return;
+        }
+
+        // Zeroing costs a step per element, which also keeps oversized arrays from being allocated
+        if (shape->second > step_budget - std::min(steps, step_budget)) {
+            fail("it did not finish within " + std::to_string(step_budget) + " steps");
+            return;
+        }
+        steps += shape->second;
+
+        ConstantValue zero{shape->first, 0, 0.0};
+        locals.push_back(Local{node.symbol_id, zero, ConstantArray{shape->first, std::vector<ConstantValue>(shape->second, zero)}});
+        return;
+    }
+
+    if (!node.initializer) {
+        fail("'" + node.name + "' is declared without an initializer");
+        return;
+    }
+
+    std::optional<ConstantValue> value = evaluate(*node.initializer);
+    if (!value) {
+        return;
+    }
+
+    // Without a declared type the variable takes the initializer's
+    if (node.type) {
+        PrimitiveKind declared = scalarKind(node.type.get());
+        value = declared == PrimitiveKind::NONE ? std::nullopt : convertTo(*value, declared);
+        if (!value) {
+            fail("'" + node.name + "' does not have a built-in scalar type");
+            return;
+        }
+    }
+    locals.push_back(Local{node.symbol_id, *value, std::nullopt});
+}
+
+void ConstInterpreter::visit(ClassDeclaration& /*node*/) {
+    fail("nested classes are not supported at compile time");
+}
+
+void ConstInterpreter::visit(StructDeclaration& /*node*/) {
+    fail("nested structs are not supported at compile time");
+}
+
+void ConstInterpreter::visit(EnumDeclaration& /*node*/) {
+    fail("nested enums are not supported at compile time");
+}
+
+void ConstInterpreter::visit(ImportDeclaration& /*node*/) {
+}
+
+void ConstInterpreter::visit(Module& /*node*/) {
+}
+
+void ConstInterpreter::visit(Program& /*node*/) {
+}
+
+} // namespace pangea
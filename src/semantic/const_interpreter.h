@@ -0,0 +1,142 @@
+#pragma once
+
+#include "../ast/ast_visitor.h"
+#include "../ast/ast_nodes.h"
+#include "constant_evaluator.h"
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace pangea {
+
+// Runs `const fn` bodies at compile time. Supports scalar locals and
+// parameters, assignment, if/while/return, for loops over integer ranges, the
+// operators ConstantEvaluator folds, references to folded const declarations,
+// and calls to other const fns. A const fn may also fill a local fixed-size
+// array element by element and return it, which is how lookup tables are
+// built. Every statement, expression and loop iteration costs one step, as
+// does every array element; a call stops once its steps exceed the budget, so
+// non-terminating functions fail instead of hanging the compiler. A const fn
+// can only read its arguments and constants, so results are memoized by
+// argument values, and identical calls share one array.
+class ConstInterpreter : public ASTVisitor {
+public:
+    static constexpr size_t max_call_depth = 256;
+
+private:
+    // Const fns and folded const declarations, indexed by SymbolId
+    const std::vector<FunctionDeclaration*>& functions;
+    const std::vector<const ConstantValue*>& constants;
+    size_t step_budget;
+
+    // Locals of every active call; the current call's start at frame_base
+    struct Local {
+        SymbolId id;
+        ConstantValue value;                // Scalars
+        std::optional<ConstantArray> array; // Fixed-size arrays, which do not use value
+    };
+    std::vector<Local> locals;
+    size_t frame_base = 0;
+    size_t depth = 0;
+
+    enum class Flow { NORMAL, RETURN, FAILED };
+    Flow flow = Flow::NORMAL;
+    PrimitiveKind return_kind = PrimitiveKind::NONE; // The element kind when the call returns an array
+    std::optional<size_t> return_length;              // Element count when the call returns an array
+    std::optional<ConstantValue> result; // Value of the expression just visited, or the returned value
+    std::optional<ConstantArray> returned_array; // Set by return, then moved into array_memo
+    const ConstantArray* array_result = nullptr;  // The array the last top-level call returned
+    std::string failure;
+
+    size_t steps = 0;
+    size_t total_steps = 0;
+    size_t memoized_calls = 0;
+
+    // Function and argument bits -> returned value
+    std::map<std::vector<int64_t>, ConstantValue> memo;
+    std::map<std::vector<int64_t>, ConstantArray> array_memo; // Nodes stay put, so callArray hands out addresses
+
+public:
+    ConstInterpreter(const std::vector<FunctionDeclaration*>& const_functions,
+                     const std::vector<const ConstantValue*>& folded_constants, size_t budget);
+
+    /**
+     * Evaluate a call to a const fn
+     * @param function A const fn with a body
+     * @param arguments Folded arguments, converted to the parameter types as needed
+     * @return The returned value, or nothing if evaluation failed (see getFailure)
+     */
+    std::optional<ConstantValue> call(FunctionDeclaration& function, const std::vector<ConstantValue>& arguments);
+
+    /**
+     * Evaluate a call to a const fn that returns a fixed-size array
+     * @return The returned array, owned by the interpreter and shared by identical calls,
+     *         or null if evaluation failed (see getFailure)
+     */
+    const ConstantArray* callArray(FunctionDeclaration& function, const std::vector<ConstantValue>& arguments);
+
+    // Why the last call could not be evaluated
+    const std::string& getFailure() const { return failure; }
+    size_t getTotalSteps() const { return total_steps; }
+    size_t getMemoizedCalls() const { return memoized_calls; }
+
+    // Type visitors
+    void visit(PrimitiveType& node) override;
+    void visit(ConstType& node) override;
+    void visit(ArrayType& node) override;
+    void visit(PointerType& node) override;
+    void visit(GenericType& node) override;
+
+    // Expression visitors
+    void visit(LiteralExpression& node) override;
+    void visit(IdentifierExpression& node) override;
+    void visit(BinaryExpression& node) override;
+    void visit(UnaryExpression& node) override;
+    void visit(CallExpression& node) override;
+    void visit(MemberExpression& node) override;
+    void visit(IndexExpression& node) override;
+    void visit(AssignmentExpression& node) override;
+    void visit(PostfixExpression& node) override;
+    void visit(CastExpression& node) override;
+    void visit(AsExpression& node) override;
+
+    // Statement visitors
+    void visit(ExpressionStatement& node) override;
+    void visit(BlockStatement& node) override;
+    void visit(IfStatement& node) override;
+    void visit(WhileStatement& node) override;
+    void visit(ForStatement& node) override;
+    void visit(ReturnStatement& node) override;
+    void visit(DeclarationStatement& node) override;
+
+    // Declaration visitors
+    void visit(FunctionDeclaration& node) override;
+    void visit(VariableDeclaration& node) override;
+    void visit(ClassDeclaration& node) override;
+    void visit(StructDeclaration& node) override;
+    void visit(EnumDeclaration& node) override;
+    void visit(ImportDeclaration& node) override;
+
+    // Module and Program visitors
+    void visit(Module& node) override;
+    void visit(Program& node) override;
+
+private:
+    std::optional<ConstantValue> invoke(FunctionDeclaration& function, const std::vector<ConstantValue>& arguments);
+
+    // Visit an expression and return its value; nothing once evaluation failed
+    std::optional<ConstantValue> evaluate(Expression& expr);
+    std::optional<bool> evaluateCondition(Expression& expr);
+
+    Local* findLocal(SymbolId id);
+
+    // Storage of an array element or of a scalar local; nothing once evaluation failed
+    ConstantValue* findElement(IndexExpression& node);
+    ConstantValue* findTarget(Expression& target);
+
+    bool step();
+    void fail(const std::string& reason);
+};
+
+} // namespace pangea
@@ -0,0 +1,633 @@
+#include "constant_evaluator.h"
+#include "const_interpreter.h"
+#include "module_graph.h"
+#include "type_context.h"
+#include <cmath>
+#include <llvm/Support/TimeProfiler.h>
+
+namespace pangea {
+
+namespace {
+
+uint64_t widthMask(unsigned width) {
+    return width >= 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+}
+
+// The low bits read as a signed number, which is how sdiv, srem, ashr and signed compares see them
+int64_t asSigned(int64_t value, unsigned width) {
+    uint64_t mask = widthMask(width);
+    uint64_t bits = static_cast<uint64_t>(value) & mask;
+    if (width < 64 && ((bits >> (width - 1)) & 1)) {
+        bits |= ~mask;
+    }
+    return static_cast<int64_t>(bits);
+}
+
+// Keep the low bits of an integer, extended by the kind's signedness
+ConstantValue makeInteger(PrimitiveKind kind, uint64_t bits) {
+    unsigned width = primitive::bitWidth(kind);
+    int64_t value = primitive::isSigned(kind) ? asSigned(static_cast<int64_t>(bits), width)
+                                              : static_cast<int64_t>(bits & widthMask(width));
+    return ConstantValue{kind, value, 0.0};
+}
+
+ConstantValue makeReal(PrimitiveKind kind, double value) {
+    return ConstantValue{kind, 0, kind == PrimitiveKind::F32 ? static_cast<double>(static_cast<float>(value)) : value};
+}
+
+// Convert straight from the integer so f32 results are rounded only once
+template <typename Integer>
+ConstantValue makeRealFromInteger(PrimitiveKind kind, Integer value) {
+    return ConstantValue{kind, 0, kind == PrimitiveKind::F32 ? static_cast<double>(static_cast<float>(value))
+                                                              : static_cast<double>(value)};
+}
+
+// Usual arithmetic conversions, as promoteToCommonType emits them
+std::optional<ConstantValue> promote(const ConstantValue& value, PrimitiveKind to) {
+    switch (primitive::conversion(value.kind, to)) {
+        case NumericConversion::IDENTITY:
+            return value;
+        case NumericConversion::SIGN_EXTEND:
+        case NumericConversion::ZERO_EXTEND:
+        case NumericConversion::TRUNCATE:
+            return makeInteger(to, static_cast<uint64_t>(value.integer));
+        case NumericConversion::SIGNED_TO_FLOAT:
+            return makeRealFromInteger(to, value.integer);
+        case NumericConversion::UNSIGNED_TO_FLOAT:
+            return makeRealFromInteger(to, static_cast<uint64_t>(value.integer));
+        case NumericConversion::FLOAT_EXTEND:
+        case NumericConversion::FLOAT_TRUNCATE:
+            return makeReal(to, value.real);
+        default:
+            return std::nullopt;
+    }
+}
+
+bool isComparison(TokenType op) {
+    switch (op) {
+        case TokenType::EQUAL:
+        case TokenType::NOT_EQUAL:
+        case TokenType::LESS:
+        case TokenType::LESS_EQUAL:
+        case TokenType::GREATER:
+        case TokenType::GREATER_EQUAL:
+            return true;
+        default:
+            return false;
+    }
+}
+
+template <typename T>
+bool compare(TokenType op, T left, T right) {
+    switch (op) {
+        case TokenType::EQUAL:         return left == right;
+        case TokenType::NOT_EQUAL:     return left < right || left > right; // Ordered: false for NaN
+        case TokenType::LESS:          return left < right;
+        case TokenType::LESS_EQUAL:    return left <= right;
+        case TokenType::GREATER:       return left > right;
+        case TokenType::GREATER_EQUAL: return left >= right;
+        default:                       return false;
+    }
+}
+
+} // namespace
+
+ConstantEvaluator::ConstantEvaluator(ErrorReporter* reporter, size_t step_budget)
+    : error_reporter(reporter), const_fn_steps(step_budget) {}
+
+ConstantEvaluator::~ConstantEvaluator() = default;
+
+void ConstantEvaluator::evaluate(Program& program, const DeclarationTable& declarations) {
+    values.clear();
+    constants.assign(declarations.size(), nullptr);
+    folded_expressions = 0;
+    constant_declarations = 0;
+    evaluated_calls = 0;
+
+    // Const fns may be called before they are declared, or from importing modules
+    const_functions.assign(declarations.size(), nullptr);
+    auto collect = [this](Module& module) {
+        for (auto& decl : module.declarations) {
+            auto function = dynamic_cast<FunctionDeclaration*>(decl.get());
+            if (function && function->is_const && function->body && function->symbol_id < const_functions.size()) {
+                const_functions[function->symbol_id] = function;
+            }
+        }
+    };
+    for (auto& module : program.modules) {
+        collect(*module);
+    }
+    if (program.main_module) {
+        collect(*program.main_module);
+    }
+    interpreter = std::make_unique<ConstInterpreter>(const_functions, constants, const_fn_steps);
+
+    program.accept(*this);
+}
+
+void ConstantEvaluator::reportStatistics(CompilerStats& stats) const {
+    stats.set("fold.folded expressions", folded_expressions);
+    stats.set("fold.constant declarations", constant_declarations);
+    stats.set("fold.const fn calls", evaluated_calls);
+    if (interpreter) {
+        stats.set("fold.const fn steps", interpreter->getTotalSteps());
+        stats.set("fold.const fn memoized calls", interpreter->getMemoizedCalls());
+    }
+}
+
+std::optional<ConstantValue> ConstantEvaluator::fold(Expression& expr) {
+    expr.accept(*this);
+    std::optional<ConstantValue> value = result;
+    result.reset();
+    return value;
+}
+
+void ConstantEvaluator::annotate(Expression& expr, std::optional<ConstantValue> value) {
+    // Always overwritten: cached modules carry annotations from earlier compilations
+    expr.constant_value = nullptr;
+    if (value) {
+        values.push_back(*value);
+        expr.constant_value = &values.back();
+        folded_expressions++;
+    }
+    result = value;
+}
+
+std::optional<ConstantValue> ConstantEvaluator::castValue(const ConstantValue& value, PrimitiveKind to) {
+    PrimitiveKind from = value.kind;
+
+    // Casts to and from bool are left to codegen
+    if (!primitive::isNumeric(from) || !primitive::isNumeric(to)) {
+        return std::nullopt;
+    }
+
+    if (primitive::isInteger(from) && primitive::isInteger(to)) {
+        // Codegen sign-extends whatever the signedness of the source
+        return makeInteger(to, static_cast<uint64_t>(asSigned(value.integer, primitive::bitWidth(from))));
+    }
+    if (primitive::isInteger(from)) {
+        return makeRealFromInteger(to, asSigned(value.integer, primitive::bitWidth(from)));
+    }
+    if (primitive::isInteger(to)) {
+        // fptosi of a value outside the signed range (or NaN) is poison
+        double truncated = std::trunc(value.real);
+        double limit = std::ldexp(1.0, static_cast<int>(primitive::bitWidth(to)) - 1);
+        if (!(truncated >= -limit && truncated < limit)) {
+            return std::nullopt;
+        }
+        return makeInteger(to, static_cast<uint64_t>(static_cast<int64_t>(truncated)));
+    }
+    return makeReal(to, value.real);
+}
+
+std::optional<ConstantValue> ConstantEvaluator::applyBinary(TokenType op, const ConstantValue& left,
+                                                            const ConstantValue& right, PrimitiveKind result_kind) {
+    if (op == TokenType::LOGICAL_AND || op == TokenType::LOGICAL_OR) {
+        // Integers count as true when non-zero
+        auto truth = [](const ConstantValue& value) -> std::optional<bool> {
+            if (value.kind == PrimitiveKind::BOOL || primitive::isInteger(value.kind)) {
+                return value.integer != 0;
+            }
+            return std::nullopt;
+        };
+
+        std::optional<bool> l = truth(left);
+        std::optional<bool> r = truth(right);
+        if (!l || !r || result_kind != PrimitiveKind::BOOL) {
+            return std::nullopt;
+        }
+        return makeInteger(PrimitiveKind::BOOL, op == TokenType::LOGICAL_AND ? (*l && *r) : (*l || *r));
+    }
+
+    PrimitiveKind common = primitive::commonKind(left.kind, right.kind);
+    if (common == PrimitiveKind::NONE) {
+        return std::nullopt;
+    }
+
+    std::optional<ConstantValue> a = promote(left, common);
+    std::optional<ConstantValue> b = promote(right, common);
+    if (!a || !b) {
+        return std::nullopt;
+    }
+
+    unsigned width = primitive::bitWidth(common);
+
+    if (isComparison(op)) {
+        if (result_kind != PrimitiveKind::BOOL) {
+            return std::nullopt;
+        }
+
+        // Integer compares are signed, like the icmp codegen emits
+        bool value = primitive::isFloat(common) ? compare(op, a->real, b->real)
+                                                : compare(op, asSigned(a->integer, width), asSigned(b->integer, width));
+        return makeInteger(PrimitiveKind::BOOL, value);
+    }
+
+    if (result_kind != common) {
+        return std::nullopt;
+    }
+
+    if (primitive::isFloat(common)) {
+        switch (op) {
+            case TokenType::PLUS:     return makeReal(common, a->real + b->real);
+            case TokenType::MINUS:    return makeReal(common, a->real - b->real);
+            case TokenType::MULTIPLY: return makeReal(common, a->real * b->real);
+            case TokenType::DIVIDE:   return makeReal(common, a->real / b->real);
+            default:                  return std::nullopt;
+        }
+    }
+
+    uint64_t x = static_cast<uint64_t>(a->integer);
+    uint64_t y = static_cast<uint64_t>(b->integer);
+    int64_t signed_x = asSigned(a->integer, width);
+    int64_t signed_y = asSigned(b->integer, width);
+
+    switch (op) {
+        case TokenType::PLUS:
+            return makeInteger(common, x + y);
+        case TokenType::MINUS:
+            return makeInteger(common, x - y);
+        case TokenType::MULTIPLY:
+            return makeInteger(common, x * y);
+        case TokenType::DIVIDE:
+        case TokenType::MODULO: {
+            // Division by zero and the one overflowing quotient are undefined at runtime
+            int64_t min_value = asSigned(static_cast<int64_t>(uint64_t(1) << (width - 1)), width);
+            if (signed_y == 0 || (signed_x == min_value && signed_y == -1)) {
+                return std::nullopt;
+            }
+            int64_t value = op == TokenType::DIVIDE ? signed_x / signed_y : signed_x % signed_y;
+            return makeInteger(common, static_cast<uint64_t>(value));
+        }
+        case TokenType::POWER: {
+            // Wrapping square-and-multiply, like the helper codegen calls
+            uint64_t value = 1;
+            for (uint64_t square = x, bits = y & widthMask(width); bits != 0; bits >>= 1, square *= square) {
+                if (bits & 1) {
+                    value *= square;
+                }
+            }
+            // A negative exponent truncates to 0 unless |x| is 1
+            if (primitive::isSigned(common) && signed_y < 0 && (signed_x < -1 || signed_x > 1)) {
+                value = 0;
+            }
+            return makeInteger(common, value);
+        }
+        case TokenType::BITWISE_LEFT_SHIFT:
+        case TokenType::BITWISE_RIGHT_SHIFT: {
+            // Shifting by the width or more is poison
+            uint64_t amount = y & widthMask(width);
+            if (amount >= width) {
+                return std::nullopt;
+            }
+            return makeInteger(common, op == TokenType::BITWISE_LEFT_SHIFT ? x << amount
+                                                                           : static_cast<uint64_t>(signed_x >> amount));
+        }
+        case TokenType::BITWISE_AND:
+            return makeInteger(common, x & y);
+        case TokenType::BITWISE_OR:
+            return makeInteger(common, x | y);
+        case TokenType::BITWISE_XOR:
+            return makeInteger(common, x ^ y);
+        default:
+            return std::nullopt;
+    }
+}
+
+std::optional<ConstantValue> ConstantEvaluator::shortCircuit(TokenType op, const ConstantValue& left,
+                                                             PrimitiveKind result_kind) {
+    if ((op != TokenType::LOGICAL_AND && op != TokenType::LOGICAL_OR) || result_kind != PrimitiveKind::BOOL ||
+        (left.kind != PrimitiveKind::BOOL && !primitive::isInteger(left.kind))) {
+        return std::nullopt;
+    }
+
+    bool truth = left.integer != 0;
+    if (op == TokenType::LOGICAL_AND && !truth) {
+        return makeInteger(PrimitiveKind::BOOL, 0);
+    }
+    if (op == TokenType::LOGICAL_OR && truth) {
+        return makeInteger(PrimitiveKind::BOOL, 1);
+    }
+    return std::nullopt;
+}
+
+std::optional<ConstantValue> ConstantEvaluator::applyUnary(TokenType op, const ConstantValue& operand,
+                                                           PrimitiveKind result_kind) {
+    PrimitiveKind kind = operand.kind;
+    if (result_kind != kind) {
+        return std::nullopt;
+    }
+
+    switch (op) {
+        case TokenType::MINUS:
+            if (primitive::isInteger(kind)) {
+                return makeInteger(kind, uint64_t(0) - static_cast<uint64_t>(operand.integer));
+            }
+            if (primitive::isFloat(kind)) {
+                return makeReal(kind, -operand.real);
+            }
+            return std::nullopt;
+        case TokenType::LOGICAL_NOT:
+            if (kind == PrimitiveKind::BOOL) {
+                return makeInteger(kind, operand.integer == 0);
+            }
+            return std::nullopt;
+        case TokenType::BITWISE_NOT:
+            if (primitive::isInteger(kind)) {
+                return makeInteger(kind, ~static_cast<uint64_t>(operand.integer));
+            }
+            return std::nullopt;
+        default:
+            return std::nullopt;
+    }
+}
+
+std::optional<ConstantValue> ConstantEvaluator::literalValue(const LiteralExpression& node) {
+    PrimitiveKind kind = node.resolved_type ? node.resolved_type->primitive_kind : PrimitiveKind::NONE;
+
+    switch (node.literal_token.type) {
+        case TokenType::INTEGER_LITERAL:
+            return makeInteger(primitive::isInteger(kind) ? kind : PrimitiveKind::I32,
+                               static_cast<uint64_t>(node.literal_token.int_value));
+        case TokenType::FLOAT_LITERAL:
+            return makeReal(primitive::isFloat(kind) ? kind : PrimitiveKind::F64, node.literal_token.float_value);
+        case TokenType::BOOLEAN_LITERAL:
+            return makeInteger(PrimitiveKind::BOOL, node.literal_token.bool_value);
+        default:
+            return std::nullopt;
+    }
+}
+
+void ConstantEvaluator::visit(PrimitiveType& /*node*/) {
+}
+
+void ConstantEvaluator::visit(ConstType& /*node*/) {
+}
+
+void ConstantEvaluator::visit(ArrayType& /*node*/) {
+}
+
+void ConstantEvaluator::visit(PointerType& /*node*/) {
+}
+
+void ConstantEvaluator::visit(GenericType& /*node*/) {
+}
+
+void ConstantEvaluator::visit(LiteralExpression& node) {
+    // Literals already are immediates; only their value is passed up
+    node.constant_value = nullptr;
+    result = literalValue(node);
+}
+
+void ConstantEvaluator::visit(IdentifierExpression& node) {
+    std::optional<ConstantValue> value;
+    if (node.symbol_id < constants.size() && constants[node.symbol_id]) {
+        value = *constants[node.symbol_id];
+    }
+    annotate(node, value);
+}
+
+void ConstantEvaluator::visit(BinaryExpression& node) {
+    std::optional<ConstantValue> left = fold(*node.left);
+    std::optional<ConstantValue> right = fold(*node.right);
+
+    std::optional<ConstantValue> value;
+    if (left && node.resolved_type) {
+        // `false && f()` folds whatever f returns
+        value = shortCircuit(node.operator_token, *left, node.resolved_type->primitive_kind);
+    }
+    if (!value && left && right && node.resolved_type) {
+        value = applyBinary(node.operator_token, *left, *right, node.resolved_type->primitive_kind);
+    }
+    annotate(node, value);
+}
+
+void ConstantEvaluator::visit(UnaryExpression& node) {
+    std::optional<ConstantValue> operand = fold(*node.operand);
+
+    std::optional<ConstantValue> value;
+    if (operand && node.resolved_type) {
+        value = applyUnary(node.operator_token, *operand, node.resolved_type->primitive_kind);
+    }
+    annotate(node, value);
+}
+
+void ConstantEvaluator::visit(CallExpression& node) {
+    fold(*node.callee);
+    node.constant_array = nullptr;
+
+    std::vector<ConstantValue> arguments;
+    for (auto& arg : node.arguments) {
+        if (std::optional<ConstantValue> value = fold(*arg)) {
+            arguments.push_back(*value);
+        }
+    }
+
+    // Calls of a const fn whose arguments all fold run at compile time
+    auto callee = dynamic_cast<IdentifierExpression*>(node.callee.get());
+    FunctionDeclaration* function =
+        callee && callee->symbol_id < const_functions.size() ? const_functions[callee->symbol_id] : nullptr;
+
+    std::optional<ConstantValue> value;
+    bool returns_array = node.resolved_type && node.resolved_type->kind == SemanticType::Kind::ARRAY;
+    if (function && returns_array && arguments.size() == node.arguments.size()) {
+        // Array results are emitted as constant data rather than folded into the expression
+        if (const ConstantArray* array = interpreter->callArray(*function, arguments)) {
+            node.constant_array = array;
+            evaluated_calls++;
+        } else if (error_reporter) {
+            error_reporter->reportWarning(node.location, "Call to const fn '" + function->name +
+                                          "' is left to runtime: " + interpreter->getFailure());
+        }
+    } else if (function && arguments.size() == node.arguments.size()) {
+        value = interpreter->call(*function, arguments);
+        if (value) {
+            evaluated_calls++;
+        } else if (error_reporter) {
+            error_reporter->reportWarning(node.location, "Call to const fn '" + function->name +
+                                          "' is left to runtime: " + interpreter->getFailure());
+        }
+    }
+    annotate(node, value);
+}
+
+void ConstantEvaluator::visit(MemberExpression& node) {
+    node.object->accept(*this);
+    annotate(node, std::nullopt);
+}
+
+void ConstantEvaluator::visit(IndexExpression& node) {
+    node.object->accept(*this);
+    node.index->accept(*this);
+    annotate(node, std::nullopt);
+}
+
+void ConstantEvaluator::visit(AssignmentExpression& node) {
+    node.left->accept(*this);
+    node.right->accept(*this);
+    annotate(node, std::nullopt);
+}
+
+void ConstantEvaluator::visit(PostfixExpression& node) {
+    node.operand->accept(*this);
+    annotate(node, std::nullopt);
+}
+
+void ConstantEvaluator::visit(CastExpression& node) {
+    std::optional<ConstantValue> operand = fold(*node.expression);
+
+    std::optional<ConstantValue> value;
+    if (operand && node.resolved_type) {
+        value = castValue(*operand, node.resolved_type->primitive_kind);
+    }
+    annotate(node, value);
+}
+
+void ConstantEvaluator::visit(AsExpression& node) {
+    std::optional<ConstantValue> operand = fold(*node.expression);
+
+    std::optional<ConstantValue> value;
+    if (operand && node.resolved_type) {
+        value = castValue(*operand, node.resolved_type->primitive_kind);
+    }
+    annotate(node, value);
+}
+
+void ConstantEvaluator::visit(ExpressionStatement& node) {
+    fold(*node.expression);
+}
+
+void ConstantEvaluator::visit(BlockStatement& node) {
+    for (auto& stmt : node.statements) {
+        stmt->accept(*this);
+    }
+}
+
+void ConstantEvaluator::visit(IfStatement& node) {
+    fold(*node.condition);
+    node.then_branch->accept(*this);
+
+    if (node.else_branch) {
+        node.else_branch->accept(*this);
+    }
+}
+
+void ConstantEvaluator::visit(WhileStatement& node) {
+    fold(*node.condition);
+    node.body->accept(*this);
+}
+
+void ConstantEvaluator::visit(ForStatement& node) {
+    fold(*node.iterable);
+    if (node.range_end) {
+        fold(*node.range_end);
+    }
+    if (node.step) {
+        fold(*node.step);
+    }
+    node.body->accept(*this);
+}
+
+void ConstantEvaluator::visit(ReturnStatement& node) {
+    if (node.value) {
+        fold(*node.value);
+    }
+}
+
+void ConstantEvaluator::visit(DeclarationStatement& node) {
+    if (node.declaration) {
+        node.declaration->accept(*this);
+    }
+}
+
+void ConstantEvaluator::visit(FunctionDeclaration& node) {
+    if (node.body) {
+        node.body->accept(*this);
+    }
+}
+
+void ConstantEvaluator::visit(VariableDeclaration& node) {
+    node.constant_value = nullptr;
+    if (!node.initializer) {
+        return;
+    }
+
+    std::optional<ConstantValue> value = fold(*node.initializer);
+
+    // Const declarations and immutable lets of a built-in scalar type become named constants;
+    // the TypeChecker already rejects assignments to either
+    auto const_type = dynamic_cast<ConstType*>(node.type.get());
+    if (!value || (!const_type && node.is_mutable) || node.symbol_id >= constants.size()) {
+        return;
+    }
+
+    // The initializer converts to the declared type like a cast would, or keeps the inferred one
+    PrimitiveKind declared = PrimitiveKind::NONE;
+    if (node.type) {
+        auto base_type = dynamic_cast<PrimitiveType*>(const_type ? const_type->base_type.get() : node.type.get());
+        declared = base_type ? primitive::fromName(base_type->toString()) : PrimitiveKind::NONE;
+    } else if (node.initializer->resolved_type) {
+        declared = node.initializer->resolved_type->primitive_kind;
+    }
+    if (declared == PrimitiveKind::NONE) {
+        return;
+    }
+    std::optional<ConstantValue> converted = value->kind == declared ? value : castValue(*value, declared);
+    if (!converted) {
+        return;
+    }
+
+    values.push_back(*converted);
+    node.constant_value = &values.back();
+    constants[node.symbol_id] = node.constant_value;
+    constant_declarations++;
+}
+
+void ConstantEvaluator::visit(ClassDeclaration& node) {
+    for (auto& member : node.members) {
+        if (auto field = dynamic_cast<FieldMember*>(member.get())) {
+            if (field->initializer) {
+                fold(*field->initializer);
+            }
+        } else if (auto method = dynamic_cast<MethodMember*>(member.get())) {
+            if (method->body) {
+                method->body->accept(*this);
+            }
+        }
+    }
+}
+
+void ConstantEvaluator::visit(StructDeclaration& /*node*/) {
+}
+
+void ConstantEvaluator::visit(EnumDeclaration& /*node*/) {
+}
+
+void ConstantEvaluator::visit(ImportDeclaration& /*node*/) {
+}
+
+void ConstantEvaluator::visit(Module& node) {
+    llvm::TimeTraceScope trace("Fold module", node.module_name);
+
+    // Module-level constants first, so functions declared above a constant still fold its uses
+    for (auto& decl : node.declarations) {
+        if (dynamic_cast<VariableDeclaration*>(decl.get())) {
+            decl->accept(*this);
+        }
+    }
+    for (auto& decl : node.declarations) {
+        if (!dynamic_cast<VariableDeclaration*>(decl.get())) {
+            decl->accept(*this);
+        }
+    }
+}
+
+void ConstantEvaluator::visit(Program& node) {
+    // Imported constants are folded before the modules that use them
+    ModuleGraph graph(node);
+    for (size_t index : graph.getOrder()) {
+        graph.getModule(index).accept(*this);
+    }
+}
+
+} // namespace pangea
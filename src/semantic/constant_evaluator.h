@@ -0,0 +1,152 @@
+#pragma once
+
+#include "../ast/ast_visitor.h"
+#include "../ast/ast_nodes.h"
+#include "../utils/error_reporter.h"
+#include "../utils/stats.h"
+#include "name_resolver.h"
+#include "primitive_kind.h"
+#include <deque>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace pangea {
+
+// A compile-time value of a built-in scalar type. Integers and bools are kept
+// sign- or zero-extended from their kind's width, so equal values compare equal.
+struct ConstantValue {
+    PrimitiveKind kind = PrimitiveKind::NONE;
+    int64_t integer = 0; // Integer and bool kinds
+    double real = 0.0;   // f32 and f64; f32 values are already rounded to float
+};
+
+// A fixed-size array of built-in scalars returned by a const fn, such as a lookup table
+struct ConstantArray {
+    PrimitiveKind element_kind = PrimitiveKind::NONE;
+    std::vector<ConstantValue> elements;
+};
+
+class ConstInterpreter;
+
+// Folds expressions over the typed AST: literals, arithmetic, shifts,
+// comparisons, logical and bitwise operators, casts, references to const
+// declarations whose initializers fold, and calls of `const fn`s whose
+// arguments fold, which ConstInterpreter runs. Every expression that folds gets its
+// Expression::constant_value set, so code generation can emit an immediate
+// instead of computing it. Folding follows the instructions codegen would emit
+// for the same expression, and anything that would be undefined at runtime
+// (division by zero, oversized shifts) is left unfolded.
+class ConstantEvaluator : public ASTVisitor {
+public:
+    static constexpr size_t default_const_fn_steps = 1000000;
+
+private:
+    ErrorReporter* error_reporter;
+    size_t const_fn_steps;
+
+    std::deque<ConstantValue> values; // Referenced by constant_value annotations
+
+    // Folded value of each const declaration, indexed by SymbolId
+    std::vector<const ConstantValue*> constants;
+
+    // Every const fn with a body, indexed by SymbolId
+    std::vector<FunctionDeclaration*> const_functions;
+    std::unique_ptr<ConstInterpreter> interpreter; // Also owns the arrays constant_array annotations point to
+
+    // Value of the expression just visited, if it folded
+    std::optional<ConstantValue> result;
+
+    size_t folded_expressions = 0;
+    size_t constant_declarations = 0;
+    size_t evaluated_calls = 0;
+
+public:
+    /**
+     * @param reporter Receives a warning for each const fn call that has to run at runtime
+     * @param step_budget Work one const fn call may do at compile time before it is abandoned
+     */
+    explicit ConstantEvaluator(ErrorReporter* reporter = nullptr, size_t step_budget = default_const_fn_steps);
+    ~ConstantEvaluator();
+
+    /**
+     * Annotate every foldable expression of a type-checked program
+     * @param program The program, after type checking succeeded
+     * @param declarations The declaration table NameResolver built for it
+     */
+    void evaluate(Program& program, const DeclarationTable& declarations);
+    void reportStatistics(CompilerStats& stats) const;
+
+    // Type visitors
+    void visit(PrimitiveType& node) override;
+    void visit(ConstType& node) override;
+    void visit(ArrayType& node) override;
+    void visit(PointerType& node) override;
+    void visit(GenericType& node) override;
+
+    // Expression visitors
+    void visit(LiteralExpression& node) override;
+    void visit(IdentifierExpression& node) override;
+    void visit(BinaryExpression& node) override;
+    void visit(UnaryExpression& node) override;
+    void visit(CallExpression& node) override;
+    void visit(MemberExpression& node) override;
+    void visit(IndexExpression& node) override;
+    void visit(AssignmentExpression& node) override;
+    void visit(PostfixExpression& node) override;
+    void visit(CastExpression& node) override;
+    void visit(AsExpression& node) override;
+
+    // Statement visitors
+    void visit(ExpressionStatement& node) override;
+    void visit(BlockStatement& node) override;
+    void visit(IfStatement& node) override;
+    void visit(WhileStatement& node) override;
+    void visit(ForStatement& node) override;
+    void visit(ReturnStatement& node) override;
+    void visit(DeclarationStatement& node) override;
+
+    // Declaration visitors
+    void visit(FunctionDeclaration& node) override;
+    void visit(VariableDeclaration& node) override;
+    void visit(ClassDeclaration& node) override;
+    void visit(StructDeclaration& node) override;
+    void visit(EnumDeclaration& node) override;
+    void visit(ImportDeclaration& node) override;
+
+    // Module and Program visitors
+    void visit(Module& node) override;
+    void visit(Program& node) override;
+
+    /**
+     * Convert a value the way a cast<T>/as expression does in generated code
+     * @return The converted value, or nothing if the cast cannot be folded
+     */
+    static std::optional<ConstantValue> castValue(const ConstantValue& value, PrimitiveKind to);
+
+    /**
+     * Apply a binary operator to two folded operands
+     * @param result_kind The type the checker gave the expression
+     * @return The folded value, or nothing if the operation cannot be folded
+     */
+    static std::optional<ConstantValue> applyBinary(TokenType op, const ConstantValue& left,
+                                                    const ConstantValue& right, PrimitiveKind result_kind);
+    /**
+     * Result of && or || when the left operand alone decides it, as it does in generated code
+     * @return The result, or nothing if the right operand is needed or op is another operator
+     */
+    static std::optional<ConstantValue> shortCircuit(TokenType op, const ConstantValue& left, PrimitiveKind result_kind);
+    static std::optional<ConstantValue> applyUnary(TokenType op, const ConstantValue& operand, PrimitiveKind result_kind);
+
+    // Value of a number or bool literal, typed as the checker typed it
+    static std::optional<ConstantValue> literalValue(const LiteralExpression& node);
+
+private:
+    // Visit an expression and return its value, leaving result cleared
+    std::optional<ConstantValue> fold(Expression& expr);
+
+    // Record the value of a non-literal expression
+    void annotate(Expression& expr, std::optional<ConstantValue> value);
+};
+
+} // namespace pangea
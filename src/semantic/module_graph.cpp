@@ -0,0 +1,77 @@
+#include "module_graph.h"
+#include <algorithm>
+#include <queue>
+#include <unordered_map>
+
+namespace pangea {
+
+ModuleGraph::ModuleGraph(Program& program) {
+    for (auto& module : program.modules) {
+        modules.push_back(module.get());
+    }
+    if (program.main_module) {
+        modules.push_back(program.main_module.get());
+    }
+
+    std::unordered_map<std::string, size_t> index_by_name;
+    for (size_t i = 0; i < modules.size(); ++i) {
+        index_by_name.emplace(modules[i]->module_name, i);
+    }
+
+    imports.resize(modules.size());
+    importers.resize(modules.size());
+    for (size_t i = 0; i < modules.size(); ++i) {
+        for (const auto& import_decl : modules[i]->imports) {
+            auto it = index_by_name.find(import_decl->module_path);
+            if (it == index_by_name.end() || it->second == i) {
+                continue;
+            }
+
+            // A module may import the same module more than once
+            if (std::find(imports[i].begin(), imports[i].end(), it->second) != imports[i].end()) {
+                continue;
+            }
+
+            imports[i].push_back(it->second);
+            importers[it->second].push_back(i);
+            edge_count++;
+        }
+    }
+
+    // Kahn's algorithm, always taking the lowest ready index
+    std::vector<size_t> waiting(modules.size());
+    std::vector<size_t> level(modules.size(), 1);
+    std::priority_queue<size_t, std::vector<size_t>, std::greater<size_t>> ready;
+    for (size_t i = 0; i < modules.size(); ++i) {
+        waiting[i] = imports[i].size();
+        if (waiting[i] == 0) {
+            ready.push(i);
+        }
+    }
+
+    while (!ready.empty()) {
+        size_t index = ready.top();
+        ready.pop();
+        order.push_back(index);
+        depth = std::max(depth, level[index]);
+
+        for (size_t importer : importers[index]) {
+            level[importer] = std::max(level[importer], level[index] + 1);
+            if (--waiting[importer] == 0) {
+                ready.push(importer);
+            }
+        }
+    }
+
+    // The module manager rejects import cycles; keep any leftovers in program order
+    if (order.size() < modules.size()) {
+        acyclic = false;
+        for (size_t i = 0; i < modules.size(); ++i) {
+            if (waiting[i] > 0) {
+                order.push_back(i);
+            }
+        }
+    }
+}
+
+} // namespace pangea
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "../ast/ast_nodes.h"
+#include <vector>
+
+namespace pangea {
+
+// Import graph of a program, built from each module's ImportDeclarations.
+// Nodes are Program::modules in order followed by the main module. Imports of
+// modules that are not part of the program are ignored.
+class ModuleGraph {
+private:
+    std::vector<Module*> modules;
+    std::vector<std::vector<size_t>> imports;   // Modules each module imports
+    std::vector<std::vector<size_t>> importers; // Modules importing each module
+    std::vector<size_t> order;                  // Every module after all of its imports
+    size_t edge_count = 0;
+    size_t depth = 0;
+    bool acyclic = true;
+
+public:
+    explicit ModuleGraph(Program& program);
+
+    size_t size() const { return modules.size(); }
+    Module& getModule(size_t index) const { return *modules[index]; }
+    const std::vector<size_t>& getImports(size_t index) const { return imports[index]; }
+    const std::vector<size_t>& getImporters(size_t index) const { return importers[index]; }
+
+    /**
+     * Deterministic topological order; ties keep the order of Program::modules
+     * @return Module indices, each after every module it imports
+     */
+    const std::vector<size_t>& getOrder() const { return order; }
+
+    // False only for import cycles, which the module manager normally rejects
+    bool isAcyclic() const { return acyclic; }
+    size_t getEdgeCount() const { return edge_count; }
+    // Modules on the longest import chain, the minimum number of sequential steps to check them all
+    size_t getDepth() const { return depth; }
+};
+
+} // namespace pangea
@@ -0,0 +1,343 @@
+#include "name_resolver.h"
+#include <algorithm>
+#include <llvm/Support/TimeProfiler.h>
+
+namespace pangea {
+
+void NameResolver::resolve(Program& program) {
+    program.accept(*this);
+}
+
+void NameResolver::reportStatistics(CompilerStats& stats) const {
+    size_t exported_symbols = 0;
+    for (const auto& [module_name, exports] : exports_by_module) {
+        exported_symbols += exports.size();
+    }
+
+    stats.set("resolve.declarations", declarations.size());
+    stats.set("resolve.module-level symbols", module_level_symbols);
+    stats.set("resolve.exported symbols", exported_symbols);
+    stats.set("resolve.lazily bound imports", lazily_bound_imports);
+    stats.set("resolve.resolved references", resolved_references);
+    stats.set("resolve.unresolved references", unresolved_references);
+}
+
+SymbolId NameResolver::declare(const std::string& name, SymbolKind kind, const SourceLocation& location, bool is_exported) {
+    SymbolId id = declarations.add(DeclarationInfo{name, kind, current_module_name, is_exported, location});
+    scopes.define(name, id);
+
+    if (scopes.depth() == 0) {
+        module_level_symbols++;
+    }
+    return id;
+}
+
+void NameResolver::visit(PrimitiveType& /*node*/) {
+    // Type names are not bound to declarations yet
+}
+
+void NameResolver::visit(ConstType& /*node*/) {
+}
+
+void NameResolver::visit(ArrayType& /*node*/) {
+}
+
+void NameResolver::visit(PointerType& /*node*/) {
+}
+
+void NameResolver::visit(GenericType& /*node*/) {
+}
+
+void NameResolver::visit(LiteralExpression& /*node*/) {
+}
+
+void NameResolver::visit(IdentifierExpression& node) {
+    const SymbolId* id = scopes.lookup(node.name);
+    if (!id) {
+        id = lookupImport(node.name);
+    }
+    node.symbol_id = id ? *id : NO_SYMBOL;
+
+    if (id) {
+        declarations.addReference(*id);
+        resolved_references++;
+    } else {
+        unresolved_references++;
+    }
+}
+
+void NameResolver::visit(BinaryExpression& node) {
+    node.left->accept(*this);
+    node.right->accept(*this);
+}
+
+void NameResolver::visit(UnaryExpression& node) {
+    node.operand->accept(*this);
+}
+
+void NameResolver::visit(CallExpression& node) {
+    node.callee->accept(*this);
+
+    for (auto& arg : node.arguments) {
+        arg->accept(*this);
+    }
+}
+
+void NameResolver::visit(MemberExpression& node) {
+    // Member names are resolved against the object's type, not the scope
+    node.object->accept(*this);
+}
+
+void NameResolver::visit(IndexExpression& node) {
+    node.object->accept(*this);
+    node.index->accept(*this);
+}
+
+void NameResolver::visit(AssignmentExpression& node) {
+    node.left->accept(*this);
+    node.right->accept(*this);
+}
+
+void NameResolver::visit(PostfixExpression& node) {
+    node.operand->accept(*this);
+}
+
+void NameResolver::visit(CastExpression& node) {
+    node.expression->accept(*this);
+}
+
+void NameResolver::visit(AsExpression& node) {
+    node.expression->accept(*this);
+}
+
+void NameResolver::visit(ExpressionStatement& node) {
+    node.expression->accept(*this);
+}
+
+void NameResolver::visit(BlockStatement& node) {
+    scopes.enterScope();
+
+    for (auto& stmt : node.statements) {
+        stmt->accept(*this);
+    }
+
+    scopes.exitScope();
+}
+
+void NameResolver::visit(IfStatement& node) {
+    unwrapBranchHint(node.condition, node.hint);
+    node.condition->accept(*this);
+    node.then_branch->accept(*this);
+
+    if (node.else_branch) {
+        node.else_branch->accept(*this);
+    }
+}
+
+void NameResolver::visit(WhileStatement& node) {
+    unwrapBranchHint(node.condition, node.hint);
+    node.condition->accept(*this);
+    node.body->accept(*this);
+}
+
+void NameResolver::visit(ForStatement& node) {
+    node.iterable->accept(*this);
+    if (node.range_end) {
+        node.range_end->accept(*this);
+    }
+    if (node.step) {
+        node.step->accept(*this);
+    }
+
+    scopes.enterScope();
+    node.iterator_symbol_id = declare(node.iterator_name, SymbolKind::ITERATOR, node.location);
+    node.body->accept(*this);
+    scopes.exitScope();
+}
+
+void NameResolver::visit(ReturnStatement& node) {
+    if (node.value) {
+        node.value->accept(*this);
+    }
+}
+
+void NameResolver::visit(DeclarationStatement& node) {
+    if (node.declaration) {
+        node.declaration->accept(*this);
+    }
+}
+
+void NameResolver::visit(FunctionDeclaration& node) {
+    // Declared before the body so functions can call themselves
+    node.symbol_id = declare(node.name, SymbolKind::FUNCTION, node.location, node.is_exported);
+
+    if (!node.is_foreign && node.body) {
+        scopes.enterScope();
+
+        for (auto& param : node.parameters) {
+            param.symbol_id = declare(param.name, SymbolKind::PARAMETER, param.location);
+        }
+
+        node.body->accept(*this);
+
+        scopes.exitScope();
+    }
+}
+
+void NameResolver::visit(VariableDeclaration& node) {
+    // The initializer cannot see the variable it initializes
+    if (node.initializer) {
+        node.initializer->accept(*this);
+    }
+
+    if (scopes.isDefinedInCurrentScope(node.name)) {
+        node.symbol_id = NO_SYMBOL;
+        return;
+    }
+
+    node.symbol_id = declare(node.name, SymbolKind::VARIABLE, node.location, node.is_exported);
+}
+
+void NameResolver::visit(ClassDeclaration& node) {
+    // The class name doubles as its constructor
+    node.symbol_id = declare(node.name, SymbolKind::CLASS, node.location);
+
+    scopes.enterScope();
+
+    for (auto& member : node.members) {
+        auto method = dynamic_cast<MethodMember*>(member.get());
+        if (!method) {
+            continue;
+        }
+
+        method->symbol_id = declare(method->name, SymbolKind::METHOD, method->location);
+
+        scopes.enterScope();
+
+        bool has_self_param = false;
+        for (auto& param : method->parameters) {
+            param.symbol_id = declare(param.name, SymbolKind::PARAMETER, param.location);
+            has_self_param = has_self_param || param.name == "self";
+        }
+
+        // Constructors get an implicit 'self' when they don't take one
+        if (method->name == node.name && !has_self_param) {
+            method->self_symbol_id = declare("self", SymbolKind::SELF, method->location);
+        }
+
+        method->body->accept(*this);
+
+        scopes.exitScope();
+    }
+
+    scopes.exitScope();
+}
+
+void NameResolver::visit(StructDeclaration& node) {
+    node.symbol_id = declare(node.name, SymbolKind::STRUCT, node.location);
+}
+
+void NameResolver::visit(EnumDeclaration& node) {
+    node.symbol_id = declare(node.name, SymbolKind::ENUM, node.location);
+
+    for (auto& variant : node.variants) {
+        variant.symbol_id = declare(variant.name, SymbolKind::ENUM_VARIANT, variant.location);
+    }
+}
+
+void NameResolver::visit(ImportDeclaration& /*node*/) {
+    // Imported names are bound on first use by lookupImport
+}
+
+void NameResolver::visit(Module& node) {
+    llvm::TimeTraceScope trace("Resolve module", node.module_name);
+
+    current_module_name = node.module_name;
+    current_module = &node;
+
+    // Module-level declarations form the outermost scope; imports are consulted after it
+    scopes.clear();
+    imported_names.clear();
+
+    for (auto& decl : node.declarations) {
+        decl->accept(*this);
+    }
+
+    collectModuleExports(node);
+}
+
+void NameResolver::visit(Program& node) {
+    // Every module's exports are collected before any importer is resolved
+    ModuleGraph graph(node);
+    for (size_t index : graph.getOrder()) {
+        graph.getModule(index).accept(*this);
+    }
+}
+
+void NameResolver::collectModuleExports(const Module& node) {
+    std::unordered_map<std::string, SymbolId> module_exports;
+
+    for (const auto& decl : node.declarations) {
+        if (auto function = dynamic_cast<const FunctionDeclaration*>(decl.get())) {
+            if (function->is_exported && function->symbol_id != NO_SYMBOL) {
+                module_exports[function->name] = function->symbol_id;
+            }
+        } else if (auto variable = dynamic_cast<const VariableDeclaration*>(decl.get())) {
+            if (variable->is_exported && variable->symbol_id != NO_SYMBOL) {
+                module_exports[variable->name] = variable->symbol_id;
+            }
+        }
+    }
+
+    exports_by_module[node.module_name] = std::move(module_exports);
+}
+
+const SymbolId* NameResolver::lookupImport(const std::string& name) {
+    auto cached = imported_names.find(name);
+    if (cached != imported_names.end()) {
+        return &cached->second;
+    }
+
+    if (!current_module) {
+        return nullptr;
+    }
+
+    // Later imports take precedence over earlier ones
+    for (auto it = current_module->imports.rbegin(); it != current_module->imports.rend(); ++it) {
+        const ImportDeclaration& import_decl = **it;
+        if (!import_decl.is_wildcard &&
+            std::find(import_decl.imported_items.begin(), import_decl.imported_items.end(), name) == import_decl.imported_items.end()) {
+            continue;
+        }
+
+        auto exports_it = exports_by_module.find(import_decl.module_path);
+        if (exports_it == exports_by_module.end()) {
+            continue;
+        }
+
+        auto export_it = exports_it->second.find(name);
+        if (export_it != exports_it->second.end()) {
+            lazily_bound_imports++;
+            return &imported_names.emplace(name, export_it->second).first->second;
+        }
+    }
+
+    return nullptr;
+}
+
+void NameResolver::unwrapBranchHint(std::unique_ptr<Expression>& condition, BranchHint& hint) {
+    // Only recognized around a whole condition; a user's own likely/unlikely is an ordinary call
+    auto call = dynamic_cast<CallExpression*>(condition.get());
+    auto callee = call ? dynamic_cast<IdentifierExpression*>(call->callee.get()) : nullptr;
+    if (!callee || call->arguments.size() != 1 || (callee->name != "likely" && callee->name != "unlikely")) {
+        return;
+    }
+    if (scopes.lookup(callee->name) || lookupImport(callee->name)) {
+        return;
+    }
+
+    hint = callee->name == "likely" ? BranchHint::LIKELY : BranchHint::UNLIKELY;
+    condition = std::move(call->arguments.front());
+}
+
+} // namespace pangea
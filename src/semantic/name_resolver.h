@@ -0,0 +1,145 @@
+#pragma once
+
+#include "../ast/ast_visitor.h"
+#include "../ast/ast_nodes.h"
+#include "module_graph.h"
+#include "../utils/scoped_symbol_table.h"
+#include "../utils/stats.h"
+#include <unordered_map>
+#include <string>
+#include <vector>
+
+namespace pangea {
+
+enum class SymbolKind {
+    FUNCTION,
+    VARIABLE,
+    PARAMETER,
+    ITERATOR,
+    CLASS,
+    METHOD,
+    SELF,
+    STRUCT,
+    ENUM,
+    ENUM_VARIANT
+};
+
+// One entry per declaration in the program, indexed by SymbolId
+struct DeclarationInfo {
+    std::string name;
+    SymbolKind kind;
+    std::string module_name;
+    bool is_exported;
+    SourceLocation location;
+    uint32_t references = 0; // Identifiers bound to this declaration
+};
+
+class DeclarationTable {
+private:
+    std::vector<DeclarationInfo> declarations;
+
+public:
+    SymbolId add(DeclarationInfo info) {
+        declarations.push_back(std::move(info));
+        return static_cast<SymbolId>(declarations.size() - 1);
+    }
+
+    const DeclarationInfo& operator[](SymbolId id) const { return declarations[id]; }
+    size_t size() const { return declarations.size(); }
+
+    void addReference(SymbolId id) { declarations[id].references++; }
+
+    // Declarations nothing refers to (e.g. unused foreign functions) need not be materialized
+    bool isReferenced(SymbolId id) const { return id != NO_SYMBOL && declarations[id].references > 0; }
+};
+
+// Binds every identifier to its declaration before type checking.
+// Declarations get dense SymbolIds and each IdentifierExpression records the id it
+// refers to, so later passes index tables by id instead of looking names up.
+// Modules are resolved in import order. Each module sees its own declarations and
+// the exported names of the modules it imports, which its declarations may shadow;
+// blocks, functions and loops open nested scopes. Imported names are bound on
+// first reference, so a module importing a large header only pays for what it uses.
+// Unresolved names are left as NO_SYMBOL for the type checker to report.
+class NameResolver : public ASTVisitor {
+private:
+    DeclarationTable declarations;
+    ScopedSymbolTable<SymbolId> scopes;
+    std::string current_module_name;
+
+    // Module -> name -> id of every declaration the module exports
+    std::unordered_map<std::string, std::unordered_map<std::string, SymbolId>> exports_by_module;
+
+    // Imports of the module being resolved, and the imported names it has used so far
+    const Module* current_module = nullptr;
+    std::unordered_map<std::string, SymbolId> imported_names;
+
+    size_t module_level_symbols = 0;
+    size_t lazily_bound_imports = 0;
+    size_t resolved_references = 0;
+    size_t unresolved_references = 0;
+
+public:
+    NameResolver() = default;
+
+    void resolve(Program& program);
+    const DeclarationTable& getDeclarations() const { return declarations; }
+    void reportStatistics(CompilerStats& stats) const;
+
+    // Type visitors
+    void visit(PrimitiveType& node) override;
+    void visit(ConstType& node) override;
+    void visit(ArrayType& node) override;
+    void visit(PointerType& node) override;
+    void visit(GenericType& node) override;
+
+    // Expression visitors
+    void visit(LiteralExpression& node) override;
+    void visit(IdentifierExpression& node) override;
+    void visit(BinaryExpression& node) override;
+    void visit(UnaryExpression& node) override;
+    void visit(CallExpression& node) override;
+    void visit(MemberExpression& node) override;
+    void visit(IndexExpression& node) override;
+    void visit(AssignmentExpression& node) override;
+    void visit(PostfixExpression& node) override;
+    void visit(CastExpression& node) override;
+    void visit(AsExpression& node) override;
+
+    // Statement visitors
+    void visit(ExpressionStatement& node) override;
+    void visit(BlockStatement& node) override;
+    void visit(IfStatement& node) override;
+    void visit(WhileStatement& node) override;
+    void visit(ForStatement& node) override;
+    void visit(ReturnStatement& node) override;
+    void visit(DeclarationStatement& node) override;
+
+    // Declaration visitors
+    void visit(FunctionDeclaration& node) override;
+    void visit(VariableDeclaration& node) override;
+    void visit(ClassDeclaration& node) override;
+    void visit(StructDeclaration& node) override;
+    void visit(EnumDeclaration& node) override;
+    void visit(ImportDeclaration& node) override;
+
+    // Module and Program visitors
+    void visit(Module& node) override;
+    void visit(Program& node) override;
+
+private:
+    SymbolId declare(const std::string& name, SymbolKind kind, const SourceLocation& location, bool is_exported = false);
+
+    void collectModuleExports(const Module& node);
+    const SymbolId* lookupImport(const std::string& name);
+
+    /**
+     * Turn an if/while condition written as `likely(c)` or `unlikely(c)` into `c`
+     * @param condition The whole condition, replaced by `c` when it is a hint
+     * @param hint Set to the hint's direction
+     * Only applies when the name does not resolve to a user declaration
+     */
+    void unwrapBranchHint(std::unique_ptr<Expression>& condition, BranchHint& hint);
+};
+
+} // namespace pangea
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace pangea {
+
+// Built-in scalar types. The numeric kinds form the promotion lattice below,
+// which is evaluated at compile time and shared by the type checker and the
+// code generator, so neither has to compare type names.
+enum class PrimitiveKind : uint8_t {
+    NONE, // Not a built-in scalar
+    I8, I16, I32, I64,
+    U8, U16, U32, U64,
+    F32, F64,
+    BOOL,
+    COUNT
+};
+
+// How a value of one numeric kind becomes another
+enum class NumericConversion : uint8_t {
+    ILLEGAL,   // At least one side is not numeric
+    IDENTITY,
+    SIGN_EXTEND,
+    ZERO_EXTEND,
+    TRUNCATE,  // Also used for same-width integers of different signedness (a no-op)
+    SIGNED_TO_FLOAT,
+    UNSIGNED_TO_FLOAT,
+    FLOAT_TO_SIGNED,
+    FLOAT_TO_UNSIGNED,
+    FLOAT_EXTEND,
+    FLOAT_TRUNCATE
+};
+
+namespace primitive {
+
+struct KindInfo {
+    std::string_view name;
+    uint8_t bits;
+    uint8_t rank; // Promotion rank, higher is wider; 0 for non-numeric kinds
+    bool is_integer;
+    bool is_signed;
+    bool is_float;
+};
+
+inline constexpr size_t kind_count = static_cast<size_t>(PrimitiveKind::COUNT);
+
+inline constexpr std::array<KindInfo, kind_count> kind_info = {{
+    {"",     0,  0, false, false, false},
+    {"i8",   8,  1, true,  true,  false},
+    {"i16",  16, 2, true,  true,  false},
+    {"i32",  32, 3, true,  true,  false},
+    {"i64",  64, 4, true,  true,  false},
+    {"u8",   8,  1, true,  false, false},
+    {"u16",  16, 2, true,  false, false},
+    {"u32",  32, 3, true,  false, false},
+    {"u64",  64, 4, true,  false, false},
+    {"f32",  32, 5, false, true,  true},
+    {"f64",  64, 6, false, true,  true},
+    {"bool", 1,  0, false, false, false},
+}};
+
+constexpr const KindInfo& info(PrimitiveKind kind) { return kind_info[static_cast<size_t>(kind)]; }
+constexpr std::string_view name(PrimitiveKind kind) { return info(kind).name; }
+constexpr bool isInteger(PrimitiveKind kind) { return info(kind).is_integer; }
+constexpr bool isFloat(PrimitiveKind kind) { return info(kind).is_float; }
+constexpr bool isNumeric(PrimitiveKind kind) { return info(kind).rank != 0; }
+constexpr bool isSigned(PrimitiveKind kind) { return info(kind).is_signed; }
+constexpr unsigned bitWidth(PrimitiveKind kind) { return info(kind).bits; }
+constexpr int rank(PrimitiveKind kind) { return info(kind).rank; }
+
+/**
+ * Look up a built-in scalar by its source name
+ * @param type_name Name as written in Pangea source, e.g. "u16"
+ * @return The kind, or NONE for any other name
+ */
+constexpr PrimitiveKind fromName(std::string_view type_name) {
+    for (size_t i = 1; i < kind_count; ++i) {
+        if (kind_info[i].name == type_name) {
+            return static_cast<PrimitiveKind>(i);
+        }
+    }
+    return PrimitiveKind::NONE;
+}
+
+// Usual arithmetic conversions: any float operand makes the result the widest
+// float involved, otherwise the wider integer wins and ties go to the left operand
+constexpr PrimitiveKind computeCommonKind(PrimitiveKind a, PrimitiveKind b) {
+    if (!isNumeric(a) || !isNumeric(b)) {
+        return PrimitiveKind::NONE;
+    }
+    if (isFloat(a) || isFloat(b)) {
+        return a == PrimitiveKind::F64 || b == PrimitiveKind::F64 ? PrimitiveKind::F64 : PrimitiveKind::F32;
+    }
+    return rank(a) >= rank(b) ? a : b;
+}
+
+constexpr NumericConversion computeConversion(PrimitiveKind from, PrimitiveKind to) {
+    if (!isNumeric(from) || !isNumeric(to)) {
+        return NumericConversion::ILLEGAL;
+    }
+    if (from == to) {
+        return NumericConversion::IDENTITY;
+    }
+    if (isFloat(from) && isFloat(to)) {
+        return bitWidth(from) < bitWidth(to) ? NumericConversion::FLOAT_EXTEND : NumericConversion::FLOAT_TRUNCATE;
+    }
+    if (isFloat(to)) {
+        return isSigned(from) ? NumericConversion::SIGNED_TO_FLOAT : NumericConversion::UNSIGNED_TO_FLOAT;
+    }
+    if (isFloat(from)) {
+        return isSigned(to) ? NumericConversion::FLOAT_TO_SIGNED : NumericConversion::FLOAT_TO_UNSIGNED;
+    }
+    if (bitWidth(from) < bitWidth(to)) {
+        return isSigned(from) ? NumericConversion::SIGN_EXTEND : NumericConversion::ZERO_EXTEND;
+    }
+    return NumericConversion::TRUNCATE;
+}
+
+template <typename T, T (*compute)(PrimitiveKind, PrimitiveKind)>
+constexpr std::array<std::array<T, kind_count>, kind_count> buildTable() {
+    std::array<std::array<T, kind_count>, kind_count> table{};
+    for (size_t a = 0; a < kind_count; ++a) {
+        for (size_t b = 0; b < kind_count; ++b) {
+            table[a][b] = compute(static_cast<PrimitiveKind>(a), static_cast<PrimitiveKind>(b));
+        }
+    }
+    return table;
+}
+
+inline constexpr auto common_kind_table = buildTable<PrimitiveKind, computeCommonKind>();
+inline constexpr auto conversion_table = buildTable<NumericConversion, computeConversion>();
+
+/**
+ * Result type of an arithmetic operation on two numeric kinds
+ * @return The common kind, or NONE if either operand is not numeric
+ */
+constexpr PrimitiveKind commonKind(PrimitiveKind a, PrimitiveKind b) {
+    return common_kind_table[static_cast<size_t>(a)][static_cast<size_t>(b)];
+}
+
+constexpr NumericConversion conversion(PrimitiveKind from, PrimitiveKind to) {
+    return conversion_table[static_cast<size_t>(from)][static_cast<size_t>(to)];
+}
+
+// Every numeric conversion is implicit, narrowing ones included; narrowing is not diagnosed
+constexpr bool isImplicitlyConvertible(PrimitiveKind from, PrimitiveKind to) {
+    return conversion(from, to) != NumericConversion::ILLEGAL;
+}
+
+static_assert(fromName("u32") == PrimitiveKind::U32 && fromName("string") == PrimitiveKind::NONE);
+static_assert(commonKind(PrimitiveKind::I8, PrimitiveKind::I64) == PrimitiveKind::I64);
+static_assert(commonKind(PrimitiveKind::U32, PrimitiveKind::I32) == PrimitiveKind::U32);
+static_assert(commonKind(PrimitiveKind::I64, PrimitiveKind::F32) == PrimitiveKind::F32);
+static_assert(commonKind(PrimitiveKind::BOOL, PrimitiveKind::I32) == PrimitiveKind::NONE);
+static_assert(conversion(PrimitiveKind::U8, PrimitiveKind::I32) == NumericConversion::ZERO_EXTEND);
+static_assert(conversion(PrimitiveKind::I16, PrimitiveKind::F64) == NumericConversion::SIGNED_TO_FLOAT);
+
+} // namespace primitive
+
+} // namespace pangea
@@ -1,212 +1,119 @@
 #include "type_checker.h"
+#include "module_graph.h"
+#include "../utils/thread_pool.h"
 #include <sstream>
 #include <unordered_set>
 #include <algorithm>
+#include <functional>
+#include <llvm/Support/TimeProfiler.h>
 
 namespace pangea {
 
-// SemanticType implementation
-bool SemanticType::isCompatibleWith(const SemanticType& other) const {
-    if (kind == Kind::ERROR_TYPE || other.kind == Kind::ERROR_TYPE) {
-        return false;
-    }
-    
-    // Exact type match
-    if (kind == other.kind && name == other.name) {
-        switch (kind) {
-            case Kind::PRIMITIVE:
-            case Kind::VOID_TYPE:
-                return true;
-                
-            case Kind::ARRAY:
-                return element_type && other.element_type && 
-                       element_type->isCompatibleWith(*other.element_type);
-                       
-            case Kind::POINTER:
-                return element_type && other.element_type && 
-                       element_type->isCompatibleWith(*other.element_type);
-                       
-            case Kind::FUNCTION:
-                if (!return_type || !other.return_type || 
-                    !return_type->isCompatibleWith(*other.return_type)) {
-                    return false;
-                }
-                if (parameter_types.size() != other.parameter_types.size()) {
-                    return false;
-                }
-                for (size_t i = 0; i < parameter_types.size(); ++i) {
-                    if (!parameter_types[i]->isCompatibleWith(*other.parameter_types[i])) {
-                        return false;
-                    }
-                }
-                return true;
-                
-            default:
-                return false;
-        }
-    }
-    
-    // Allow implicit numeric conversions for compatibility
-    if (kind == Kind::PRIMITIVE && other.kind == Kind::PRIMITIVE) {
-        // Both are numeric types - allow implicit conversions
-        if ((isNumberType() || isFloatingPointType()) && 
-            (other.isNumberType() || other.isFloatingPointType())) {
-            return true;
-        }
-    }
-    
-    return false;
+// TypeChecker implementation
+TypeChecker::TypeChecker(ErrorReporter* reporter, bool enable_builtins) 
+    : error_reporter(reporter), owned_types(std::make_unique<TypeContext>()),
+      types(*owned_types), symbols(owned_symbols) {
+    initializeBuiltinTypes();
 }
 
-bool SemanticType::isNumberType() const {
-    if (kind == Kind::ERROR_TYPE) return false;
-
-    // Primitive integer names
-    static const std::unordered_set<std::string> integer_names = {
-        "i8", "i16", "i32", "i64",
-        "u8", "u16", "u32", "u64"
-    };
-
-    if (kind == Kind::PRIMITIVE && integer_names.contains(name))
-        return true;
-    
-
-    // If it's a typedef / alias, check underlying type
-    if (element_type)
-        return element_type->isNumberType();
-    
-    return false;
+TypeChecker::TypeChecker(TypeChecker& parent)
+    : error_reporter(parent.error_reporter), types(parent.types), symbols(parent.symbols),
+      declarations(parent.declarations) {
 }
 
-bool SemanticType::isFloatingPointType() const {
-    if (kind == Kind::ERROR_TYPE) return false;
+void TypeChecker::analyze(Program& program, const DeclarationTable& declaration_table, ThreadPool* pool) {
+    declarations = &declaration_table;
+    symbols.assign(declaration_table.size(), Symbol());
 
-    // Primitive floating-point names
-    static const std::unordered_set<std::string> float_names = {
-        "f32", "f64"
-    };
+    ModuleGraph graph(program);
+    std::vector<ModuleCheck> checks(graph.size());
+    checked_modules = graph.size();
+    module_import_edges = graph.getEdgeCount();
+    module_graph_depth = graph.getDepth();
+    function_bodies = 0;
 
-    if (kind == Kind::PRIMITIVE && float_names.contains(name))
-        return true;
+    if (pool && graph.isAcyclic()) {
+        body_check_workers = pool->size();
 
-    // If it's a typedef / alias, check underlying type
-    if (element_type)
-        return element_type->isFloatingPointType();
+        // A module starts once every module it imports has published its declarations;
+        // its bodies then fan out while importers of the module get scheduled
+        std::function<void(size_t)> schedule_module = [&](size_t index) {
+            pool->submit([&, index] {
+                ModuleCheck& check = checks[index];
+                checkModuleDeclarations(graph.getModule(index), check);
 
-    return false;
-}
+                for (size_t i = 0; i < check.bodies.size(); ++i) {
+                    pool->submit([this, &check, i] { checkPendingBody(check, i); });
+                }
 
-std::string SemanticType::toString() const {
-    switch (kind) {
-        case Kind::PRIMITIVE:
-        case Kind::VOID_TYPE:
-            return name;
-        
-        case Kind::ARRAY:
-            return "[" + (element_type ? element_type->toString() : "unknown") + "]";
-        
-        case Kind::POINTER:
-            return "*" + (element_type ? element_type->toString() : "unknown");
-        
-        case Kind::FUNCTION: {
-            std::ostringstream oss;
-            oss << "fn(";
-            for (size_t i = 0; i < parameter_types.size(); ++i) {
-                if (i > 0) oss << ", ";
-                oss << parameter_types[i]->toString();
+                for (size_t importer : graph.getImporters(index)) {
+                    if (checks[importer].waiting_imports.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        schedule_module(importer);
+                    }
+                }
+            });
+        };
+
+        for (size_t index = 0; index < graph.size(); ++index) {
+            checks[index].waiting_imports.store(graph.getImports(index).size(), std::memory_order_relaxed);
+        }
+        for (size_t index : graph.getOrder()) {
+            if (graph.getImports(index).empty()) {
+                schedule_module(index);
+            }
+        }
+        pool->wait();
+    } else {
+        body_check_workers = 1;
+        for (size_t index : graph.getOrder()) {
+            ModuleCheck& check = checks[index];
+            checkModuleDeclarations(graph.getModule(index), check);
+            for (size_t i = 0; i < check.bodies.size(); ++i) {
+                checkPendingBody(check, i);
             }
-            oss << ") -> " << (return_type ? return_type->toString() : "unknown");
-            return oss.str();
         }
-        
-        case Kind::ERROR_TYPE:
-            return "<error>";
-        
-        default:
-            return "<unknown>";
     }
-}
-
-std::unique_ptr<SemanticType> SemanticType::createPrimitive(const std::string& name, bool is_const) {
-    return std::make_unique<SemanticType>(Kind::PRIMITIVE, name, is_const);
-}
 
-std::unique_ptr<SemanticType> SemanticType::createArray(std::unique_ptr<SemanticType> element, bool is_const) {
-    auto type = std::make_unique<SemanticType>(Kind::ARRAY, "Array", is_const);
-    type->element_type = std::move(element);
-    type->is_const = is_const;
-    return type;
-}
-
-std::unique_ptr<SemanticType> SemanticType::createPointer(
-    std::unique_ptr<SemanticType> pointee,
-    TokenType kind,
-    bool is_const
-) {
-    auto type = std::make_unique<SemanticType>(Kind::POINTER);
-    type->element_type = std::move(pointee);
-    type->is_const = is_const;
-
-    // Store pointer kind as name or a dedicated field
-    switch (kind) {
-        case TokenType::CPTR:   type->name = "cptr"; break;
-        case TokenType::UNIQUE: type->name = "unique_ptr"; break;
-        case TokenType::SHARED: type->name = "shared_ptr"; break;
-        case TokenType::WEAK:   type->name = "weak_ptr"; break;
-        default:                type->name = "<error_ptr>"; break;
-    }
-
-    return type;
-}
-
-
-std::unique_ptr<SemanticType> SemanticType::createFunction(
-    std::vector<std::unique_ptr<SemanticType>> params,
-    std::unique_ptr<SemanticType> ret_type) {
-    auto type = std::make_unique<SemanticType>(Kind::FUNCTION);
-    type->parameter_types = std::move(params);
-    type->return_type = std::move(ret_type);
-    return type;
+    skipped_foreign_functions = 0;
+    for (const auto& check : checks) {
+        function_bodies += check.bodies.size();
+        skipped_foreign_functions += check.skipped_foreign_functions;
+    }
 }
 
-std::unique_ptr<SemanticType> SemanticType::createVoid() {
-    return std::make_unique<SemanticType>(Kind::VOID_TYPE, "void");
-}
+void TypeChecker::checkModuleDeclarations(Module& module, ModuleCheck& check) {
+    // Past the error limit nothing more would be shown; importers still get scheduled but stop here too
+    if (error_reporter && error_reporter->shouldStop()) {
+        return;
+    }
 
-std::unique_ptr<SemanticType> SemanticType::createError() {
-    return std::make_unique<SemanticType>(Kind::ERROR_TYPE, "<error>");
-}
+    TypeChecker worker(*this);
+    worker.defer_function_bodies = true;
+    module.accept(worker);
 
-// Scope implementation
-void Scope::define(const std::string& name, std::unique_ptr<Symbol> symbol) {
-    symbols[name] = std::move(symbol);
+    check.bodies = std::move(worker.pending_bodies);
+    check.skipped_foreign_functions = worker.skipped_foreign_functions;
 }
 
-Symbol* Scope::lookup(const std::string& name) {
-    auto it = symbols.find(name);
-    if (it != symbols.end()) {
-        return it->second.get();
-    }
-    
-    if (parent) {
-        return parent->lookup(name);
+void TypeChecker::checkPendingBody(ModuleCheck& check, size_t index) {
+    if (error_reporter && error_reporter->shouldStop()) {
+        return;
     }
-    
-    return nullptr;
-}
 
-bool Scope::isDefined(const std::string& name) const {
-    return symbols.find(name) != symbols.end();
+    const PendingBody& pending = check.bodies[index];
+    TypeChecker worker(*this);
+    worker.current_module_name = pending.module_name;
+    worker.checkFunctionBody(*pending.function, pending.return_type);
 }
 
-// TypeChecker implementation
-TypeChecker::TypeChecker(ErrorReporter* reporter, bool enable_builtins) 
-    : error_reporter(reporter), global_scope(std::make_unique<Scope>()), current_scope(global_scope.get()) {
-    initializeBuiltinTypes();
-}
-
-void TypeChecker::analyze(Program& program) {
-    program.accept(*this);
+void TypeChecker::reportStatistics(CompilerStats& stats) const {
+    stats.set("semantic.checked modules", checked_modules);
+    stats.set("semantic.module import edges", module_import_edges);
+    stats.set("semantic.module graph depth", module_graph_depth);
+    stats.set("semantic.function bodies", function_bodies);
+    stats.set("semantic.skipped foreign functions", skipped_foreign_functions);
+    stats.set("semantic.body check workers", body_check_workers);
+    types.reportStatistics(stats);
 }
 
 void TypeChecker::visit(PrimitiveType& node) {
@@ -233,7 +140,7 @@ void TypeChecker::visit(PointerType& node) {
 }
 
 void TypeChecker::visit(LiteralExpression& node) {
-    std::unique_ptr<SemanticType> type;
+    const SemanticType* type = nullptr;
     
     switch (node.literal_token.type) {
         case TokenType::INTEGER_LITERAL:
@@ -259,47 +166,47 @@ void TypeChecker::visit(LiteralExpression& node) {
                 }
             }
 
-            type = SemanticType::createPrimitive(t);
+            type = types.getPrimitive(t);
             break;
         }
 
         case TokenType::FLOAT_LITERAL:
             // Default float literals to f64
-            type = SemanticType::createPrimitive("f64");
+            type = types.getPrimitive("f64");
 
             if (node.literal_token.lexeme.ends_with("f32")) {
-                type = SemanticType::createPrimitive("f32");
+                type = types.getPrimitive("f32");
             }
 
             break;
         case TokenType::BOOLEAN_LITERAL:
-            type = SemanticType::createPrimitive("bool");
+            type = types.getPrimitive("bool");
             break;
         case TokenType::STRING_LITERAL:
-            type = SemanticType::createPrimitive("string");
+            type = types.getPrimitive("string");
             break;
         case TokenType::NULL_LITERAL:
-            type = SemanticType::createPrimitive("null");
+            type = types.getPrimitive("null");
             break;
         default:
-            type = SemanticType::createError();
+            type = types.getError();
             reportTypeError(node.location, "Unknown literal type");
             break;
     }
     
-    setExpressionType(node, std::move(type));
+    setExpressionType(node, type);
 }
 
 void TypeChecker::visit(IdentifierExpression& node) {
-    Symbol* symbol = current_scope->lookup(node.name);
+    Symbol* symbol = lookupSymbol(node.symbol_id);
     if (!symbol) {
         reportTypeError(node.location, "Undefined identifier: " + node.name);
-        setExpressionType(node, SemanticType::createError());
+        setExpressionType(node, types.getError());
         return;
     }
     
     // Clone the type for this expression
-    setExpressionType(node, std::make_unique<SemanticType>(*symbol->type));
+    setExpressionType(node, symbol->type);
 }
 
 void TypeChecker::visit(BinaryExpression& node) {
@@ -310,12 +217,12 @@ void TypeChecker::visit(BinaryExpression& node) {
     auto right_type = getExpressionType(*node.right);
     
     if (!left_type || !right_type) {
-        setExpressionType(node, SemanticType::createError());
+        setExpressionType(node, types.getError());
         return;
     }
     
     
-    std::unique_ptr<SemanticType> result_type;
+    const SemanticType* result_type = nullptr;
     
     switch (node.operator_token) {
         case TokenType::PLUS:
@@ -329,28 +236,26 @@ void TypeChecker::visit(BinaryExpression& node) {
                 (right_type->isNumberType() || right_type->isFloatingPointType())) {
                 
                 // Find the common type using usual arithmetic conversions
-                std::string common_type = commonNumericTypeName(*left_type, *right_type);
-                if (!common_type.empty()) {
-                    result_type = SemanticType::createPrimitive(common_type);
+                PrimitiveKind common_kind = primitive::commonKind(left_type->primitive_kind, right_type->primitive_kind);
+                if (common_kind != PrimitiveKind::NONE) {
+                    result_type = types.getPrimitive(common_kind);
                 } else {
-                    result_type = std::make_unique<SemanticType>(*left_type);
+                    result_type = left_type;
                 }
             } else {
                 reportTypeError(node.location, "Invalid operands for arithmetic operation: " + 
                     left_type->toString() + " and " + right_type->toString());
-                result_type = SemanticType::createError();
+                result_type = types.getError();
             }
             break;
             
         case TokenType::BITWISE_LEFT_SHIFT:
         case TokenType::BITWISE_RIGHT_SHIFT:
-            if (left_type->isCompatibleWith(*right_type) && 
-                (left_type->name == "i8" || left_type->name == "i16" || left_type->name == "i32" || left_type->name == "i64" ||
-                 left_type->name == "u8" || left_type->name == "u16" || left_type->name == "u32" || left_type->name == "u64")) {
-                result_type = std::make_unique<SemanticType>(*left_type);
+            if (left_type->isCompatibleWith(*right_type) && primitive::isInteger(left_type->primitive_kind)) {
+                result_type = left_type;
             } else {
                 reportTypeError(node.location, "Invalid operands for bitwise shift operation");
-                result_type = SemanticType::createError();
+                result_type = types.getError();
             }
             break;
             
@@ -362,43 +267,40 @@ void TypeChecker::visit(BinaryExpression& node) {
         case TokenType::GREATER_EQUAL:
             if (isNullComparison(*left_type, *right_type)) {
                 // Allow comparison between pointer types and null
-                result_type = SemanticType::createPrimitive("bool");
+                result_type = types.getPrimitive(PrimitiveKind::BOOL);
             } else if ((left_type->isNumberType() || left_type->isFloatingPointType()) && 
                        (right_type->isNumberType() || right_type->isFloatingPointType())) {
                 // Allow comparison between any numeric types with implicit promotion
-                result_type = SemanticType::createPrimitive("bool");
+                result_type = types.getPrimitive(PrimitiveKind::BOOL);
             } else if (left_type->isCompatibleWith(*right_type)) {
-                result_type = SemanticType::createPrimitive("bool");
+                result_type = types.getPrimitive(PrimitiveKind::BOOL);
             } else {
                 reportTypeError(node.location, "Cannot compare incompatible types: " + 
                     left_type->toString() + " and " + right_type->toString());
-                result_type = SemanticType::createError();
+                result_type = types.getError();
             }
             break;
             
         case TokenType::LOGICAL_AND:
         case TokenType::LOGICAL_OR:
-            if (left_type->name == "bool" && right_type->name == "bool") {
-                result_type = SemanticType::createPrimitive("bool");
-            } else if (left_type->isCompatibleWith(*right_type) && 
-                      (left_type->name == "i8" || left_type->name == "i16" || left_type->name == "i32" || left_type->name == "i64" ||
-                       left_type->name == "u8" || left_type->name == "u16" || left_type->name == "u32" || left_type->name == "u64" ||
-                       left_type->name == "f32" || left_type->name == "f64")) {
+            if (left_type->primitive_kind == PrimitiveKind::BOOL && right_type->primitive_kind == PrimitiveKind::BOOL) {
+                result_type = types.getPrimitive(PrimitiveKind::BOOL);
+            } else if (left_type->isCompatibleWith(*right_type) && primitive::isNumeric(left_type->primitive_kind)) {
                 // Allow logical operators on numeric types (treat non-zero as true)
-                result_type = SemanticType::createPrimitive("bool");
+                result_type = types.getPrimitive(PrimitiveKind::BOOL);
             } else {
                 reportTypeError(node.location, "Logical operators require boolean or numeric operands");
-                result_type = SemanticType::createError();
+                result_type = types.getError();
             }
             break;
             
         default:
             reportTypeError(node.location, "Unknown binary operator");
-            result_type = SemanticType::createError();
+            result_type = types.getError();
             break;
     }
     
-    setExpressionType(node, std::move(result_type));
+    setExpressionType(node, result_type);
 }
 
 void TypeChecker::visit(UnaryExpression& node) {
@@ -406,44 +308,41 @@ void TypeChecker::visit(UnaryExpression& node) {
     
     auto operand_type = getExpressionType(*node.operand);
     if (!operand_type) {
-        setExpressionType(node, SemanticType::createError());
+        setExpressionType(node, types.getError());
         return;
     }
     
-    std::unique_ptr<SemanticType> result_type;
+    const SemanticType* result_type = nullptr;
     
     switch (node.operator_token) {
         case TokenType::MINUS:
-            if (operand_type->name == "i8" || operand_type->name == "i16" || operand_type->name == "i32" || operand_type->name == "i64" ||
-                operand_type->name == "f32" || operand_type->name == "f64") {
-                result_type = std::make_unique<SemanticType>(*operand_type);
+            if (primitive::isNumeric(operand_type->primitive_kind) && primitive::isSigned(operand_type->primitive_kind)) {
+                result_type = operand_type;
             } else {
                 reportTypeError(node.location, "Unary minus requires numeric operand");
-                result_type = SemanticType::createError();
+                result_type = types.getError();
             }
             break;
             
         case TokenType::LOGICAL_NOT:
-            if (operand_type->name == "bool") {
-                result_type = SemanticType::createPrimitive("bool");
-            } else if (operand_type->name == "i8" || operand_type->name == "i16" || operand_type->name == "i32" || operand_type->name == "i64" ||
-                       operand_type->name == "u8" || operand_type->name == "u16" || operand_type->name == "u32" || operand_type->name == "u64" ||
-                       operand_type->name == "f32" || operand_type->name == "f64") {
+            if (operand_type->primitive_kind == PrimitiveKind::BOOL) {
+                result_type = types.getPrimitive(PrimitiveKind::BOOL);
+            } else if (primitive::isNumeric(operand_type->primitive_kind)) {
                 // Logical not on numeric types: !0 = true, !nonzero = false
-                result_type = SemanticType::createPrimitive("bool");
+                result_type = types.getPrimitive(PrimitiveKind::BOOL);
             } else {
                 reportTypeError(node.location, "Logical not requires boolean or numeric operand");
-                result_type = SemanticType::createError();
+                result_type = types.getError();
             }
             break;
             
         default:
             reportTypeError(node.location, "Unknown unary operator");
-            result_type = SemanticType::createError();
+            result_type = types.getError();
             break;
     }
     
-    setExpressionType(node, std::move(result_type));
+    setExpressionType(node, result_type);
 }
 
 void TypeChecker::visit(CallExpression& node) {
@@ -460,9 +359,9 @@ void TypeChecker::visit(CallExpression& node) {
         // lets do this a bit later :)
         if (object_type) {
             // TODO: look up function signature
-            setExpressionType(node, SemanticType::createPrimitive("unknown"));
+            setExpressionType(node, types.getPrimitive("unknown"));
         } else {
-            setExpressionType(node, SemanticType::createError());
+            setExpressionType(node, types.getError());
         }
         return;
     }
@@ -470,7 +369,7 @@ void TypeChecker::visit(CallExpression& node) {
     auto callee_type = getExpressionType(*node.callee);
     if (!callee_type || callee_type->kind != SemanticType::Kind::FUNCTION) {
         reportTypeError(node.location, "Cannot call non-function");
-        setExpressionType(node, SemanticType::createError());
+        setExpressionType(node, types.getError());
         return;
     }
     
@@ -487,7 +386,7 @@ void TypeChecker::visit(CallExpression& node) {
                         "Argument type not compatible with variadic function: " + arg_type->toString());
                 }
             }
-            setExpressionType(node, std::make_unique<SemanticType>(*callee_type->return_type));
+            setExpressionType(node, callee_type->return_type);
             return;
         }
     }
@@ -495,23 +394,31 @@ void TypeChecker::visit(CallExpression& node) {
     // Check argument count for non-variadic functions
     if (node.arguments.size() != callee_type->parameter_types.size()) {
         reportTypeError(node.location, "Incorrect number of arguments");
-        setExpressionType(node, SemanticType::createError());
+        setExpressionType(node, types.getError());
         return;
     }
     
     // Check argument types with special handling for string-to-cptr conversions
     for (size_t i = 0; i < node.arguments.size(); ++i) {
         auto arg_type = getExpressionType(*node.arguments[i]);
-        auto expected_type = callee_type->parameter_types[i].get();
+        auto expected_type = callee_type->parameter_types[i];
         
         if (arg_type && !isTypeCompatibleWithParameter(*arg_type, *expected_type)) {
             reportTypeError(node.arguments[i]->location, 
                 "Argument type mismatch: expected " + expected_type->toString() +
                 ", got " + arg_type->toString());
         }
+
+        // The only pointers whose size is known here; codegen tells LLVM the parameter is dereferenceable
+        auto literal = dynamic_cast<LiteralExpression*>(node.arguments[i].get());
+        if (literal && literal->literal_token.type == TokenType::STRING_LITERAL && expected_type->length > 0 &&
+            literal->literal_token.string_value.size() + 1 < expected_type->length) {
+            reportTypeError(literal->location, "String literal of " + std::to_string(literal->literal_token.string_value.size() + 1) +
+                            " bytes is shorter than the " + std::to_string(expected_type->length) + " elements the parameter requires");
+        }
     }
     
-    setExpressionType(node, std::make_unique<SemanticType>(*callee_type->return_type));
+    setExpressionType(node, callee_type->return_type);
 }
 
 void TypeChecker::visit(MemberExpression& node) {
@@ -519,17 +426,17 @@ void TypeChecker::visit(MemberExpression& node) {
     
     auto object_type = getExpressionType(*node.object);
     if (!object_type) {
-        setExpressionType(node, SemanticType::createError());
+        setExpressionType(node, types.getError());
         return;
     }
     
     // TODO: implement member access for class instances
     // by detecting members of class programmatically
     if (false) {
-        // setExpressionType(node, SemanticType::createPrimitive(type));
+        // setExpressionType(node, types.getPrimitive(type));
     } else {
         reportTypeError(node.location, "Member access not supported for type: " + object_type->toString());
-        setExpressionType(node, SemanticType::createError());
+        setExpressionType(node, types.getError());
     }
 }
 
@@ -541,23 +448,26 @@ void TypeChecker::visit(IndexExpression& node) {
     auto index_type = getExpressionType(*node.index);
     
     if (!object_type || !index_type) {
-        setExpressionType(node, SemanticType::createError());
+        setExpressionType(node, types.getError());
         return;
     }
     
-    if (object_type->kind != SemanticType::Kind::ARRAY) {
+    // cptr<T> indexes like a C pointer
+    bool is_cptr = object_type->kind == SemanticType::Kind::POINTER && object_type->name == "cptr" &&
+                   object_type->element_type && object_type->element_type->kind != SemanticType::Kind::VOID_TYPE;
+    if (object_type->kind != SemanticType::Kind::ARRAY && !is_cptr) {
         reportTypeError(node.location, "Cannot index non-array type");
-        setExpressionType(node, SemanticType::createError());
+        setExpressionType(node, types.getError());
         return;
     }
     
-    if (!index_type->isCompatibleWith(*SemanticType::createPrimitive("int"))) {
+    if (!primitive::isInteger(index_type->primitive_kind)) {
         reportTypeError(node.location, "Array index must be integer");
-        setExpressionType(node, SemanticType::createError());
+        setExpressionType(node, types.getError());
         return;
     }
     
-    setExpressionType(node, std::make_unique<SemanticType>(*object_type->element_type));
+    setExpressionType(node, object_type->element_type);
 }
 
 void TypeChecker::visit(AssignmentExpression& node) {
@@ -568,16 +478,33 @@ void TypeChecker::visit(AssignmentExpression& node) {
     auto right_type = getExpressionType(*node.right);
     
     if (!left_type || !right_type) {
-        setExpressionType(node, SemanticType::createError());
+        setExpressionType(node, types.getError());
         return;
     }
     
     // Check if left side is assignable (for now, just check if it's an identifier)
     if (auto identifier = dynamic_cast<IdentifierExpression*>(node.left.get())) {
-        Symbol* symbol = current_scope->lookup(identifier->name);
+        Symbol* symbol = lookupSymbol(identifier->symbol_id);
         if (symbol && !symbol->is_mutable) {
             reportTypeError(node.location, "Cannot assign to immutable variable: " + identifier->name);
         }
+    } else if (auto element = dynamic_cast<IndexExpression*>(node.left.get())) {
+        // Elements of an array, unlike what a cptr points to, belong to the array's variable
+        Expression* object = element->object.get();
+        while (object->resolved_type && object->resolved_type->kind == SemanticType::Kind::ARRAY) {
+            if (auto identifier = dynamic_cast<IdentifierExpression*>(object)) {
+                Symbol* symbol = lookupSymbol(identifier->symbol_id);
+                if (symbol && !symbol->is_mutable) {
+                    reportTypeError(node.location, "Cannot assign to an element of immutable array: " + identifier->name);
+                }
+                break;
+            }
+            auto inner = dynamic_cast<IndexExpression*>(object);
+            if (!inner) {
+                break;
+            }
+            object = inner->object.get();
+        }
     }
     
     // For compound assignments, check that the operation is valid
@@ -585,29 +512,25 @@ void TypeChecker::visit(AssignmentExpression& node) {
         // For +=, -=, *=, /=, %= the types should be compatible for the underlying operation
         if (!left_type->isCompatibleWith(*right_type)) {
             reportTypeError(node.location, "Type mismatch in compound assignment");
-            setExpressionType(node, SemanticType::createError());
+            setExpressionType(node, types.getError());
             return;
         }
     } else {
         // make sure to promote right type to const if left type is const in constant assignments
-        auto promoted_right = std::make_unique<SemanticType>(*right_type);
-
-        if (left_type->is_const) {
-            promoted_right->is_const = true;
-        }
+        auto promoted_right = left_type->is_const ? types.withConst(right_type, true) : right_type;
 
         // For simple assignment, right type should be compatible with left type
         if (!promoted_right->isCompatibleWith(*left_type)) {
             reportTypeError(node.location, 
                 "Type mismatch in assignment: expected " + left_type->toString() +
                 ", got " + promoted_right->toString());
-            setExpressionType(node, SemanticType::createError());
+            setExpressionType(node, types.getError());
             return;
         }
     }
     
     // Assignment expression evaluates to the assigned value
-    setExpressionType(node, std::make_unique<SemanticType>(*left_type));
+    setExpressionType(node, left_type);
 }
 
 void TypeChecker::visit(PostfixExpression& node) {
@@ -615,13 +538,13 @@ void TypeChecker::visit(PostfixExpression& node) {
     
     auto operand_type = getExpressionType(*node.operand);
     if (!operand_type) {
-        setExpressionType(node, SemanticType::createError());
+        setExpressionType(node, types.getError());
         return;
     }
     
     // Check if operand is assignable (for now, just check if it's an identifier)
     if (auto identifier = dynamic_cast<IdentifierExpression*>(node.operand.get())) {
-        Symbol* symbol = current_scope->lookup(identifier->name);
+        Symbol* symbol = lookupSymbol(identifier->symbol_id);
         if (symbol && !symbol->is_mutable) {
             reportTypeError(node.location, "Cannot modify immutable variable: " + identifier->name);
         }
@@ -632,12 +555,12 @@ void TypeChecker::visit(PostfixExpression& node) {
           operand_type->name == "u8" || operand_type->name == "u16" || operand_type->name == "u32" || operand_type->name == "u64" ||
           operand_type->name == "f32" || operand_type->name == "f64")) {
         reportTypeError(node.location, "Increment/decrement requires numeric operand");
-        setExpressionType(node, SemanticType::createError());
+        setExpressionType(node, types.getError());
         return;
     }
     
     // Postfix increment/decrement returns the original value
-    setExpressionType(node, std::make_unique<SemanticType>(*operand_type));
+    setExpressionType(node, operand_type);
 }
 
 void TypeChecker::visit(CastExpression& node) {
@@ -649,7 +572,7 @@ void TypeChecker::visit(CastExpression& node) {
     
     auto source_type = getExpressionType(*node.expression);
     if (!source_type) {
-        setExpressionType(node, SemanticType::createError());
+        setExpressionType(node, types.getError());
         return;
     }
     
@@ -676,15 +599,15 @@ void TypeChecker::visit(CastExpression& node) {
         if (node.is_safe_cast) {
             // For try_cast, invalid casts return the original value
             reportTypeError(node.location, "try_cast failed: cannot cast from " + source_type->toString() + " to " + target_type->toString(), true);
-            setExpressionType(node, std::make_unique<SemanticType>(*source_type));
+            setExpressionType(node, source_type);
         } else {
             // For cast, invalid casts are warnings but still proceed
             reportTypeError(node.location, "Warning: potentially unsafe cast from " + source_type->toString() + " to " + target_type->toString(), true);
-            setExpressionType(node, std::move(target_type));
+            setExpressionType(node, target_type);
         }
     } else {
         // Valid cast
-        setExpressionType(node, std::move(target_type));
+        setExpressionType(node, target_type);
     }
 }
 
@@ -697,7 +620,7 @@ void TypeChecker::visit(AsExpression& node) {
     
     auto source_type = getExpressionType(*node.expression);
     if (!source_type) {
-        setExpressionType(node, SemanticType::createError());
+        setExpressionType(node, types.getError());
         return;
     }
     
@@ -708,12 +631,12 @@ void TypeChecker::visit(AsExpression& node) {
     
     if (!source_is_castable || !target_is_castable) {
         reportTypeError(node.location, "Cannot cast from " + source_type->toString() + " to " + target_type->toString() + " using 'as' operator");
-        setExpressionType(node, SemanticType::createError());
+        setExpressionType(node, types.getError());
         return;
     }
     
     // 'as' cast always succeeds
-    setExpressionType(node, std::move(target_type));
+    setExpressionType(node, target_type);
 }
 
 void TypeChecker::visit(ExpressionStatement& node) {
@@ -721,20 +644,17 @@ void TypeChecker::visit(ExpressionStatement& node) {
 }
 
 void TypeChecker::visit(BlockStatement& node) {
-    enterScope();
-    
     for (auto& stmt : node.statements) {
         stmt->accept(*this);
     }
     
-    exitScope();
 }
 
 void TypeChecker::visit(IfStatement& node) {
     node.condition->accept(*this);
     
     auto condition_type = getExpressionType(*node.condition);
-    if (condition_type && !condition_type->isCompatibleWith(*SemanticType::createPrimitive("bool"))) {
+    if (condition_type && !condition_type->isCompatibleWith(*types.getPrimitive("bool"))) {
         reportTypeError(node.condition->location, "If condition must be boolean");
     }
     
@@ -746,10 +666,11 @@ void TypeChecker::visit(IfStatement& node) {
 }
 
 void TypeChecker::visit(WhileStatement& node) {
+    checkLoopAttributes(node.attributes);
     node.condition->accept(*this);
     
     auto condition_type = getExpressionType(*node.condition);
-    if (condition_type && !condition_type->isCompatibleWith(*SemanticType::createPrimitive("bool"))) {
+    if (condition_type && !condition_type->isCompatibleWith(*types.getPrimitive("bool"))) {
         reportTypeError(node.condition->location, "While condition must be boolean");
     }
     
@@ -757,24 +678,49 @@ void TypeChecker::visit(WhileStatement& node) {
 }
 
 void TypeChecker::visit(ForStatement& node) {
-    // For now, simplified - would need iterator protocol implementation
+    checkLoopAttributes(node.attributes);
     node.iterable->accept(*this);
-    
-    enterScope();
-    
-    // Define iterator variable (simplified as int for now)
-    auto iterator_symbol = std::make_unique<Symbol>(
+    if (node.range_end) {
+        node.range_end->accept(*this);
+    }
+    if (node.step) {
+        node.step->accept(*this);
+    }
+
+    // Only integer ranges can be iterated; the iterator takes the bounds' common type
+    const SemanticType* iterator_type = types.getError();
+    auto start_type = getExpressionType(*node.iterable);
+    auto end_type = node.range_end ? getExpressionType(*node.range_end) : nullptr;
+    if (!node.range_end) {
+        reportTypeError(node.iterable->location, "For loops can only iterate over integer ranges (a..b)");
+    } else if (start_type && end_type && start_type->kind != SemanticType::Kind::ERROR_TYPE &&
+               end_type->kind != SemanticType::Kind::ERROR_TYPE) {
+        PrimitiveKind kind = primitive::commonKind(start_type->primitive_kind, end_type->primitive_kind);
+        if (primitive::isInteger(kind)) {
+            iterator_type = types.getPrimitive(kind);
+        } else {
+            reportTypeError(node.iterable->location, "Range bounds must be integers: " +
+                start_type->toString() + " and " + end_type->toString());
+        }
+    }
+
+    auto step_type = node.step ? getExpressionType(*node.step) : nullptr;
+    if (step_type && step_type->kind != SemanticType::Kind::ERROR_TYPE && !primitive::isInteger(step_type->primitive_kind)) {
+        reportTypeError(node.step->location, "Loop step must be an integer");
+    }
+
+    // The iterator cannot be assigned, so the loop always runs its computed trip count
+    Symbol iterator_symbol(
         node.iterator_name, 
-        SemanticType::createPrimitive("int"), 
+        iterator_type, 
         false, 
         node.location
     );
-    iterator_symbol->is_initialized = true;
-    current_scope->define(node.iterator_name, std::move(iterator_symbol));
+    iterator_symbol.is_initialized = true;
+    defineSymbol(node.iterator_symbol_id, std::move(iterator_symbol));
     
     node.body->accept(*this);
     
-    exitScope();
 }
 
 void TypeChecker::visit(ReturnStatement& node) {
@@ -803,71 +749,183 @@ void TypeChecker::visit(DeclarationStatement& node) {
 }
 
 void TypeChecker::visit(FunctionDeclaration& node) {
+    // A foreign function nothing calls is never type-converted
+    if (node.is_foreign && declarations && !declarations->isReferenced(node.symbol_id)) {
+        skipped_foreign_functions++;
+        return;
+    }
+
+    llvm::TimeTraceScope trace("Check function", node.name);
+
     // Convert parameter types
-    std::vector<std::unique_ptr<SemanticType>> param_types;
+    std::vector<const SemanticType*> param_types;
     for (auto& param : node.parameters) {
         param_types.push_back(convertASTType(*param.type));
     }
     
     // Convert return type
     auto return_type = convertASTType(*node.return_type);
-    
-    // Keep a copy of return type for function body checking
-    auto return_type_copy = std::make_unique<SemanticType>(*return_type);
-    
+
+    // Compile-time evaluation only passes built-in scalars in, and scalars or arrays of them out
+    if (node.is_const) {
+        for (size_t i = 0; i < param_types.size(); ++i) {
+            if (param_types[i]->primitive_kind == PrimitiveKind::NONE) {
+                reportTypeError(node.parameters[i].location, "Parameter '" + node.parameters[i].name +
+                                "' of const fn '" + node.name + "' must have a built-in scalar type");
+            }
+        }
+        const SemanticType* returned_scalar =
+            return_type->kind == SemanticType::Kind::ARRAY ? return_type->element_type : return_type;
+        if (!returned_scalar || returned_scalar->primitive_kind == PrimitiveKind::NONE) {
+            reportTypeError(node.location, "const fn '" + node.name +
+                            "' must return a built-in scalar type or a fixed-size array of one");
+        }
+    }
+
+    checkFunctionAttributes(node);
+
+    if (return_type->is_restrict) {
+        reportTypeError(node.return_type->location, "'restrict' only has an effect on function parameters", true);
+    }
+
     // Create function type
-    auto function_type = SemanticType::createFunction(std::move(param_types), std::move(return_type));
+    auto function_type = types.getFunction(param_types, return_type);
     
     // Define function in current scope
-    auto function_symbol = std::make_unique<Symbol>(
+    Symbol function_symbol(
         node.name, 
-        std::move(function_type), 
+        function_type, 
         false, 
         node.location
     );
-    function_symbol->is_initialized = true;
-    function_symbol->declared_module = current_module_name;
-    function_symbol->is_exported = node.is_exported;
-    current_scope->define(node.name, std::move(function_symbol));
+    function_symbol.is_initialized = true;
+    function_symbol.declared_module = current_module_name;
+    function_symbol.is_exported = node.is_exported;
+    defineSymbol(node.symbol_id, std::move(function_symbol));
     
     // Only analyze function body for non-foreign functions
     if (!node.is_foreign && node.body) {
-        // Enter function scope
-        enterScope();
-        
-        // Define parameters
-        for (auto& param : node.parameters) {
-            auto param_type = convertASTType(*param.type);
-            auto param_symbol = std::make_unique<Symbol>(
-                param.name, 
-                std::move(param_type), 
-                false, 
-                param.location
-            );
-            param_symbol->is_initialized = true;
-            current_scope->define(param.name, std::move(param_symbol));
+        if (defer_function_bodies) {
+            pending_bodies.push_back(PendingBody{&node, return_type, current_module_name});
+            return;
         }
-        
-        // Set current function return type for return statement checking
-        auto old_return_type = current_function_return_type;
-        current_function_return_type = return_type_copy.get();
-        
-        // Analyze function body
-        node.body->accept(*this);
-        
-        // Restore previous function return type
-        current_function_return_type = old_return_type;
-        
-        exitScope();
+
+        checkFunctionBody(node, return_type);
     }
     // Foreign functions don't have bodies to analyze
 }
 
+void TypeChecker::checkFunctionAttributes(const FunctionDeclaration& node) {
+    std::unordered_set<std::string> seen;
+    for (const auto& attribute : node.attributes) {
+        const std::string& name = attribute.name;
+        if (name != "inline" && name != "noinline" && name != "cold" && name != "hot" && name != "pure") {
+            reportTypeError(attribute.location, "Unknown function attribute '@" + name + "'");
+            continue;
+        }
+        if (!attribute.arguments.empty()) {
+            reportTypeError(attribute.location, "Attribute '@" + name + "' takes no arguments");
+        }
+        if (!seen.insert(name).second) {
+            reportTypeError(attribute.location, "Duplicate attribute '@" + name + "'", true);
+        }
+        if (node.is_foreign && (name == "inline" || name == "noinline")) {
+            reportTypeError(attribute.location, "Attribute '@" + name + "' cannot be applied to foreign function '" + node.name + "'");
+        }
+    }
+
+    if (seen.count("inline") && seen.count("noinline")) {
+        reportTypeError(node.location, "Function '" + node.name + "' cannot be both @inline and @noinline");
+    }
+    if (seen.count("hot") && seen.count("cold")) {
+        reportTypeError(node.location, "Function '" + node.name + "' cannot be both @hot and @cold");
+    }
+}
+
+void TypeChecker::checkLoopAttributes(const std::vector<Attribute>& attributes) {
+    // Limits LoopVectorize puts on the hints; it silently ignores any others
+    constexpr uint64_t max_vector_width = 64;
+    constexpr uint64_t max_interleave_count = 16;
+    auto is_power_of_two = [](uint64_t value) { return value != 0 && (value & (value - 1)) == 0; };
+
+    std::unordered_set<std::string> seen;
+    for (const auto& attribute : attributes) {
+        const std::string& name = attribute.name;
+        const auto& arguments = attribute.arguments;
+        if (!seen.insert(name).second) {
+            reportTypeError(attribute.location, "Duplicate attribute '@" + name + "'", true);
+        }
+
+        if (name == "vectorize") {
+            std::optional<uint64_t> width = arguments.size() == 1 && arguments[0].key == "width"
+                ? arguments[0].integerValue() : std::nullopt;
+            if (!arguments.empty() && (!width || !is_power_of_two(*width) || *width > max_vector_width)) {
+                reportTypeError(attribute.location, "'@vectorize' takes an optional width=N, a power of two up to " +
+                    std::to_string(max_vector_width));
+            }
+        } else if (name == "no_vectorize") {
+            if (!arguments.empty()) {
+                reportTypeError(attribute.location, "Attribute '@no_vectorize' takes no arguments");
+            }
+        } else if (name == "unroll") {
+            std::optional<uint64_t> count = arguments.size() == 1 && arguments[0].key.empty()
+                ? arguments[0].integerValue() : std::nullopt;
+            bool full = arguments.size() == 1 && arguments[0].key.empty() && arguments[0].value == "full";
+            if (!arguments.empty() && !full && (!count || *count == 0 || *count > UINT32_MAX)) {
+                reportTypeError(attribute.location, "'@unroll' takes an optional count or 'full'");
+            }
+        } else if (name == "interleave") {
+            std::optional<uint64_t> count = arguments.size() == 1 && arguments[0].key.empty()
+                ? arguments[0].integerValue() : std::nullopt;
+            if (!count || !is_power_of_two(*count) || *count > max_interleave_count) {
+                reportTypeError(attribute.location, "'@interleave' takes a count, a power of two up to " +
+                    std::to_string(max_interleave_count));
+            }
+        } else {
+            reportTypeError(attribute.location, "Unknown loop attribute '@" + name + "'");
+        }
+    }
+
+    if (seen.count("vectorize") && seen.count("no_vectorize")) {
+        reportTypeError(attributes.front().location, "A loop cannot be both @vectorize and @no_vectorize");
+    }
+}
+
+void TypeChecker::checkFunctionBody(FunctionDeclaration& node, const SemanticType* return_type) {
+    llvm::TimeTraceScope trace("Check function body", node.name);
+
+    // Define parameters
+    for (auto& param : node.parameters) {
+        auto param_type = convertASTType(*param.type);
+        Symbol param_symbol(
+            param.name, 
+            param_type, 
+            false, 
+            param.location
+        );
+        param_symbol.is_initialized = true;
+        defineSymbol(param.symbol_id, std::move(param_symbol));
+    }
+    
+    // Set current function return type for return statement checking
+    auto old_return_type = current_function_return_type;
+    current_function_return_type = return_type;
+    
+    // Analyze function body
+    node.body->accept(*this);
+    
+    // Restore previous function return type
+    current_function_return_type = old_return_type;
+}
+
 void TypeChecker::visit(VariableDeclaration& node) {
-    std::unique_ptr<SemanticType> var_type;
+    const SemanticType* var_type = nullptr;
     
     if (node.type) {
         var_type = convertASTType(*node.type);
+        if (var_type->is_restrict) {
+            reportTypeError(node.type->location, "'restrict' only has an effect on function parameters", true);
+        }
     }
     
     if (node.initializer) {
@@ -882,35 +940,35 @@ void TypeChecker::visit(VariableDeclaration& node) {
             }
         } else if (!var_type && init_type) {
             // Type inference
-            var_type = std::make_unique<SemanticType>(*init_type);
+            var_type = init_type;
         }
     }
     
     if (!var_type) {
         reportTypeError(node.location, "Cannot infer type for variable " + node.name);
-        var_type = SemanticType::createError();
+        var_type = types.getError();
     }
     
-    // Check for redefinition in current scope
-    if (current_scope->isDefined(node.name)) {
+    // NameResolver leaves redefinitions in the same scope unbound
+    if (node.symbol_id == NO_SYMBOL) {
         reportTypeError(node.location, "Redefinition of variable " + node.name);
         return;
     }
     
-    auto symbol = std::make_unique<Symbol>(
+    Symbol symbol(
         node.name, 
-        std::move(var_type), 
+        var_type, 
         node.is_mutable, 
         node.location
     );
     
     if (node.initializer) {
-        symbol->is_initialized = true;
+        symbol.is_initialized = true;
     }
     
-    symbol->declared_module = current_module_name;
-    symbol->is_exported = node.is_exported;
-    current_scope->define(node.name, std::move(symbol));
+    symbol.declared_module = current_module_name;
+    symbol.is_exported = node.is_exported;
+    defineSymbol(node.symbol_id, std::move(symbol));
 }
 
 void TypeChecker::visit(ImportDeclaration& node) {
@@ -919,12 +977,11 @@ void TypeChecker::visit(ImportDeclaration& node) {
 }
 
 void TypeChecker::visit(Module& node) {
+    llvm::TimeTraceScope trace("Check module", node.module_name);
+
     // Set current module context
     current_module_name = node.module_name;
     
-    // Process all imports first (for symbol resolution)
-    injectImportsIntoScope(node);
-    
     for (auto& import : node.imports) {
         import->accept(*this);
     }
@@ -933,45 +990,13 @@ void TypeChecker::visit(Module& node) {
     for (auto& decl : node.declarations) {
         decl->accept(*this);
     }
-    
-    // Collect exports from this module
-    collectModuleExports(node);
 }
 
 void TypeChecker::visit(Program& node) {
-    // First pass: Process all modules to collect their exports
-    for (auto& module : node.modules) {
-        current_module_name = module->module_name;
-        
-        // Process declarations to populate global scope
-        for (auto& decl : module->declarations) {
-            decl->accept(*this);
-        }
-        
-        // Collect exports
-        collectModuleExports(*module);
-    }
-    
-    // Second pass: Process imports and inject symbols
-    for (auto& module : node.modules) {
-        current_module_name = module->module_name;
-        injectImportsIntoScope(*module);
-    }
-    
-    // Process the main module
-    if (node.main_module) {
-        current_module_name = node.main_module->module_name;
-        injectImportsIntoScope(*node.main_module);
-        
-        for (auto& import : node.main_module->imports) {
-            import->accept(*this);
-        }
-        
-        for (auto& decl : node.main_module->declarations) {
-            decl->accept(*this);
-        }
-        
-        collectModuleExports(*node.main_module);
+    // Serial walk; every module is checked after the modules it imports
+    ModuleGraph graph(node);
+    for (size_t index : graph.getOrder()) {
+        graph.getModule(index).accept(*this);
     }
 }
 
@@ -983,19 +1008,19 @@ void TypeChecker::visit(GenericType& node) {
 
 void TypeChecker::visit(ClassDeclaration& node) {
     // Register the class as a new type in the current scope
-    auto class_type = SemanticType::createPrimitive(node.name);
-    auto class_symbol = std::make_unique<Symbol>(
+    auto class_type = types.getPrimitive(node.name);
+    Symbol class_symbol(
         node.name,
-        std::move(class_type),
+        class_type,
         false,
         node.location
     );
-    class_symbol->is_initialized = true;
-    current_scope->define(node.name, std::move(class_symbol));
+    class_symbol.is_initialized = true;
+    defineSymbol(node.symbol_id, std::move(class_symbol));
     
     // Also register the class as a constructor function
     // Constructor takes the field parameters and returns an instance of the class
-    std::vector<std::unique_ptr<SemanticType>> constructor_params;
+    std::vector<const SemanticType*> constructor_params;
     
     // Find constructor parameters from the constructor method
     for (auto& member : node.members) {
@@ -1009,68 +1034,63 @@ void TypeChecker::visit(ClassDeclaration& node) {
         }
     }
     
-    auto constructor_return_type = SemanticType::createPrimitive(node.name);
-    auto constructor_type = SemanticType::createFunction(std::move(constructor_params), std::move(constructor_return_type));
+    auto constructor_return_type = types.getPrimitive(node.name);
+    auto constructor_type = types.getFunction(constructor_params, constructor_return_type);
     
     // Register constructor as a function with the class name
-    auto constructor_symbol = std::make_unique<Symbol>(
+    Symbol constructor_symbol(
         node.name,
-        std::move(constructor_type),
+        constructor_type,
         false,
         node.location
     );
-    constructor_symbol->is_initialized = true;
-    current_scope->define(node.name, std::move(constructor_symbol));
+    constructor_symbol.is_initialized = true;
+    defineSymbol(node.symbol_id, std::move(constructor_symbol));
     
     // Enter class scope for methods
-    enterScope();
-    
     // Process class members (methods and fields)
     for (auto& member : node.members) {
         if (auto method = dynamic_cast<MethodMember*>(member.get())) {
             // Convert method parameters
-            std::vector<std::unique_ptr<SemanticType>> param_types;
+            std::vector<const SemanticType*> param_types;
             for (auto& param : method->parameters) {
                 param_types.push_back(convertASTType(*param.type));
             }
             
             // Convert return type
             auto return_type = convertASTType(*method->return_type);
-            auto return_type_copy = std::make_unique<SemanticType>(*return_type);
             
             // Create method type
-            auto method_type = SemanticType::createFunction(std::move(param_types), std::move(return_type));
+            auto method_type = types.getFunction(param_types, return_type);
             
             // Register method in class scope
-            auto method_symbol = std::make_unique<Symbol>(
+            Symbol method_symbol(
                 method->name,
-                std::move(method_type),
+                method_type,
                 false,
                 method->location
             );
-            method_symbol->is_initialized = true;
-            current_scope->define(method->name, std::move(method_symbol));
+            method_symbol.is_initialized = true;
+            defineSymbol(method->symbol_id, std::move(method_symbol));
             
             // Analyze method body
-            enterScope();
-            
             // Define method parameters (including self)
             for (auto& param : method->parameters) {
                 auto param_type = convertASTType(*param.type);
                 
                 // Special handling for 'self' parameter
                 if (param.name == "self") {
-                    param_type = SemanticType::createPrimitive(node.name);
+                    param_type = types.getPrimitive(node.name);
                 }
                 
-                auto param_symbol = std::make_unique<Symbol>(
+                Symbol param_symbol(
                     param.name,
-                    std::move(param_type),
+                    param_type,
                     false,
                     param.location
                 );
-                param_symbol->is_initialized = true;
-                current_scope->define(param.name, std::move(param_symbol));
+                param_symbol.is_initialized = true;
+                defineSymbol(param.symbol_id, std::move(param_symbol));
             }
             
             // For constructors, also define 'self' if it's not already a parameter
@@ -1085,21 +1105,21 @@ void TypeChecker::visit(ClassDeclaration& node) {
                 
                 if (!has_self_param) {
                     // Define 'self' as an instance of the class
-                    auto self_type = SemanticType::createPrimitive(node.name);
-                    auto self_symbol = std::make_unique<Symbol>(
+                    auto self_type = types.getPrimitive(node.name);
+                    Symbol self_symbol(
                         "self",
-                        std::move(self_type),
+                        self_type,
                         true, // self is mutable in constructors
                         method->location
                     );
-                    self_symbol->is_initialized = true;
-                    current_scope->define("self", std::move(self_symbol));
+                    self_symbol.is_initialized = true;
+                    defineSymbol(method->self_symbol_id, std::move(self_symbol));
                 }
             }
             
             // Set current function return type
             auto old_return_type = current_function_return_type;
-            current_function_return_type = return_type_copy.get();
+            current_function_return_type = return_type;
             
             // Analyze method body
             method->body->accept(*this);
@@ -1107,7 +1127,6 @@ void TypeChecker::visit(ClassDeclaration& node) {
             // Restore previous function return type
             current_function_return_type = old_return_type;
             
-            exitScope();
         }
         else if (auto field = dynamic_cast<FieldMember*>(member.get())) {
             // Process field declarations - they don't need analysis here
@@ -1119,20 +1138,19 @@ void TypeChecker::visit(ClassDeclaration& node) {
         }
     }
     
-    exitScope();
 }
 
 void TypeChecker::visit(StructDeclaration& node) {
     // Register the struct as a new type in the current scope
-    auto struct_type = SemanticType::createPrimitive(node.name);
-    auto struct_symbol = std::make_unique<Symbol>(
+    auto struct_type = types.getPrimitive(node.name);
+    Symbol struct_symbol(
         node.name,
-        std::move(struct_type),
+        struct_type,
         false,
         node.location
     );
-    struct_symbol->is_initialized = true;
-    current_scope->define(node.name, std::move(struct_symbol));
+    struct_symbol.is_initialized = true;
+    defineSymbol(node.symbol_id, std::move(struct_symbol));
     
     // Validate field types
     for (auto& field : node.fields) {
@@ -1145,85 +1163,66 @@ void TypeChecker::visit(StructDeclaration& node) {
 
 void TypeChecker::visit(EnumDeclaration& node) {
     // Register the enum as a new type in the current scope
-    auto enum_type = SemanticType::createPrimitive(node.name);
-    auto enum_symbol = std::make_unique<Symbol>(
+    auto enum_type = types.getPrimitive(node.name);
+    Symbol enum_symbol(
         node.name,
-        std::move(enum_type),
+        enum_type,
         false,
         node.location
     );
-    enum_symbol->is_initialized = true;
-    current_scope->define(node.name, std::move(enum_symbol));
+    enum_symbol.is_initialized = true;
+    defineSymbol(node.symbol_id, std::move(enum_symbol));
     
     // Register each variant as a constant of the enum type
     for (auto& variant : node.variants) {
-        auto variant_type = SemanticType::createPrimitive(node.name);
-        auto variant_symbol = std::make_unique<Symbol>(
+        auto variant_type = types.getPrimitive(node.name);
+        Symbol variant_symbol(
             variant.name,
-            std::move(variant_type),
+            variant_type,
             false,
             variant.location
         );
-        variant_symbol->is_initialized = true;
-        current_scope->define(variant.name, std::move(variant_symbol));
-    }
-}
-
-void TypeChecker::enterScope() {
-    auto new_scope = std::make_unique<Scope>(current_scope);
-    current_scope = new_scope.get();
-    scope_stack.push_back(std::move(new_scope));
-}
-
-void TypeChecker::exitScope() {
-    if (current_scope->getParent()) {
-        current_scope = current_scope->getParent();
-        if (!scope_stack.empty()) {
-            scope_stack.pop_back();
-        }
+        variant_symbol.is_initialized = true;
+        defineSymbol(variant.symbol_id, std::move(variant_symbol));
     }
 }
 
-std::unique_ptr<SemanticType> TypeChecker::convertASTType(Type& ast_type) {
+const SemanticType* TypeChecker::convertASTType(Type& ast_type) {
     if (auto primitive = dynamic_cast<PrimitiveType*>(&ast_type)) {
-        return SemanticType::createPrimitive(primitive->toString());
+        return types.getPrimitive(primitive->toString());
     } else if (auto const_type = dynamic_cast<ConstType*>(&ast_type)) {
-        auto base_type = convertASTType(*const_type->base_type);
-        base_type->is_const = true; // just set is const here its easier idk
-        //printf("BASE NAME TEST: %s\n", base_type->name.c_str());
-        return base_type;
+        return types.withConst(convertASTType(*const_type->base_type), true);
     } else if (auto array = dynamic_cast<ArrayType*>(&ast_type)) {
         auto element_type = convertASTType(*array->element_type);
-        auto arr_type = SemanticType::createArray(
-            std::move(element_type),
+        auto arr_type = types.getArray(
+            element_type,
+            array->size,
             dynamic_cast<ConstType*>(&ast_type) != nullptr // is_const if wrapped in ConstType
         );
         return arr_type;
     } else if (auto pointer = dynamic_cast<PointerType*>(&ast_type)) {
         auto pointee_type = convertASTType(*pointer->pointee_type);
-        auto ptr_type = SemanticType::createPointer(
-            std::move(pointee_type),
+        auto ptr_type = types.getPointer(
+            pointee_type,
             pointer->pointer_kind,          // pass the pointer kind
-            dynamic_cast<ConstType*>(&ast_type) != nullptr // is_const if wrapped in ConstType
+            dynamic_cast<ConstType*>(&ast_type) != nullptr, // is_const if wrapped in ConstType
+            pointer->is_restrict,
+            pointer->length
         );
         return ptr_type;
     } else if (auto generic = dynamic_cast<GenericType*>(&ast_type)) {
-        return SemanticType::createPrimitive(generic->base_name);
+        return types.getPrimitive(generic->base_name);
     }
     
-    return SemanticType::createError();
+    return types.getError();
 }
 
-std::unique_ptr<SemanticType> TypeChecker::getExpressionType(Expression& expr) {
-    auto it = expression_types.find(&expr);
-    if (it != expression_types.end()) {
-        return std::make_unique<SemanticType>(*it->second);
-    }
-    return nullptr;
+const SemanticType* TypeChecker::getExpressionType(Expression& expr) {
+    return expr.resolved_type;
 }
 
-void TypeChecker::setExpressionType(Expression& expr, std::unique_ptr<SemanticType> type) {
-    expression_types[&expr] = std::move(type);
+void TypeChecker::setExpressionType(Expression& expr, const SemanticType* type) {
+    expr.resolved_type = type;
 }
 
 bool TypeChecker::checkTypeCompatibility(const SemanticType& expected, const SemanticType& actual) {
@@ -1241,73 +1240,18 @@ void TypeChecker::initializeBuiltinTypes() {
     // This could be expanded to include built-in functions, constants, etc.
 }
 
-void TypeChecker::registerBuiltinFunction(const std::string& name, const std::string& return_type,
-                                        const std::vector<std::pair<std::string, std::string>>& parameters) {
-    // Special handling for variadic functions (like print)
-    if (parameters.empty() && name == "print") {
-        // For print function, create a special variadic function type
-        // We'll handle this specially in CallExpression visitor
-        auto ret_type = SemanticType::createVoid();
-        auto function_type = SemanticType::createFunction({}, std::move(ret_type));
-        
-        auto function_symbol = std::make_unique<Symbol>(
-            name, 
-            std::move(function_type), 
-            false, 
-            SourceLocation{} // Built-ins don't have source locations
-        );
-        function_symbol->is_initialized = true;
-        global_scope->define(name, std::move(function_symbol));
-        return;
-    }
-    
-    // Convert parameter types
-    std::vector<std::unique_ptr<SemanticType>> param_types;
-    for (const auto& param : parameters) {
-        if (param.second == "int") {
-            param_types.push_back(SemanticType::createPrimitive("int"));
-        } else if (param.second == "float") {
-            param_types.push_back(SemanticType::createPrimitive("float"));
-        } else if (param.second == "bool") {
-            param_types.push_back(SemanticType::createPrimitive("bool"));
-        } else if (param.second == "string") {
-            param_types.push_back(SemanticType::createPrimitive("string"));
-        } else {
-            // Default to error type for unknown types
-            param_types.push_back(SemanticType::createError());
-        }
+Symbol* TypeChecker::lookupSymbol(SymbolId id) {
+    // Unresolved names, and declarations not checked yet, have no symbol
+    if (id == NO_SYMBOL || !symbols[id].type) {
+        return nullptr;
     }
-    
-    // Convert return type
-    std::unique_ptr<SemanticType> ret_type;
-    if (return_type == "void") {
-        ret_type = SemanticType::createVoid();
-    } else if (return_type == "int") {
-        ret_type = SemanticType::createPrimitive("int");
-    } else if (return_type == "float") {
-        ret_type = SemanticType::createPrimitive("float");
-    } else if (return_type == "bool") {
-        ret_type = SemanticType::createPrimitive("bool");
-    } else if (return_type == "string") {
-        ret_type = SemanticType::createPrimitive("string");
-    } else {
-        ret_type = SemanticType::createError();
+    return &symbols[id];
+}
+
+void TypeChecker::defineSymbol(SymbolId id, Symbol symbol) {
+    if (id != NO_SYMBOL) {
+        symbols[id] = std::move(symbol);
     }
-    
-    // Create function type
-    auto function_type = SemanticType::createFunction(std::move(param_types), std::move(ret_type));
-    
-    // Create symbol for the built-in function
-    auto function_symbol = std::make_unique<Symbol>(
-        name, 
-        std::move(function_type), 
-        false, 
-        SourceLocation{} // Built-ins don't have source locations
-    );
-    function_symbol->is_initialized = true;
-    
-    // Register in global scope
-    global_scope->define(name, std::move(function_symbol));
 }
 
 bool TypeChecker::isForeignVariadicFunction(const std::string& name) const {
@@ -1386,6 +1330,10 @@ bool TypeChecker::isNullComparison(const SemanticType& left_type, const Semantic
     // Check if one operand is a pointer type and the other is null
     bool left_is_pointer = (left_type.kind == SemanticType::Kind::POINTER);
     bool right_is_pointer = (right_type.kind == SemanticType::Kind::POINTER);
+    if (!left_is_pointer && !right_is_pointer) {
+        return false;
+    }
+
     bool left_is_null = (left_type.kind == SemanticType::Kind::PRIMITIVE && left_type.name == "null");
     bool right_is_null = (right_type.kind == SemanticType::Kind::PRIMITIVE && right_type.name == "null");
     
@@ -1393,184 +1341,4 @@ bool TypeChecker::isNullComparison(const SemanticType& left_type, const Semantic
     return (left_is_pointer && right_is_null) || (right_is_pointer && left_is_null);
 }
 
-// Numeric conversion helper implementations
-bool TypeChecker::isIntegerType(const SemanticType& t) const {
-    static const std::unordered_set<std::string> integer_types = {
-        "i8", "i16", "i32", "i64", "u8", "u16", "u32", "u64"
-    };
-    return t.kind == SemanticType::Kind::PRIMITIVE && integer_types.contains(t.name);
-}
-
-int TypeChecker::numericRank(const SemanticType& t) const {
-    // Numeric promotion rank (higher = wider type)
-    static const std::unordered_map<std::string, int> ranks = {
-        {"i8", 1}, {"u8", 1},
-        {"i16", 2}, {"u16", 2},
-        {"i32", 3}, {"u32", 3},
-        {"i64", 4}, {"u64", 4},
-        {"f32", 5}, {"f64", 6}
-    };
-    auto it = ranks.find(t.name);
-    return it != ranks.end() ? it->second : 0;
-}
-
-std::string TypeChecker::commonNumericTypeName(const SemanticType& a, const SemanticType& b) const {
-    // Return the common type for arithmetic operations (usual arithmetic conversions)
-    if (!((a.isNumberType() || a.isFloatingPointType()) && 
-          (b.isNumberType() || b.isFloatingPointType()))) {
-        return ""; // Not numeric types
-    }
-    
-    // If either is floating point, promote to the wider floating point type
-    if (a.isFloatingPointType() || b.isFloatingPointType()) {
-        if (a.name == "f64" || b.name == "f64") return "f64";
-        return "f32";
-    }
-    
-    // Both are integers - promote to the wider type
-    int rank_a = numericRank(a);
-    int rank_b = numericRank(b);
-    
-    if (rank_a >= rank_b) return a.name;
-    return b.name;
-}
-
-bool TypeChecker::isImplicitlyConvertible(const SemanticType& from, const SemanticType& to) const {
-    // Allow implicit conversions between numeric types
-    if ((from.isNumberType() || from.isFloatingPointType()) && 
-        (to.isNumberType() || to.isFloatingPointType())) {
-        
-        // Allow widening conversions without warning
-        int from_rank = numericRank(from);
-        int to_rank = numericRank(to);
-        
-        // Always allow widening (smaller to larger)
-        if (from_rank <= to_rank) return true;
-        
-        // Allow narrowing but it should generate a warning elsewhere
-        return true;
-    }
-    
-    // Allow exact type matches
-    return from.isCompatibleWith(to);
-}
-
-// Module visibility and export/import helpers
-bool TypeChecker::isSymbolVisibleInCurrentModule(const Symbol& sym) const {
-    // Built-in symbols (empty declared_module) are always visible
-    if (sym.declared_module.empty()) {
-        return true;
-    }
-    
-    // Symbols from the current module are always visible
-    if (sym.declared_module == current_module_name) {
-        return true;
-    }
-    
-    // Check if the symbol is exported and imported
-    if (!sym.is_exported) {
-        return false; // Non-exported symbols are not visible outside their module
-    }
-    
-    // Check if current module imports the symbol's module
-    auto imports_it = module_imports.find(current_module_name);
-    if (imports_it == module_imports.end()) {
-        return false; // No imports
-    }
-    
-    for (const auto& import : imports_it->second) {
-        if (import.module_path == sym.declared_module) {
-            // Check if it's a wildcard import or specific import
-            if (import.is_wildcard) {
-                return true;
-            }
-            
-            // Check if symbol is specifically imported
-            for (const auto& item : import.items) {
-                if (item == sym.name) {
-                    return true;
-                }
-            }
-        }
-    }
-    
-    return false;
-}
-
-void TypeChecker::collectModuleExports(Module& node) {
-    // Collect all exported symbols from this module
-    std::unordered_map<std::string, std::unique_ptr<Symbol>> module_exports;
-    
-    // Scan global scope for exported symbols
-    for (const auto& [name, symbol] : global_scope->getSymbols()) {
-        if (symbol->is_exported) {
-            // Create a copy of the symbol for the export table
-            auto exported_symbol = std::make_unique<Symbol>(
-                symbol->name,
-                std::make_unique<SemanticType>(*symbol->type),
-                symbol->is_mutable,
-                symbol->declaration_location
-            );
-            exported_symbol->declared_module = symbol->declared_module;
-            exported_symbol->is_exported = true;
-            exported_symbol->is_initialized = symbol->is_initialized;
-            
-            module_exports[name] = std::move(exported_symbol);
-        }
-    }
-    
-    exports_by_module[node.module_name] = std::move(module_exports);
-}
-
-void TypeChecker::injectImportsIntoScope(const Module& node) {
-    // Process imports and inject visible symbols into current scope
-    std::vector<ImportInfo> imports;
-    
-    for (const auto& import_decl : node.imports) {
-        ImportInfo info;
-        info.module_path = import_decl->module_path;
-        info.items = import_decl->imported_items;
-        info.is_wildcard = import_decl->is_wildcard;
-        imports.push_back(info);
-        
-        // Find exported symbols from the imported module
-        auto exports_it = exports_by_module.find(import_decl->module_path);
-        if (exports_it != exports_by_module.end()) {
-            for (const auto& [symbol_name, exported_symbol] : exports_it->second) {
-                // Check if this symbol should be imported
-                bool should_import = false;
-                
-                if (import_decl->is_wildcard) {
-                    should_import = true;
-                } else {
-                    // Check specific imports
-                    for (const auto& item : import_decl->imported_items) {
-                        if (item == symbol_name) {
-                            should_import = true;
-                            break;
-                        }
-                    }
-                }
-                
-                if (should_import) {
-                    // Create a copy of the exported symbol and add to current scope
-                    auto imported_symbol = std::make_unique<Symbol>(
-                        exported_symbol->name,
-                        std::make_unique<SemanticType>(*exported_symbol->type),
-                        exported_symbol->is_mutable,
-                        exported_symbol->declaration_location
-                    );
-                    imported_symbol->declared_module = exported_symbol->declared_module;
-                    imported_symbol->is_exported = exported_symbol->is_exported;
-                    imported_symbol->is_initialized = exported_symbol->is_initialized;
-                    
-                    current_scope->define(symbol_name, std::move(imported_symbol));
-                }
-            }
-        }
-    }
-    
-    module_imports[node.module_name] = std::move(imports);
-}
-
 } // namespace pangea
@@ -3,126 +3,89 @@
 #include "../ast/ast_visitor.h"
 #include "../ast/ast_nodes.h"
 #include "../utils/error_reporter.h"
+#include "../utils/stats.h"
+#include "name_resolver.h"
+#include "type_context.h"
 #include <unordered_map>
 #include <string>
 #include <memory>
+#include <atomic>
 #include <vector>
 
 namespace pangea {
 
-// Type representation for semantic analysis
-class SemanticType {
-public:
-    enum class Kind {
-        PRIMITIVE,
-        ARRAY,
-        POINTER,
-        FUNCTION,
-        VOID_TYPE,
-        ERROR_TYPE
-    } kind;
-    std::string name;
-    bool is_const;
-    std::unique_ptr<SemanticType> element_type;
-    std::vector<std::unique_ptr<SemanticType>> parameter_types;
-    std::unique_ptr<SemanticType> return_type;
-    
-    // Single constructor for kind and optional name
-    explicit SemanticType(Kind kind, const std::string& name = "", bool is_const = false)
-        : kind(kind), name(name), is_const(is_const) {}
-
-    // Copy constructor
-    SemanticType(const SemanticType& other)
-        : kind(other.kind),
-        name(other.name),
-        is_const(other.is_const),
-        element_type(other.element_type ? std::make_unique<SemanticType>(*other.element_type) : nullptr),
-        return_type(other.return_type ? std::make_unique<SemanticType>(*other.return_type) : nullptr)
-    {
-        for (const auto& param : other.parameter_types) {
-            parameter_types.push_back(std::make_unique<SemanticType>(*param));
-        }
-    }
-
-    // Move constructor
-    SemanticType(SemanticType&& other) noexcept
-        : kind(other.kind),
-        name(std::move(other.name)),
-        element_type(std::move(other.element_type)),
-        parameter_types(std::move(other.parameter_types)),
-        return_type(std::move(other.return_type)) {}
-
-    ~SemanticType() = default;
-    
-    
-    bool isCompatibleWith(const SemanticType& other) const;
-    bool isNumberType() const;
-    bool isFloatingPointType() const;
-    std::string toString() const;
-
-    static std::unique_ptr<SemanticType> createPrimitive(const std::string& name, bool is_const = false);
-    static std::unique_ptr<SemanticType> createArray(std::unique_ptr<SemanticType> element, bool is_const = false);
-    static std::unique_ptr<SemanticType> createPointer(std::unique_ptr<SemanticType> pointee, TokenType kind, bool is_const = false);
-    static std::unique_ptr<SemanticType> createFunction(
-        std::vector<std::unique_ptr<SemanticType>> params,
-        std::unique_ptr<SemanticType> ret_type
-    );
-    static std::unique_ptr<SemanticType> createVoid();
-    static std::unique_ptr<SemanticType> createError();
-};
-
 // Symbol table entry
 struct Symbol {
     std::string name;
-    std::unique_ptr<SemanticType> type;
-    bool is_mutable;
-    bool is_initialized;
+    const SemanticType* type = nullptr;
+    bool is_mutable = false;
+    bool is_initialized = false;
     // Module where this symbol was declared (empty for built-ins)
     std::string declared_module;
     // Whether this symbol is exported from its module
     bool is_exported = false;
     SourceLocation declaration_location;
     
-    Symbol(const std::string& symbol_name, std::unique_ptr<SemanticType> symbol_type, 
+    Symbol() = default;
+    Symbol(const std::string& symbol_name, const SemanticType* symbol_type, 
            bool mutable_flag, const SourceLocation& loc)
-        : name(symbol_name), type(std::move(symbol_type)), is_mutable(mutable_flag), 
+        : name(symbol_name), type(symbol_type), is_mutable(mutable_flag), 
           is_initialized(false), declaration_location(loc) {}
 };
 
-// Scope management
-class Scope {
-private:
-    std::unordered_map<std::string, std::unique_ptr<Symbol>> symbols;
-    Scope* parent;
-    
-public:
-    explicit Scope(Scope* parent_scope = nullptr) : parent(parent_scope) {}
-    
-    void define(const std::string& name, std::unique_ptr<Symbol> symbol);
-    Symbol* lookup(const std::string& name);
-    bool isDefined(const std::string& name) const;
-    
-    Scope* getParent() const { return parent; }
-
-    // Expose symbols for module export collection
-    const std::unordered_map<std::string, std::unique_ptr<Symbol>>& getSymbols() const { return symbols; }
-};
+class ThreadPool;
 
-// Type checker and semantic analyzer
+// Type checker and semantic analyzer.
+// Modules are scheduled over the import graph: a module's declarations and
+// function signatures are checked once every module it imports has been,
+// and its function bodies, which only read module-level symbols, are then
+// checked independently. With a thread pool, independent modules and bodies
+// run concurrently. Workers report straight to the shared ErrorReporter, which
+// orders diagnostics by source position, so the output does not depend on scheduling.
 class TypeChecker : public ASTVisitor {
 private:
     ErrorReporter* error_reporter;
-    std::unique_ptr<Scope> global_scope;
-    Scope* current_scope;
-    
-    // Scope stack for proper lifetime management
-    std::vector<std::unique_ptr<Scope>> scope_stack;
-    
-    // Type information for expressions
-    std::unordered_map<Expression*, std::unique_ptr<SemanticType>> expression_types;
+
+    // Storage owned by the checker analyze() is called on. Body-checking
+    // workers share it through the references below.
+    std::unique_ptr<TypeContext> owned_types;
+    std::vector<Symbol> owned_symbols;
+
+    // Owns every type referenced by symbols and Expression::resolved_type
+    TypeContext& types;
+
+    // Checked declarations, indexed by the SymbolIds NameResolver assigned.
+    // Sized before checking starts, so workers may define their own locals concurrently.
+    std::vector<Symbol>& symbols;
+
+    // A function body queued by the declaration pass
+    struct PendingBody {
+        FunctionDeclaration* function;
+        const SemanticType* return_type;
+        std::string module_name;
+    };
+    std::vector<PendingBody> pending_bodies;
+    bool defer_function_bodies = false;
+
+    // Set during analyze(); unreferenced foreign functions are not checked
+    const DeclarationTable* declarations = nullptr;
+    size_t skipped_foreign_functions = 0;
+
+    // Per-module results of analyze()
+    struct ModuleCheck {
+        std::vector<PendingBody> bodies;
+        size_t skipped_foreign_functions = 0;
+        std::atomic<size_t> waiting_imports{0}; // Imported modules not checked yet
+    };
+
+    size_t checked_modules = 0;
+    size_t module_import_edges = 0;
+    size_t module_graph_depth = 0;
+    size_t function_bodies = 0;
+    size_t body_check_workers = 0;
     
     // Current function return type for return statement checking
-    SemanticType* current_function_return_type = nullptr;
+    const SemanticType* current_function_return_type = nullptr;
 
     // Current module being analyzed (used for visibility checks)
     std::string current_module_name;
@@ -131,7 +94,14 @@ public:
     explicit TypeChecker(ErrorReporter* reporter, bool enable_builtins = true);
     ~TypeChecker() = default;
     
-    void analyze(Program& program);
+    /**
+     * Type check a program whose names have already been resolved
+     * @param program The program annotated by NameResolver
+     * @param declarations The declaration table NameResolver built for it
+     * @param pool Optional pool to check modules and function bodies on; checking is serial without one
+     */
+    void analyze(Program& program, const DeclarationTable& declarations, ThreadPool* pool = nullptr);
+    void reportStatistics(CompilerStats& stats) const;
     
     // Type visitors
     void visit(PrimitiveType& node) override;
@@ -175,48 +145,29 @@ public:
     void visit(Program& node) override;
     
 private:
-    void enterScope();
-    void exitScope();
-    
-    std::unique_ptr<SemanticType> convertASTType(Type& ast_type);
-    std::unique_ptr<SemanticType> getExpressionType(Expression& expr);
-    void setExpressionType(Expression& expr, std::unique_ptr<SemanticType> type);
+    // Worker sharing the types, symbols and error reporter of the checker running analyze()
+    explicit TypeChecker(TypeChecker& parent);
+
+    void checkFunctionBody(FunctionDeclaration& node, const SemanticType* return_type);
+    void checkFunctionAttributes(const FunctionDeclaration& node);
+    void checkLoopAttributes(const std::vector<Attribute>& attributes);
+    void checkModuleDeclarations(Module& module, ModuleCheck& check);
+    void checkPendingBody(ModuleCheck& check, size_t index);
+
+    const SemanticType* convertASTType(Type& ast_type);
+    const SemanticType* getExpressionType(Expression& expr);
+    void setExpressionType(Expression& expr, const SemanticType* type);
     
     bool checkTypeCompatibility(const SemanticType& expected, const SemanticType& actual);
     void reportTypeError(const SourceLocation& location, const std::string& message, const bool is_warning = false);
+
+    Symbol* lookupSymbol(SymbolId id);
+    void defineSymbol(SymbolId id, Symbol symbol);
     
     // Built-in type creation
     void initializeBuiltinTypes();
 
-    // Numeric and conversion helpers
-    bool isIntegerType(const SemanticType& t) const;
-    int numericRank(const SemanticType& t) const;
-    std::string commonNumericTypeName(const SemanticType& a, const SemanticType& b) const;
-    bool isImplicitlyConvertible(const SemanticType& from, const SemanticType& to) const;
-
-    // Import/Export visibility helpers
-    struct ImportInfo {
-        std::string module_path;
-        std::vector<std::string> items; // empty means wildcard
-        bool is_wildcard = false;
-    };
-    // Map: current module -> its list of imports
-    std::unordered_map<std::string, std::vector<ImportInfo>> module_imports;
-
-    // Export table: module -> (symbol name -> exported symbol copy)
-    std::unordered_map<std::string, std::unordered_map<std::string, std::unique_ptr<Symbol>>> exports_by_module;
-
-    bool isSymbolVisibleInCurrentModule(const Symbol& sym) const;
-
-    // Module utilities
-    void collectModuleExports(Module& node);
-    void injectImportsIntoScope(const Module& node);
-
 public:
-    // Register built-in functions
-    void registerBuiltinFunction(const std::string& name, const std::string& return_type,
-                                const std::vector<std::pair<std::string, std::string>>& parameters);
-    
     // Foreign function support
     bool isForeignVariadicFunction(const std::string& name) const;
     bool isVariadicCompatible(const SemanticType& type) const;
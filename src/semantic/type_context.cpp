@@ -0,0 +1,219 @@
+#include "type_context.h"
+#include <sstream>
+
+namespace pangea {
+
+// SemanticType implementation
+bool SemanticType::isCompatibleWith(const SemanticType& other) const {
+    if (kind == Kind::ERROR_TYPE || other.kind == Kind::ERROR_TYPE) {
+        return false;
+    }
+
+    // Interned types: identical types are the same object
+    if (this == &other) {
+        return true;
+    }
+
+    // Exact type match
+    if (kind == other.kind && name == other.name) {
+        switch (kind) {
+            case Kind::PRIMITIVE:
+            case Kind::VOID_TYPE:
+                return true;
+                
+            case Kind::ARRAY:
+                return length == other.length && element_type && other.element_type &&
+                       element_type->isCompatibleWith(*other.element_type);
+                       
+            case Kind::POINTER:
+                return element_type && other.element_type && 
+                       element_type->isCompatibleWith(*other.element_type);
+                       
+            case Kind::FUNCTION:
+                if (!return_type || !other.return_type || 
+                    !return_type->isCompatibleWith(*other.return_type)) {
+                    return false;
+                }
+                if (parameter_types.size() != other.parameter_types.size()) {
+                    return false;
+                }
+                for (size_t i = 0; i < parameter_types.size(); ++i) {
+                    if (!parameter_types[i]->isCompatibleWith(*other.parameter_types[i])) {
+                        return false;
+                    }
+                }
+                return true;
+                
+            default:
+                return false;
+        }
+    }
+    
+    // Implicit numeric conversions, as the shared promotion lattice allows them
+    if (kind == Kind::PRIMITIVE && other.kind == Kind::PRIMITIVE) {
+        return primitive::isImplicitlyConvertible(primitive_kind, other.primitive_kind);
+    }
+    
+    return false;
+}
+
+bool SemanticType::isNumberType() const {
+    if (kind == Kind::ERROR_TYPE) return false;
+
+    if (primitive::isInteger(primitive_kind))
+        return true;
+
+    // If it's a typedef / alias, check underlying type
+    if (element_type)
+        return element_type->isNumberType();
+    
+    return false;
+}
+
+bool SemanticType::isFloatingPointType() const {
+    if (kind == Kind::ERROR_TYPE) return false;
+
+    if (primitive::isFloat(primitive_kind))
+        return true;
+
+    // If it's a typedef / alias, check underlying type
+    if (element_type)
+        return element_type->isFloatingPointType();
+
+    return false;
+}
+
+std::string SemanticType::toString() const {
+    switch (kind) {
+        case Kind::PRIMITIVE:
+        case Kind::VOID_TYPE:
+            return name;
+        
+        case Kind::ARRAY:
+            return "[" + (element_type ? element_type->toString() : "unknown") + "; " + std::to_string(length) + "]";
+        
+        case Kind::POINTER:
+            return (is_restrict ? "restrict *" : "*") + (element_type ? element_type->toString() : "unknown") +
+                   (length > 0 ? " (" + std::to_string(length) + " elements)" : "");
+        
+        case Kind::FUNCTION: {
+            std::ostringstream oss;
+            oss << "fn(";
+            for (size_t i = 0; i < parameter_types.size(); ++i) {
+                if (i > 0) oss << ", ";
+                oss << parameter_types[i]->toString();
+            }
+            oss << ") -> " << (return_type ? return_type->toString() : "unknown");
+            return oss.str();
+        }
+        
+        case Kind::ERROR_TYPE:
+            return "<error>";
+        
+        default:
+            return "<unknown>";
+    }
+}
+
+// TypeContext implementation
+size_t TypeContext::TypeKeyHash::operator()(const TypeKey& key) const {
+    size_t hash = std::hash<std::string>()(key.name);
+    auto combine = [&hash](size_t value) {
+        hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    };
+    combine(static_cast<size_t>(key.kind));
+    combine(key.is_const);
+    combine(std::hash<const SemanticType*>()(key.element_type));
+    combine(std::hash<const SemanticType*>()(key.return_type));
+    combine(key.is_restrict);
+    combine(static_cast<size_t>(key.length));
+    for (const SemanticType* param : key.parameter_types) {
+        combine(std::hash<const SemanticType*>()(param));
+    }
+    return hash;
+}
+
+TypeContext::TypeContext() {
+    void_type = intern(TypeKey{SemanticType::Kind::VOID_TYPE, "void", false, nullptr, nullptr, {}});
+    error_type = intern(TypeKey{SemanticType::Kind::ERROR_TYPE, "<error>", false, nullptr, nullptr, {}});
+
+    for (size_t i = 1; i < primitive::kind_count; ++i) {
+        primitives[i] = getPrimitive(std::string(primitive::name(static_cast<PrimitiveKind>(i))));
+    }
+}
+
+const SemanticType* TypeContext::intern(TypeKey key) {
+    lookups.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = types.find(key);
+        if (it != types.end()) {
+            return it->second.get();
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto it = types.find(key);
+    if (it != types.end()) {
+        return it->second.get();
+    }
+
+    auto type = std::make_unique<SemanticType>(key.kind, key.name, key.is_const);
+    type->element_type = key.element_type;
+    type->return_type = key.return_type;
+    type->parameter_types = key.parameter_types;
+    type->is_restrict = key.is_restrict;
+    type->length = key.length;
+
+    const SemanticType* result = type.get();
+    types.emplace(std::move(key), std::move(type));
+    return result;
+}
+
+const SemanticType* TypeContext::getPrimitive(const std::string& name, bool is_const) {
+    return intern(TypeKey{SemanticType::Kind::PRIMITIVE, name, is_const, nullptr, nullptr, {}});
+}
+
+const SemanticType* TypeContext::getArray(const SemanticType* element, uint64_t length, bool is_const) {
+    return intern(TypeKey{SemanticType::Kind::ARRAY, "Array", is_const, element, nullptr, {}, false, length});
+}
+
+const SemanticType* TypeContext::getPointer(const SemanticType* pointee, TokenType kind, bool is_const,
+                                            bool is_restrict, uint64_t length) {
+    // Pointer kind is stored as the type name
+    std::string name;
+    switch (kind) {
+        case TokenType::CPTR:   name = "cptr"; break;
+        case TokenType::UNIQUE: name = "unique_ptr"; break;
+        case TokenType::SHARED: name = "shared_ptr"; break;
+        case TokenType::WEAK:   name = "weak_ptr"; break;
+        default:                name = "<error_ptr>"; break;
+    }
+
+    return intern(TypeKey{SemanticType::Kind::POINTER, name, is_const, pointee, nullptr, {}, is_restrict, length});
+}
+
+const SemanticType* TypeContext::getFunction(const std::vector<const SemanticType*>& params,
+                                             const SemanticType* ret_type) {
+    return intern(TypeKey{SemanticType::Kind::FUNCTION, "", false, nullptr, ret_type, params});
+}
+
+const SemanticType* TypeContext::withConst(const SemanticType* type, bool is_const) {
+    if (type->is_const == is_const) {
+        return type;
+    }
+    return intern(TypeKey{type->kind, type->name, is_const, type->element_type, type->return_type, type->parameter_types,
+                          type->is_restrict, type->length});
+}
+
+size_t TypeContext::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return types.size();
+}
+
+void TypeContext::reportStatistics(CompilerStats& stats) const {
+    stats.set("semantic.interned types", size());
+    stats.set("semantic.type context lookups", lookups.load(std::memory_order_relaxed));
+}
+
+} // namespace pangea
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "../lexer/token.h"
+#include "primitive_kind.h"
+#include "../utils/stats.h"
+#include <unordered_map>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+#include <array>
+
+namespace pangea {
+
+// Type representation for semantic analysis.
+// Types are immutable and interned by TypeContext: every structurally distinct
+// type exists exactly once, so they are always handled as const SemanticType*.
+class SemanticType {
+public:
+    enum class Kind {
+        PRIMITIVE,
+        ARRAY,
+        POINTER,
+        FUNCTION,
+        VOID_TYPE,
+        ERROR_TYPE
+    } kind;
+    std::string name;
+    bool is_const;
+    PrimitiveKind primitive_kind; // NONE unless this is a built-in scalar
+    const SemanticType* element_type = nullptr;
+    std::vector<const SemanticType*> parameter_types;
+    const SemanticType* return_type = nullptr;
+
+    // cptr qualifiers; they do not affect compatibility, so any cptr<T> converts to restrict cptr<T, N>
+    bool is_restrict = false;
+    uint64_t length = 0; // Elements always pointed to, 0 if unknown; for arrays, the element count
+
+    explicit SemanticType(Kind kind, const std::string& name = "", bool is_const = false)
+        : kind(kind), name(name), is_const(is_const),
+          primitive_kind(kind == Kind::PRIMITIVE ? primitive::fromName(name) : PrimitiveKind::NONE) {}
+
+    // Interned types are compared by identity, so they must never be copied
+    SemanticType(const SemanticType&) = delete;
+    SemanticType& operator=(const SemanticType&) = delete;
+
+    bool isCompatibleWith(const SemanticType& other) const;
+    bool isNumberType() const;
+    bool isFloatingPointType() const;
+    std::string toString() const;
+};
+
+// Owns and interns every SemanticType created during one type check.
+// Safe to use from several threads; interned types are never freed or moved.
+class TypeContext {
+public:
+    TypeContext();
+
+    const SemanticType* getPrimitive(const std::string& name, bool is_const = false);
+    // Non-const built-in scalars are interned up front, so this never hashes or locks
+    const SemanticType* getPrimitive(PrimitiveKind kind) const { return primitives[static_cast<size_t>(kind)]; }
+    const SemanticType* getArray(const SemanticType* element, uint64_t length, bool is_const = false);
+    const SemanticType* getPointer(const SemanticType* pointee, TokenType kind, bool is_const = false,
+                                   bool is_restrict = false, uint64_t length = 0);
+    const SemanticType* getFunction(const std::vector<const SemanticType*>& params, const SemanticType* ret_type);
+    const SemanticType* getVoid() const { return void_type; }
+    const SemanticType* getError() const { return error_type; }
+
+    /**
+     * Get the same type with a different const qualifier
+     * @param type The interned type to requalify
+     * @param is_const Whether the result should be const
+     * @return The interned requalified type
+     */
+    const SemanticType* withConst(const SemanticType* type, bool is_const);
+
+    size_t size() const;
+    void reportStatistics(CompilerStats& stats) const;
+
+private:
+    // Children are already interned, so a shallow key identifies a type
+    struct TypeKey {
+        SemanticType::Kind kind;
+        std::string name;
+        bool is_const;
+        const SemanticType* element_type;
+        const SemanticType* return_type;
+        std::vector<const SemanticType*> parameter_types;
+        bool is_restrict = false;
+        uint64_t length = 0;
+
+        bool operator==(const TypeKey& other) const = default;
+    };
+
+    struct TypeKeyHash {
+        size_t operator()(const TypeKey& key) const;
+    };
+
+    // Lookups of existing types, the common case, only take the lock shared
+    mutable std::shared_mutex mutex;
+    std::unordered_map<TypeKey, std::unique_ptr<SemanticType>, TypeKeyHash> types;
+    const SemanticType* void_type;
+    const SemanticType* error_type;
+    std::array<const SemanticType*, primitive::kind_count> primitives{};
+
+    std::atomic<uint64_t> lookups{0};
+
+    const SemanticType* intern(TypeKey key);
+};
+
+} // namespace pangea
@@ -0,0 +1,325 @@
+#include "compile_server.h"
+#include <llvm/ADT/ScopeExit.h>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <filesystem>
+
+#ifndef _WIN32
+    #include <sys/socket.h>
+    #include <sys/time.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+#endif
+
+namespace pangea {
+
+#ifndef _WIN32
+namespace {
+
+// Socket to remove when the server is interrupted
+std::string active_socket_path;
+
+void handleTerminationSignal(int signal_number) {
+    if (!active_socket_path.empty()) {
+        ::unlink(active_socket_path.c_str());
+    }
+    std::_Exit(128 + signal_number);
+}
+
+bool writeAll(int fd, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = ::write(fd, bytes, size);
+        if (written <= 0) return false;
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool readAll(int fd, void* data, size_t size) {
+    char* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t received = ::read(fd, bytes, size);
+        if (received <= 0) return false;
+        bytes += received;
+        size -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+// Requests only carry a working directory and command line arguments, so
+// anything larger than this is not a real client and is dropped unread
+constexpr uint32_t max_request_items = 4096;
+constexpr uint32_t max_request_string = 64 * 1024;
+
+// Connections are served one at a time, so a client that stalls while sending its request or
+// reading the response is dropped after this long instead of holding up every later compile
+constexpr time_t client_timeout_seconds = 10;
+
+// Wire format: every string is a u32 length followed by its bytes
+bool writeString(int fd, const std::string& value) {
+    uint32_t length = static_cast<uint32_t>(value.size());
+    return writeAll(fd, &length, sizeof(length)) && writeAll(fd, value.data(), value.size());
+}
+
+bool readString(int fd, std::string& value, uint32_t max_length = UINT32_MAX) {
+    uint32_t length = 0;
+    if (!readAll(fd, &length, sizeof(length)) || length > max_length) return false;
+    value.resize(length);
+    return readAll(fd, value.data(), length);
+}
+
+int connectToSocket(const std::string& socket_path) {
+    sockaddr_un address{};
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        return -1;
+    }
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        ::close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+} // namespace
+#endif
+
+CompileServer::CompileServer(const std::string& socket_path, bool verbose)
+    : socket_path(socket_path.empty() ? defaultSocketPath() : socket_path), verbose(verbose) {
+}
+
+std::string CompileServer::defaultSocketPath() {
+#ifdef _WIN32
+    return "";
+#else
+    return (std::filesystem::temp_directory_path() / ("pangea-" + std::to_string(::getuid()) + ".sock")).string();
+#endif
+}
+
+void CompileServer::logVerbose(const std::string& message) const {
+    if (verbose) {
+        std::cout << "[Pangea Server] " << message << std::endl;
+    }
+}
+
+int CompileServer::run() {
+#ifdef _WIN32
+    std::cerr << "Error: --server requires Unix domain sockets and is not supported on Windows" << std::endl;
+    return 1;
+#else
+    sockaddr_un address{};
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Error: Socket path is too long: " << socket_path << std::endl;
+        return 1;
+    }
+
+    // Refuse to steal the socket from a live server, but clean up stale ones
+    int probe = connectToSocket(socket_path);
+    if (probe >= 0) {
+        ::close(probe);
+        std::cerr << "Error: A compile server is already listening on " << socket_path << std::endl;
+        return 1;
+    }
+    ::unlink(socket_path.c_str());
+
+    int listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        std::cerr << "Error: Could not create socket: " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+
+    if (::bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        ::listen(listen_fd, 64) < 0) {
+        std::cerr << "Error: Could not listen on " << socket_path << ": " << std::strerror(errno) << std::endl;
+        ::close(listen_fd);
+        return 1;
+    }
+
+    active_socket_path = socket_path;
+    std::signal(SIGINT, handleTerminationSignal);
+    std::signal(SIGTERM, handleTerminationSignal);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::cout << "Pangea compile server listening on " << socket_path << std::endl;
+
+    while (true) {
+        int client_fd = ::accept(listen_fd, nullptr, nullptr);
+        if (client_fd < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "Error: accept failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        timeval timeout{};
+        timeout.tv_sec = client_timeout_seconds;
+        ::setsockopt(client_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        ::setsockopt(client_fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+        handleConnection(client_fd);
+        ::close(client_fd);
+    }
+
+    ::close(listen_fd);
+    ::unlink(socket_path.c_str());
+    return 1;
+#endif
+}
+
+void CompileServer::handleConnection(int client_fd) {
+#ifndef _WIN32
+    // Request: u32 count, then the client's working directory and its arguments
+    uint32_t count = 0;
+    if (!readAll(client_fd, &count, sizeof(count)) || count == 0) {
+        logVerbose("Dropped a connection that sent no request");
+        return;
+    }
+    if (count > max_request_items) {
+        logVerbose("Dropped a request with " + std::to_string(count) + " items");
+        return;
+    }
+
+    std::vector<std::string> request(count);
+    for (auto& item : request) {
+        if (!readString(client_fd, item, max_request_string)) {
+            logVerbose("Dropped a truncated or oversized request");
+            return;
+        }
+    }
+
+    std::string out;
+    std::string err;
+    int32_t exit_code = compileRequest(request, out, err);
+
+    // Response: i32 exit code, captured stdout, captured stderr
+    if (!writeAll(client_fd, &exit_code, sizeof(exit_code)) || !writeString(client_fd, out) || !writeString(client_fd, err)) {
+        logVerbose("Client disconnected before the response was sent");
+    }
+#endif
+}
+
+int CompileServer::compileRequest(const std::vector<std::string>& request, std::string& out, std::string& err) {
+    const std::string& working_directory = request.front();
+    std::vector<std::string> args(request.begin() + 1, request.end());
+
+    logVerbose("Request #" + std::to_string(++requests_handled) + " from " + working_directory);
+
+    // Capture everything the pipeline prints so it can be replayed by the client
+    std::ostringstream captured_out;
+    std::ostringstream captured_err;
+    int exit_code = 0;
+    {
+        std::streambuf* old_out = std::cout.rdbuf(captured_out.rdbuf());
+        std::streambuf* old_err = std::cerr.rdbuf(captured_err.rdbuf());
+        std::error_code ec;
+        std::filesystem::path previous_directory = std::filesystem::current_path(ec);
+        bool entered_directory = false;
+
+        // Restored however the compile ends, so the server never stays in a client's directory
+        // or keeps writing to its destroyed capture streams
+        auto restore = llvm::make_scope_exit([&] {
+            std::error_code restore_ec;
+            if (entered_directory) {
+                std::filesystem::current_path(previous_directory, restore_ec);
+            }
+            std::cout.rdbuf(old_out);
+            std::cerr.rdbuf(old_err);
+        });
+
+        std::filesystem::current_path(working_directory, ec);
+        entered_directory = !ec;
+
+        CompileOptions options;
+        if (ec) {
+            std::cerr << "Error: Server could not enter working directory: " << working_directory << std::endl;
+            exit_code = 1;
+        } else if (!parseCommandLine(args, options, exit_code)) {
+            // Help text or argument errors have already been written
+        } else if (options.server_mode) {
+            std::cerr << "Error: --server cannot be forwarded to a compile server" << std::endl;
+            exit_code = 1;
+        } else {
+            try {
+                exit_code = runCompiler(options, &module_cache);
+            } catch (const std::exception& e) {
+                std::cerr << "Error: Compilation aborted: " << e.what() << std::endl;
+                exit_code = 1;
+            }
+        }
+    }
+
+    out = captured_out.str();
+    err = captured_err.str();
+
+    logVerbose("Request #" + std::to_string(requests_handled) + " finished with exit code " + std::to_string(exit_code) +
+               " (" + std::to_string(module_cache.size()) + " cached modules)");
+    return exit_code;
+}
+
+bool forwardToCompileServer(const std::string& socket_path, const std::vector<std::string>& args, int& exit_code) {
+#ifdef _WIN32
+    return false;
+#else
+    std::string path = socket_path.empty() ? CompileServer::defaultSocketPath() : socket_path;
+    int fd = connectToSocket(path);
+    if (fd < 0) {
+        return false;
+    }
+
+    std::error_code ec;
+    std::vector<std::string> request;
+    request.push_back(std::filesystem::current_path(ec).string());
+    for (const auto& arg : args) {
+        // The server decides nothing about our terminal, so resolve color=auto here
+        if (arg == "--color=auto") continue;
+        request.push_back(arg);
+    }
+    bool has_color = false;
+    for (const auto& arg : request) {
+        if (arg.starts_with("--color=")) has_color = true;
+    }
+    if (!has_color) {
+        request.push_back(isatty(fileno(stderr)) ? "--color=always" : "--color=never");
+    }
+
+    uint32_t count = static_cast<uint32_t>(request.size());
+    bool sent = writeAll(fd, &count, sizeof(count));
+    for (const auto& item : request) {
+        sent = sent && writeString(fd, item);
+    }
+
+    int32_t remote_exit_code = 1;
+    std::string out;
+    std::string err;
+    bool received = sent && readAll(fd, &remote_exit_code, sizeof(remote_exit_code)) &&
+                    readString(fd, out) && readString(fd, err);
+    ::close(fd);
+
+    if (!received) {
+        return false;
+    }
+
+    std::cout << out << std::flush;
+    std::cerr << err << std::flush;
+    exit_code = remote_exit_code;
+    return true;
+#endif
+}
+
+} // namespace pangea
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "../driver/driver.h"
+#include <string>
+#include <vector>
+
+namespace pangea {
+
+/**
+ * Long-running compile daemon listening on a Unix domain socket.
+ * Keeps parsed modules (see ModuleCache) and initialized LLVM targets
+ * resident so that each forwarded compile only pays for the main file.
+ * Requests are handled one at a time, in arrival order.
+ */
+class CompileServer {
+private:
+    std::string socket_path;
+    bool verbose;
+    ModuleCache module_cache;
+    size_t requests_handled = 0;
+
+    void handleConnection(int client_fd);
+    int compileRequest(const std::vector<std::string>& request, std::string& out, std::string& err);
+    void logVerbose(const std::string& message) const;
+
+public:
+    explicit CompileServer(const std::string& socket_path, bool verbose = false);
+    ~CompileServer() = default;
+
+    /**
+     * Listen for compile requests until the process is interrupted
+     * @return Process exit code
+     */
+    int run();
+
+    static std::string defaultSocketPath();
+};
+
+/**
+ * Forward a compile to a running compile server and replay its output
+ * @param socket_path Server socket (empty for the default)
+ * @param args Command line arguments (without the program name)
+ * @param exit_code Exit code of the remote compilation
+ * @return false if no server could be reached
+ */
+bool forwardToCompileServer(const std::string& socket_path, const std::vector<std::string>& args, int& exit_code);
+
+} // namespace pangea
@@ -0,0 +1,48 @@
+// Global operator new/delete replacement that feeds allocation_stats for --stats.
+// Linked into the pangea executable only, never into libpangea, so embedding
+// applications keep their own allocator.
+#include "stats.h"
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// Zero-initialized before any dynamic initializer runs, so ordering is safe
+[[maybe_unused]] const bool registered = (pangea::allocation_stats::hook_installed = true);
+
+void* countedAllocate(std::size_t size) {
+    pangea::allocation_stats::count.fetch_add(1, std::memory_order_relaxed);
+    pangea::allocation_stats::bytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    if (void* ptr = countedAllocate(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    if (void* ptr = countedAllocate(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
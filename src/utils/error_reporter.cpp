@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <fstream>
 #include <sstream>
+#include <iterator>
 
 #ifdef _WIN32
     #include <windows.h>
@@ -16,7 +17,14 @@
 
 namespace pangea {
 
-ErrorReporter::ErrorReporter(const std::string& color_mode_str) {
+namespace {
+std::atomic<uint64_t> next_reporter_id{1};
+}
+
+ErrorReporter::ErrorReporter() : reporter_id(next_reporter_id.fetch_add(1, std::memory_order_relaxed)) {
+}
+
+ErrorReporter::ErrorReporter(const std::string& color_mode_str) : ErrorReporter() {
     if (color_mode_str == "always") {
         color_mode = ColorMode::ALWAYS;
     } else if (color_mode_str == "never") {
@@ -67,36 +75,128 @@ std::string ErrorReporter::colorize(const std::string& text, const std::string&
 }
 
 void ErrorReporter::reportError(const SourceLocation& location, const std::string& message, const bool is_warning) {
-    diagnostics.emplace_back(is_warning ? ErrorLevel::WARNING : ErrorLevel::ERROR, location, message);
-
-    if (!is_warning) has_errors = true;
+    stage(DiagnosticMessage(is_warning ? ErrorLevel::WARNING : ErrorLevel::ERROR, location, message));
 }
 
 void ErrorReporter::reportError(const SourceLocation& location, const std::string& message, const std::string& token_lexeme, const bool is_warning) {
-    diagnostics.emplace_back(is_warning ? ErrorLevel::WARNING : ErrorLevel::ERROR, location, message, token_lexeme);
-
-    if (!is_warning) has_errors = true;
+    stage(DiagnosticMessage(is_warning ? ErrorLevel::WARNING : ErrorLevel::ERROR, location, message, token_lexeme));
 }
 
 void ErrorReporter::reportWarning(const SourceLocation& location, const std::string& message) {
-    diagnostics.emplace_back(ErrorLevel::WARNING, location, message);
+    stage(DiagnosticMessage(ErrorLevel::WARNING, location, message));
 }
 
 void ErrorReporter::reportInfo(const SourceLocation& location, const std::string& message) {
-    diagnostics.emplace_back(ErrorLevel::INFO, location, message);
+    stage(DiagnosticMessage(ErrorLevel::INFO, location, message));
+}
+
+void ErrorReporter::stage(DiagnosticMessage&& diagnostic) {
+    if (diagnostic.level == ErrorLevel::ERROR || diagnostic.level == ErrorLevel::FATAL) {
+        error_count.fetch_add(1, std::memory_order_relaxed);
+    } else if (diagnostic.level == ErrorLevel::WARNING) {
+        warning_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    localBuffer().diagnostics.push_back(std::move(diagnostic));
 }
 
-size_t ErrorReporter::getErrorCount() const {
-    return std::count_if(diagnostics.begin(), diagnostics.end(),
-        [](const DiagnosticMessage& msg) { return msg.level == ErrorLevel::ERROR || msg.level == ErrorLevel::FATAL; });
+ErrorReporter::StagingBuffer& ErrorReporter::localBuffer() {
+    // Remember the last reporter this thread used, so the common case takes no lock
+    thread_local uint64_t cached_reporter = 0;
+    thread_local StagingBuffer* cached_buffer = nullptr;
+    if (cached_reporter == reporter_id) {
+        return *cached_buffer;
+    }
+
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    StagingBuffer*& buffer = buffers_by_thread[std::this_thread::get_id()];
+    if (!buffer) {
+        staging_buffers.push_back(std::make_unique<StagingBuffer>());
+        buffer = staging_buffers.back().get();
+    }
+
+    cached_reporter = reporter_id;
+    cached_buffer = buffer;
+    return *buffer;
 }
 
-size_t ErrorReporter::getWarningCount() const {
-    return std::count_if(diagnostics.begin(), diagnostics.end(),
-        [](const DiagnosticMessage& msg) { return msg.level == ErrorLevel::WARNING; });
+void ErrorReporter::registerFile(const std::string& filename) {
+    file_ids.try_emplace(filename, file_ids.size());
 }
 
-void ErrorReporter::printDiagnostics() const {
+bool ErrorReporter::sortsBefore(const DiagnosticMessage& a, const DiagnosticMessage& b) const {
+    // Registered files in load order, then other files by name, then diagnostics without a file
+    auto file_rank = [this](const SourceLocation& location) {
+        if (location.filename.empty()) {
+            return std::make_pair(size_t(2), size_t(0));
+        }
+        auto it = file_ids.find(location.filename);
+        return it != file_ids.end() ? std::make_pair(size_t(0), it->second) : std::make_pair(size_t(1), size_t(0));
+    };
+
+    auto rank_a = file_rank(a.location);
+    auto rank_b = file_rank(b.location);
+    if (rank_a != rank_b) {
+        return rank_a < rank_b;
+    }
+    if (rank_a.first == 1 && a.location.filename != b.location.filename) {
+        return a.location.filename < b.location.filename;
+    }
+    return a.location.offset < b.location.offset;
+}
+
+void ErrorReporter::flush() {
+    std::vector<DiagnosticMessage> staged;
+    {
+        std::lock_guard<std::mutex> lock(buffers_mutex);
+        for (auto& buffer : staging_buffers) {
+            std::move(buffer->diagnostics.begin(), buffer->diagnostics.end(), std::back_inserter(staged));
+            buffer->diagnostics.clear();
+        }
+    }
+
+    // Stable, so diagnostics at the same position keep the order their checker reported them in
+    std::stable_sort(staged.begin(), staged.end(),
+        [this](const DiagnosticMessage& a, const DiagnosticMessage& b) { return sortsBefore(a, b); });
+
+    for (auto& diagnostic : staged) {
+        bool is_error = diagnostic.level == ErrorLevel::ERROR || diagnostic.level == ErrorLevel::FATAL;
+        if (max_errors != 0 && flushed_errors >= max_errors) {
+            if (is_error) {
+                suppressed_errors++;
+            }
+            continue;
+        }
+
+        if (is_error) {
+            flushed_errors++;
+        }
+        diagnostics.push_back(std::move(diagnostic));
+    }
+}
+
+const std::vector<DiagnosticMessage>& ErrorReporter::getDiagnostics() {
+    flush();
+    return diagnostics;
+}
+
+void ErrorReporter::printDiagnostics() {
+    flush();
+
+    // Each source file is read once, however many diagnostics point into it
+    std::unordered_map<std::string, std::vector<std::string>> source_lines;
+    auto lines_of = [&source_lines](const std::string& filename) -> const std::vector<std::string>& {
+        auto [it, inserted] = source_lines.try_emplace(filename);
+        if (inserted) {
+            std::ifstream file(filename);
+            std::string line;
+            while (std::getline(file, line)) {
+                it->second.push_back(line);
+            }
+        }
+        return it->second;
+    };
+
     for (const auto& diagnostic : diagnostics) {
         std::string level_str;
         std::string level_color;
@@ -128,49 +228,45 @@ void ErrorReporter::printDiagnostics() const {
             std::cerr << colorize("  --> ", "blue") << diagnostic.location.filename 
                       << ":" << diagnostic.location.line << ":" << diagnostic.location.column << std::endl;
             
-            // Try to show source context if we can read the file
-            std::ifstream file(diagnostic.location.filename);
-            if (file.is_open()) {
-                std::string line;
-                size_t current_line = 1;
+            // Show source context if we could read the file
+            const auto& lines = lines_of(diagnostic.location.filename);
+            if (diagnostic.location.line >= 1 && diagnostic.location.line <= lines.size()) {
+                const std::string& line = lines[diagnostic.location.line - 1];
+
+                // Calculate consistent spacing for line numbers
+                std::string line_num_str = std::to_string(diagnostic.location.line);
+                size_t max_line_width = std::max(line_num_str.length(), size_t(3)); // minimum 3 chars
+                std::string padding(max_line_width - line_num_str.length(), ' ');
+                
+                // Show the line with error with consistent alignment
+                std::cerr << colorize(std::string(max_line_width, ' ') + " |", "blue") << std::endl;
+                std::cerr << colorize(padding + line_num_str + " |", "blue") << " " << line << std::endl;
+                
+                // Show pointer to error location with consistent margin
+                std::string pointer_line = colorize(std::string(max_line_width, ' ') + " |", "blue") + " ";
+                for (size_t i = 1; i < diagnostic.location.column; ++i) {
+                    pointer_line += " ";
+                }
                 
-                // Read to the error line
-                while (std::getline(file, line) && current_line <= diagnostic.location.line) {
-                    if (current_line == diagnostic.location.line) {
-                        // Calculate consistent spacing for line numbers
-                        std::string line_num_str = std::to_string(current_line);
-                        size_t max_line_width = std::max(line_num_str.length(), size_t(3)); // minimum 3 chars
-                        std::string padding(max_line_width - line_num_str.length(), ' ');
-                        
-                        // Show the line with error with consistent alignment
-                        std::cerr << colorize(std::string(max_line_width, ' ') + " |", "blue") << std::endl;
-                        std::cerr << colorize(padding + line_num_str + " |", "blue") << " " << line << std::endl;
-                        
-                        // Show pointer to error location with consistent margin
-                        std::string pointer_line = colorize(std::string(max_line_width, ' ') + " |", "blue") + " ";
-                        for (size_t i = 1; i < diagnostic.location.column; ++i) {
-                            pointer_line += " ";
-                        }
-                        
-                        // Use location length for multi-character underlining
-                        if (diagnostic.location.length > 1) {
-                            pointer_line += colorize("^", "red");
-                            for (size_t i = 1; i < diagnostic.location.length; ++i) {
-                                pointer_line += colorize("~", "red");
-                            }
-                        } else {
-                            pointer_line += colorize("^", "red");
-                        }
-                        std::cerr << pointer_line << std::endl;
-                        break;
+                // Use location length for multi-character underlining
+                if (diagnostic.location.length > 1) {
+                    pointer_line += colorize("^", "red");
+                    for (size_t i = 1; i < diagnostic.location.length; ++i) {
+                        pointer_line += colorize("~", "red");
                     }
-                    current_line++;
+                } else {
+                    pointer_line += colorize("^", "red");
                 }
+                std::cerr << pointer_line << std::endl;
             }
         }
         
         std::cerr << std::endl; // Add spacing between diagnostics
     }
+
+    if (suppressed_errors > 0) {
+        std::cerr << colorize("error", "red") << ": too many errors emitted, stopping now" << std::endl << std::endl;
+    }
 }
 
 void ErrorReporter::printDiagnosticWithContext(const DiagnosticMessage& diagnostic, const std::string& source_content) const {
@@ -241,8 +337,12 @@ void ErrorReporter::printDiagnosticWithContext(const DiagnosticMessage& diagnost
 }
 
 void ErrorReporter::clear() {
+    flush();
     diagnostics.clear();
-    has_errors = false;
+    error_count.store(0, std::memory_order_relaxed);
+    warning_count.store(0, std::memory_order_relaxed);
+    flushed_errors = 0;
+    suppressed_errors = 0;
 }
 
 } // namespace pangea
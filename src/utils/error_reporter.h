@@ -1,7 +1,13 @@
 #pragma once
 
 #include "source_location.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace pangea {
@@ -33,33 +39,83 @@ enum class ColorMode {
     ALWAYS
 };
 
+// Collects diagnostics from any number of threads.
+// Each thread appends to its own staging buffer without taking a lock; flush()
+// merges the buffers ordered by file and offset, so the printed diagnostics do
+// not depend on which thread reported what. flush() must not run while other
+// threads are still reporting. Source lines are only read when printing.
 class ErrorReporter {
 private:
-    std::vector<DiagnosticMessage> diagnostics;
-    bool has_errors = false;
+    struct StagingBuffer {
+        std::vector<DiagnosticMessage> diagnostics;
+    };
+
+    std::vector<DiagnosticMessage> diagnostics; // Flushed diagnostics, in report order
+    const uint64_t reporter_id;                 // Never reused, keys the per-thread buffer cache
+
+    // Registration of staging buffers is the only locked step of reporting
+    std::mutex buffers_mutex;
+    std::vector<std::unique_ptr<StagingBuffer>> staging_buffers;
+    std::unordered_map<std::thread::id, StagingBuffer*> buffers_by_thread;
+
+    // Files in the order the compiler loaded them; the index is the file ID used for ordering
+    std::unordered_map<std::string, size_t> file_ids;
+
+    std::atomic<size_t> error_count{0};
+    std::atomic<size_t> warning_count{0};
+    size_t max_errors = 0;        // 0 means no limit
+    size_t flushed_errors = 0;    // Errors kept in diagnostics
+    size_t suppressed_errors = 0; // Errors dropped by the limit
     ColorMode color_mode = ColorMode::AUTO;
     
+    StagingBuffer& localBuffer();
+    void stage(DiagnosticMessage&& diagnostic);
+    bool sortsBefore(const DiagnosticMessage& a, const DiagnosticMessage& b) const;
+
     bool shouldUseColors() const;
     std::string colorize(const std::string& text, const std::string& color) const;
 
 public:
-    ErrorReporter() = default;
+    ErrorReporter();
     explicit ErrorReporter(const std::string& color_mode_str);
+    ErrorReporter(const ErrorReporter&) = delete;
+    ErrorReporter& operator=(const ErrorReporter&) = delete;
     
     void reportError(const SourceLocation& location, const std::string& message, const bool is_warning = false);
     void reportError(const SourceLocation& location, const std::string& message, const std::string& token_lexeme, const bool is_warning = false);
     void reportWarning(const SourceLocation& location, const std::string& message);
     void reportInfo(const SourceLocation& location, const std::string& message);
     
-    bool hasErrors() const { return has_errors; }
-    size_t getErrorCount() const;
-    size_t getWarningCount() const;
+    /**
+     * Limit the number of errors kept; once reached, shouldStop() asks phases to stop early
+     * @param limit Maximum number of errors, 0 for no limit
+     */
+    void setMaxErrors(size_t limit) { max_errors = limit; }
+    bool shouldStop() const { return max_errors != 0 && getErrorCount() >= max_errors; }
+
+    /**
+     * Give a source file its position in the diagnostic order.
+     * Files never registered sort after registered ones, by name.
+     * @param filename File name as it appears in SourceLocations
+     */
+    void registerFile(const std::string& filename);
+
+    /**
+     * Move every staged diagnostic into the flushed list, ordered by file and offset.
+     * Callers must make sure no other thread is reporting at the same time.
+     */
+    void flush();
+    
+    bool hasErrors() const { return getErrorCount() > 0; }
+    size_t getErrorCount() const { return error_count.load(std::memory_order_relaxed); }
+    size_t getWarningCount() const { return warning_count.load(std::memory_order_relaxed); }
     
-    void printDiagnostics() const;
+    void printDiagnostics();
     void printDiagnosticWithContext(const DiagnosticMessage& diagnostic, const std::string& source_content) const;
     void clear();
     
-    const std::vector<DiagnosticMessage>& getDiagnostics() const { return diagnostics; }
+    // Flushes first
+    const std::vector<DiagnosticMessage>& getDiagnostics();
 };
 
 } // namespace pangea
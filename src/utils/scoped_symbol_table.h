@@ -0,0 +1,114 @@
+#pragma once
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace pangea {
+
+// Lexically scoped name -> value table.
+// All bindings live on one stack; a single map points each name at its innermost
+// binding, and every binding remembers the one it shadows. Lookup is one hash,
+// entering a scope pushes a mark, and leaving it unwinds the bindings above the
+// mark without touching the map's buckets.
+template <typename T>
+class ScopedSymbolTable {
+public:
+    /**
+     * Bind a name in the innermost scope. Rebinding a name already defined in
+     * that scope replaces its value; otherwise the new binding shadows any outer one.
+     * @param name The identifier to bind
+     * @param value The value to store
+     * @return The stored value, valid until its scope is exited
+     */
+    T* define(const std::string& name, T value) {
+        auto [it, inserted] = innermost.try_emplace(name, nullptr);
+        Binding*& slot = it->second;
+
+        if (slot && slot->depth == depth()) {
+            slot->value = std::move(value);
+            return &slot->value;
+        }
+
+        bindings.push_back(Binding{&it->first, std::move(value), depth(), &slot, slot});
+        slot = &bindings.back();
+        return &slot->value;
+    }
+
+    /**
+     * Find the innermost visible binding of a name
+     * @param name The identifier to resolve
+     * @return The bound value, or nullptr if the name is not in scope
+     */
+    T* lookup(const std::string& name) {
+        auto it = innermost.find(name);
+        return it != innermost.end() && it->second ? &it->second->value : nullptr;
+    }
+
+    const T* lookup(const std::string& name) const {
+        return const_cast<ScopedSymbolTable*>(this)->lookup(name);
+    }
+
+    bool isDefinedInCurrentScope(const std::string& name) const {
+        auto it = innermost.find(name);
+        return it != innermost.end() && it->second && it->second->depth == depth();
+    }
+
+    void enterScope() {
+        scope_marks.push_back(bindings.size());
+    }
+
+    // Pops the innermost scope; the outermost scope is never popped
+    void exitScope() {
+        if (scope_marks.empty()) {
+            return;
+        }
+
+        size_t mark = scope_marks.back();
+        scope_marks.pop_back();
+        while (bindings.size() > mark) {
+            Binding& binding = bindings.back();
+            *binding.slot = binding.shadowed;
+            bindings.pop_back();
+        }
+    }
+
+    // Number of scopes entered above the outermost one
+    size_t depth() const { return scope_marks.size(); }
+
+    // Bindings of the outermost scope, in definition order
+    template <typename Fn>
+    void forEachOutermost(Fn&& fn) const {
+        size_t end = scope_marks.empty() ? bindings.size() : scope_marks.front();
+        for (size_t i = 0; i < end; ++i) {
+            fn(*bindings[i].name, bindings[i].value);
+        }
+    }
+
+    size_t outermostSize() const {
+        return scope_marks.empty() ? bindings.size() : scope_marks.front();
+    }
+
+    void clear() {
+        bindings.clear();
+        innermost.clear();
+        scope_marks.clear();
+    }
+
+private:
+    struct Binding {
+        const std::string* name; // key in innermost, stable for the map's lifetime
+        T value;
+        size_t depth;
+        Binding** slot;          // this name's entry in innermost
+        Binding* shadowed;       // binding to restore when this one goes out of scope
+    };
+
+    // deque keeps element addresses stable as bindings are pushed and popped
+    std::deque<Binding> bindings;
+    std::unordered_map<std::string, Binding*> innermost;
+    std::vector<size_t> scope_marks;
+};
+
+} // namespace pangea
@@ -0,0 +1,66 @@
+#include "stats.h"
+#include <iomanip>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <psapi.h>
+    #undef ERROR
+#else
+    #include <sys/resource.h>
+#endif
+
+namespace pangea {
+
+namespace allocation_stats {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> bytes{0};
+    bool hook_installed = false;
+}
+
+uint64_t& CompilerStats::counter(const std::string& name) {
+    for (auto& [counter_name, value] : counters) {
+        if (counter_name == name) {
+            return value;
+        }
+    }
+    counters.emplace_back(name, 0);
+    return counters.back().second;
+}
+
+void CompilerStats::printReport(std::ostream& out) const {
+    out << "===== Pangea statistics =====" << std::endl;
+
+    std::string current_group;
+    for (const auto& [name, value] : counters) {
+        std::string group = name.substr(0, name.find('.'));
+        if (group != current_group) {
+            out << group << ":" << std::endl;
+            current_group = group;
+        }
+
+        std::string label = name.find('.') == std::string::npos ? name : name.substr(name.find('.') + 1);
+        out << "  " << std::left << std::setw(36) << label << std::right << std::setw(12) << value << std::endl;
+    }
+}
+
+uint64_t getPeakMemoryUsage() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    return static_cast<uint64_t>(usage.ru_maxrss);        // bytes
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024; // kilobytes
+#endif
+#endif
+}
+
+} // namespace pangea
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace pangea {
+
+/**
+ * Named counters collected for --stats.
+ * Each compiler component adds its own numbers; they are printed in the
+ * order they were first recorded, grouped by the prefix before the '.'.
+ */
+class CompilerStats {
+private:
+    std::vector<std::pair<std::string, uint64_t>> counters;
+
+    uint64_t& counter(const std::string& name);
+
+public:
+    void set(const std::string& name, uint64_t value) { counter(name) = value; }
+    void add(const std::string& name, uint64_t value = 1) { counter(name) += value; }
+
+    void printReport(std::ostream& out) const;
+};
+
+// Heap allocation counters, maintained by the operator new hook in alloc_hook.cpp.
+// The hook is only linked into the pangea executable; embedders see zeros.
+namespace allocation_stats {
+    extern std::atomic<uint64_t> count;
+    extern std::atomic<uint64_t> bytes;
+    extern bool hook_installed;
+}
+
+// Peak resident set size of the process so far, in bytes (0 if unknown)
+uint64_t getPeakMemoryUsage();
+
+} // namespace pangea
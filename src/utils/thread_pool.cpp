@@ -0,0 +1,150 @@
+#include "thread_pool.h"
+#include "timer.h"
+#include <algorithm>
+
+namespace pangea {
+
+namespace {
+// Queue owned by the current worker thread; SIZE_MAX on threads outside any pool
+thread_local size_t current_worker = SIZE_MAX;
+thread_local const ThreadPool* current_pool = nullptr;
+}
+
+ThreadPool::ThreadPool(size_t thread_count) {
+    if (thread_count == 0) {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (size_t i = 0; i < thread_count; ++i) {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (size_t i = 0; i < thread_count; ++i) {
+        workers.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    wait();
+
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex);
+        stopping = true;
+    }
+    work_available.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    // Workers keep what they spawn; other threads spread tasks round-robin
+    size_t index = current_pool == this ? current_worker
+                                        : next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+
+    unfinished.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    queued.fetch_add(1, std::memory_order_release);
+
+    // Taking the lock orders this wakeup after a worker's predicate check. A thread
+    // asleep in wait() is woken too, so it can help with the new task
+    { std::lock_guard<std::mutex> lock(wake_mutex); }
+    work_available.notify_one();
+    all_done.notify_all();
+}
+
+void ThreadPool::wait() {
+    size_t home = current_pool == this ? current_worker : 0;
+
+    while (unfinished.load(std::memory_order_acquire) > 0) {
+        if (runOneTask(home)) {
+            continue;
+        }
+
+        // Everything left is already running on a worker
+        std::unique_lock<std::mutex> lock(wake_mutex);
+        all_done.wait(lock, [this] {
+            return unfinished.load(std::memory_order_acquire) == 0 ||
+                   queued.load(std::memory_order_acquire) > 0;
+        });
+    }
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    current_worker = index;
+    current_pool = this;
+
+    // Tasks' trace scopes only record on a thread with its own profiler
+    bool tracing = beginThreadTimeTrace();
+
+    while (true) {
+        if (runOneTask(index)) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wake_mutex);
+        work_available.wait(lock, [this] {
+            return stopping || queued.load(std::memory_order_acquire) > 0;
+        });
+        if (stopping && queued.load(std::memory_order_acquire) == 0) {
+            break;
+        }
+    }
+
+    if (tracing) {
+        endThreadTimeTrace();
+    }
+}
+
+bool ThreadPool::runOneTask(size_t home) {
+    std::function<void()> task;
+    if (!popTask(home, task)) {
+        return false;
+    }
+
+    task();
+
+    if (unfinished.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lock(wake_mutex);
+        all_done.notify_all();
+    }
+    return true;
+}
+
+bool ThreadPool::popTask(size_t home, std::function<void()>& task) {
+    if (queued.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+
+    // Own queue first, newest task (its data is most likely still in cache)
+    {
+        WorkQueue& own = *queues[home];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // Then steal the oldest task from the next non-empty queue
+    for (size_t offset = 1; offset < queues.size(); ++offset) {
+        WorkQueue& victim = *queues[(home + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            steals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace pangea
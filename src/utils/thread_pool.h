@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pangea {
+
+/**
+ * Work-stealing pool for compiler phases that fan out over independent units.
+ * Every worker owns a queue: it runs its own tasks newest first and, when that
+ * queue is empty, steals the oldest task from another worker. Tasks submitted
+ * from a worker stay on that worker's queue, so nested work keeps its locality.
+ * The thread calling wait() helps run tasks instead of blocking.
+ * Workers record --time-trace events when a trace was begun before the pool
+ * was created; the pool must be destroyed before the trace is written.
+ */
+class ThreadPool {
+public:
+    /**
+     * Start the worker threads
+     * @param thread_count Number of workers; 0 uses one per hardware thread
+     */
+    explicit ThreadPool(size_t thread_count = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+
+    // Run queued tasks on the calling thread until every submitted task has finished
+    void wait();
+
+    size_t size() const { return workers.size(); }
+    uint64_t getStealCount() const { return steals.load(std::memory_order_relaxed); }
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex wake_mutex;
+    std::condition_variable work_available;
+    std::condition_variable all_done;
+
+    std::atomic<size_t> queued{0};     // Tasks sitting in some queue
+    std::atomic<size_t> unfinished{0}; // Tasks submitted but not yet completed
+    std::atomic<size_t> next_queue{0};
+    std::atomic<uint64_t> steals{0};
+    bool stopping = false;
+
+    void workerLoop(size_t index);
+    bool runOneTask(size_t home);
+    bool popTask(size_t home, std::function<void()>& task);
+};
+
+} // namespace pangea
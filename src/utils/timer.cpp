@@ -0,0 +1,200 @@
+#include "timer.h"
+#include "stats.h"
+#include <llvm/Support/raw_ostream.h>
+#include <atomic>
+#include <iomanip>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #undef ERROR
+#else
+    #include <sys/resource.h>
+#endif
+
+namespace pangea {
+
+double PhaseTimer::cpuSeconds() {
+#ifdef _WIN32
+    FILETIME creation_time, exit_time, kernel_time, user_time;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation_time, &exit_time, &kernel_time, &user_time)) {
+        return 0.0;
+    }
+    auto to_seconds = [](const FILETIME& time) {
+        ULARGE_INTEGER value;
+        value.LowPart = time.dwLowDateTime;
+        value.HighPart = time.dwHighDateTime;
+        return static_cast<double>(value.QuadPart) * 1e-7; // 100ns ticks
+    };
+    return to_seconds(kernel_time) + to_seconds(user_time);
+#else
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    auto to_seconds = [](const timeval& time) {
+        return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_usec) * 1e-6;
+    };
+    return to_seconds(usage.ru_utime) + to_seconds(usage.ru_stime);
+#endif
+}
+
+size_t PhaseTimer::getPhaseIndex(const std::string& name) {
+    for (size_t i = 0; i < phases.size(); ++i) {
+        if (phases[i].name == name) {
+            return i;
+        }
+    }
+    phases.push_back(Phase{name});
+    return phases.size() - 1;
+}
+
+void PhaseTimer::begin(const std::string& phase) {
+    active.push_back(ActivePhase{getPhaseIndex(phase), std::chrono::steady_clock::now(), cpuSeconds(),
+                                 allocation_stats::count.load(std::memory_order_relaxed),
+                                 allocation_stats::bytes.load(std::memory_order_relaxed)});
+}
+
+void PhaseTimer::end() {
+    if (active.empty()) {
+        return;
+    }
+
+    ActivePhase current = active.back();
+    active.pop_back();
+
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - current.wall_start).count();
+    double cpu = cpuSeconds() - current.cpu_start;
+    uint64_t allocations = allocation_stats::count.load(std::memory_order_relaxed) - current.allocations_start;
+    uint64_t bytes = allocation_stats::bytes.load(std::memory_order_relaxed) - current.bytes_start;
+
+    Phase& phase = phases[current.index];
+    phase.wall_seconds += wall - current.child_wall;
+    phase.cpu_seconds += cpu - current.child_cpu;
+    phase.allocations += allocations - current.child_allocations;
+    phase.allocated_bytes += bytes - current.child_bytes;
+    phase.peak_memory = getPeakMemoryUsage();
+    phase.count++;
+
+    // The enclosing phase must not be charged for this one
+    if (!active.empty()) {
+        active.back().child_wall += wall;
+        active.back().child_cpu += cpu;
+        active.back().child_allocations += allocations;
+        active.back().child_bytes += bytes;
+    }
+}
+
+void PhaseTimer::printReport(std::ostream& out) const {
+    double total_wall = 0.0;
+    double total_cpu = 0.0;
+    for (const auto& phase : phases) {
+        total_wall += phase.wall_seconds;
+        total_cpu += phase.cpu_seconds;
+    }
+
+    out << "===== Pangea time report =====" << std::endl;
+    out << std::left << std::setw(14) << "Phase"
+        << std::right << std::setw(12) << "Wall (ms)" << std::setw(8) << "%"
+        << std::setw(12) << "CPU (ms)" << std::setw(8) << "Count" << std::endl;
+
+    out << std::fixed;
+    for (const auto& phase : phases) {
+        double percent = total_wall > 0.0 ? 100.0 * phase.wall_seconds / total_wall : 0.0;
+        out << std::left << std::setw(14) << phase.name
+            << std::right << std::setw(12) << std::setprecision(3) << phase.wall_seconds * 1000.0
+            << std::setw(8) << std::setprecision(1) << percent
+            << std::setw(12) << std::setprecision(3) << phase.cpu_seconds * 1000.0
+            << std::setw(8) << phase.count << std::endl;
+    }
+
+    out << std::left << std::setw(14) << "Total"
+        << std::right << std::setw(12) << std::setprecision(3) << total_wall * 1000.0
+        << std::setw(8) << std::setprecision(1) << 100.0
+        << std::setw(12) << std::setprecision(3) << total_cpu * 1000.0 << std::endl;
+    out << std::defaultfloat;
+}
+
+void PhaseTimer::printMemoryReport(std::ostream& out) const {
+    out << "===== Pangea memory report =====" << std::endl;
+    if (!allocation_stats::hook_installed) {
+        out << "(heap allocation counting is not available in this build)" << std::endl;
+    }
+
+    out << std::left << std::setw(14) << "Phase"
+        << std::right << std::setw(14) << "Allocations" << std::setw(16) << "Allocated (KB)"
+        << std::setw(16) << "Peak RSS (KB)" << std::endl;
+
+    uint64_t total_allocations = 0;
+    uint64_t total_bytes = 0;
+    for (const auto& phase : phases) {
+        out << std::left << std::setw(14) << phase.name
+            << std::right << std::setw(14) << phase.allocations
+            << std::setw(16) << phase.allocated_bytes / 1024
+            << std::setw(16) << phase.peak_memory / 1024 << std::endl;
+        total_allocations += phase.allocations;
+        total_bytes += phase.allocated_bytes;
+    }
+
+    out << std::left << std::setw(14) << "Total"
+        << std::right << std::setw(14) << total_allocations
+        << std::setw(16) << total_bytes / 1024
+        << std::setw(16) << getPeakMemoryUsage() / 1024 << std::endl;
+}
+
+PhaseScope::PhaseScope(PhaseTimer* timer, const std::string& phase, const std::string& detail)
+    : timer(timer), trace(phase, detail) {
+    if (timer) {
+        timer->begin(phase);
+    }
+}
+
+PhaseScope::~PhaseScope() {
+    if (timer) {
+        timer->end();
+    }
+}
+
+namespace {
+// Granularity 0 keeps every event, including very short functions
+constexpr unsigned time_trace_granularity = 0;
+std::string time_trace_process;
+std::atomic<bool> time_trace_active{false};
+}
+
+void beginTimeTrace(const std::string& process_name) {
+    time_trace_process = process_name;
+    time_trace_active.store(true, std::memory_order_release);
+    llvm::timeTraceProfilerInitialize(time_trace_granularity, process_name);
+}
+
+bool beginThreadTimeTrace() {
+    if (!time_trace_active.load(std::memory_order_acquire) || llvm::timeTraceProfilerEnabled()) {
+        return false;
+    }
+    llvm::timeTraceProfilerInitialize(time_trace_granularity, time_trace_process);
+    return true;
+}
+
+void endThreadTimeTrace() {
+    llvm::timeTraceProfilerFinishThread();
+}
+
+bool endTimeTrace(const std::string& filename) {
+    if (!llvm::timeTraceProfilerEnabled()) {
+        return false;
+    }
+    time_trace_active.store(false, std::memory_order_release);
+
+    bool written = false;
+    {
+        std::error_code error_code;
+        llvm::raw_fd_ostream out(filename, error_code);
+        if (!error_code) {
+            llvm::timeTraceProfilerWrite(out);
+            written = true;
+        }
+    }
+
+    llvm::timeTraceProfilerCleanup();
+    return written;
+}
+
+} // namespace pangea
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <llvm/Support/TimeProfiler.h>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace pangea {
+
+/**
+ * Accumulates wall and CPU time per compiler phase for --time-report,
+ * plus heap allocations and peak memory per phase for --stats.
+ * Phases may nest (e.g. lex inside module load); each phase is charged
+ * only its own time, so the rows of the report add up to the total.
+ */
+class PhaseTimer {
+private:
+    struct Phase {
+        std::string name;
+        double wall_seconds = 0.0;
+        double cpu_seconds = 0.0;
+        size_t count = 0;
+        uint64_t allocations = 0;
+        uint64_t allocated_bytes = 0;
+        uint64_t peak_memory = 0; // Process peak RSS when the phase last ended
+    };
+
+    struct ActivePhase {
+        size_t index;
+        std::chrono::steady_clock::time_point wall_start;
+        double cpu_start;
+        uint64_t allocations_start;
+        uint64_t bytes_start;
+        double child_wall = 0.0;
+        double child_cpu = 0.0;
+        uint64_t child_allocations = 0;
+        uint64_t child_bytes = 0;
+    };
+
+    std::vector<Phase> phases; // In first-seen order
+    std::vector<ActivePhase> active;
+
+    size_t getPhaseIndex(const std::string& name);
+
+public:
+    void begin(const std::string& phase);
+    void end();
+
+    void printReport(std::ostream& out) const;
+    void printMemoryReport(std::ostream& out) const;
+
+    // Process CPU time (user + system) in seconds
+    static double cpuSeconds();
+};
+
+/**
+ * RAII scope for one phase. Records into the timer when one is given and
+ * always opens a matching time-trace scope (free when tracing is off).
+ */
+class PhaseScope {
+private:
+    PhaseTimer* timer;
+    llvm::TimeTraceScope trace;
+
+public:
+    PhaseScope(PhaseTimer* timer, const std::string& phase, const std::string& detail = "");
+    ~PhaseScope();
+
+    PhaseScope(const PhaseScope&) = delete;
+    PhaseScope& operator=(const PhaseScope&) = delete;
+};
+
+/**
+ * Start collecting Chrome trace events for --time-trace
+ * @param process_name Process name shown in the trace viewer
+ */
+void beginTimeTrace(const std::string& process_name);
+
+/**
+ * Collect trace events on the calling thread too, if a trace is being recorded.
+ * The profiler is per thread, so threads other than the one that called
+ * beginTimeTrace record nothing without this
+ * @return true if the thread must call endThreadTimeTrace before it exits
+ */
+bool beginThreadTimeTrace();
+
+// Hand the calling thread's events over to be written by endTimeTrace
+void endThreadTimeTrace();
+
+/**
+ * Write the collected trace events as JSON and stop collecting; threads that
+ * record events must have called endThreadTimeTrace (and finished) before this
+ * @param filename Output file (e.g. out.json)
+ * @return true if the file was written
+ */
+bool endTimeTrace(const std::string& filename);
+
+} // namespace pangea